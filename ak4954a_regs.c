@@ -0,0 +1,378 @@
+/*****************************************************************************
+* File Name: ak4954a_regs.c
+*
+* Description: This file contains a shadow cache of the AK4954A control registers.
+*              Reads are served from the cache, and the registers changed since the
+*              last flush are written in a single auto-increment I2C burst.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "ak4954a_regs.h"
+
+#ifdef CODEC_AK4954A
+
+#include <string.h>
+
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* 7-bit I2C address of the AK4954A (CAD pin low) */
+#define AK4954A_REGS_I2C_ADDR   0x12u
+/* Timeout of the blocking transfers at startup, 0 waits until completion */
+#define AK4954A_REGS_TIMEOUT_MS 0u
+/* Completion events of the asynchronous bursts */
+#define AK4954A_REGS_I2C_EVENTS (CYHAL_I2C_MASTER_WR_CMPLT_EVENT | CYHAL_I2C_MASTER_ERR_EVENT)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t regs_prepare_burst(void);
+static void regs_i2c_callback(void *callback_arg, cyhal_i2c_event_t event);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_i2c_t *regs_i2c;
+/* Values of the registers as written to the codec, once flushed */
+static uint8_t regs_shadow[AK4954A_REGS_COUNT];
+/* One bit per register changed since the last flush */
+static uint32_t regs_dirty;
+static ak4954a_regs_stats_t regs_stats;
+
+/* Burst being written: register address followed by the values */
+static uint8_t regs_burst[AK4954A_REGS_COUNT + 1u];
+static uint32_t regs_burst_length;
+/* Registers of the burst, marked again if it fails */
+static uint32_t regs_burst_mask;
+/* Set while an asynchronous burst is in progress */
+static volatile bool regs_busy;
+static ak4954a_regs_done_t regs_done;
+
+/*******************************************************************************
+* Function Name: ak4954a_regs_init
+********************************************************************************
+* Summary:
+*  Load the cache from the codec with a single burst read. Call it once the
+*  codec driver has configured the codec; from then on, the registers must
+*  only be changed through the cache.
+*
+* Parameters:
+*  i2c: I2C master the codec is connected to
+*
+* Return:
+*  cy_rslt_t: result of the I2C transfers
+*
+*******************************************************************************/
+cy_rslt_t ak4954a_regs_init(cyhal_i2c_t *i2c)
+{
+    uint8_t first = 0u;
+    cy_rslt_t result;
+
+    regs_i2c   = i2c;
+    regs_dirty = 0u;
+    regs_busy  = false;
+    memset(&regs_stats, 0, sizeof(regs_stats));
+
+    result = cyhal_i2c_master_write(regs_i2c, AK4954A_REGS_I2C_ADDR, &first, 1u,
+                                    AK4954A_REGS_TIMEOUT_MS, false);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_i2c_master_read(regs_i2c, AK4954A_REGS_I2C_ADDR, regs_shadow,
+                                       AK4954A_REGS_COUNT, AK4954A_REGS_TIMEOUT_MS, true);
+    }
+
+    /* Report the end of the asynchronous bursts */
+    cyhal_i2c_register_callback(regs_i2c, regs_i2c_callback, NULL);
+    cyhal_i2c_enable_event(regs_i2c, (cyhal_i2c_event_t) AK4954A_REGS_I2C_EVENTS,
+                           CYHAL_ISR_PRIORITY_DEFAULT, true);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: ak4954a_regs_read
+********************************************************************************
+* Summary:
+*  Get the value of a register from the cache, unflushed changes included.
+*
+* Parameters:
+*  reg: register address
+*
+* Return:
+*  uint8_t: register value, 0 for a register outside the cache
+*
+*******************************************************************************/
+uint8_t ak4954a_regs_read(uint8_t reg)
+{
+    return (reg < AK4954A_REGS_COUNT) ? regs_shadow[reg] : 0u;
+}
+
+/*******************************************************************************
+* Function Name: ak4954a_regs_update
+********************************************************************************
+* Summary:
+*  Update bits of a register in the cache. The register is only marked to be
+*  written if its value changes. The read-only registers are not updated.
+*
+* Parameters:
+*  reg: register address
+*  mask: bits to update
+*  value: new value of the bits
+*
+*******************************************************************************/
+void ak4954a_regs_update(uint8_t reg, uint8_t mask, uint8_t value)
+{
+    uint32_t interrupt_state;
+    uint8_t updated;
+
+    if ((reg >= AK4954A_REGS_COUNT) || ((AK4954A_REGS_READ_ONLY & (1uL << reg)) != 0u))
+    {
+        return;
+    }
+
+    interrupt_state = cyhal_system_critical_section_enter();
+
+    regs_stats.updates++;
+
+    updated = (uint8_t) ((regs_shadow[reg] & (uint8_t) ~mask) | (value & mask));
+    if (updated == regs_shadow[reg])
+    {
+        regs_stats.skipped++;
+    }
+    else
+    {
+        regs_shadow[reg] = updated;
+        regs_dirty |= (1uL << reg);
+        trace_log(TRACE_CODEC_I2C, reg, ((uint32_t) mask << 8) | value);
+    }
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: ak4954a_regs_is_dirty
+********************************************************************************
+* Summary:
+*  Check if registers changed since the last flush.
+*
+* Return:
+*  bool: true if a flush would write to the codec
+*
+*******************************************************************************/
+bool ak4954a_regs_is_dirty(void)
+{
+    return (regs_dirty != 0u);
+}
+
+/*******************************************************************************
+* Function Name: ak4954a_regs_is_busy
+********************************************************************************
+* Summary:
+*  Check if an asynchronous burst is in progress.
+*
+* Return:
+*  bool: true until the burst completes
+*
+*******************************************************************************/
+bool ak4954a_regs_is_busy(void)
+{
+    return regs_busy;
+}
+
+/*******************************************************************************
+* Function Name: ak4954a_regs_flush_async
+********************************************************************************
+* Summary:
+*  Start writing the changed registers to the codec. The registers can be
+*  updated again during the burst; they are written by the next flush. A
+*  burst does not cross a read-only register: the changed registers past it
+*  stay marked, and are written by the next flush.
+*
+* Parameters:
+*  done: called from the I2C ISR at the end of the burst
+*
+* Return:
+*  bool: true if the burst was started and done will be called; false if
+*  nothing has changed, a burst is already in progress, or the transfer
+*  could not be started (the registers then stay marked)
+*
+*******************************************************************************/
+bool ak4954a_regs_flush_async(ak4954a_regs_done_t done)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    bool claimed = !regs_busy;
+    uint32_t length;
+
+    regs_busy = true;
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    if (!claimed)
+    {
+        return false;
+    }
+
+    regs_burst_mask = regs_prepare_burst();
+    if (regs_burst_mask == 0u)
+    {
+        regs_busy = false;
+        return false;
+    }
+
+    length    = regs_burst_length;
+    regs_done = done;
+    if (cyhal_i2c_master_transfer_async(regs_i2c, AK4954A_REGS_I2C_ADDR, regs_burst, length,
+                                        NULL, 0u) != CY_RSLT_SUCCESS)
+    {
+        regs_dirty |= regs_burst_mask;
+        regs_busy = false;
+        return false;
+    }
+
+    /* Only the transfers on the bus are counted. The burst can already be
+    *  complete, and the buffer reused by another flush */
+    interrupt_state = cyhal_system_critical_section_enter();
+    regs_stats.transactions++;
+    regs_stats.bytes += length;
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ak4954a_regs_get_stats
+********************************************************************************
+* Summary:
+*  Get the I2C traffic of the cache. Without the cache, each update is a
+*  register read and a register write on the bus.
+*
+* Parameters:
+*  stats: filled with the statistics
+*
+*******************************************************************************/
+void ak4954a_regs_get_stats(ak4954a_regs_stats_t *stats)
+{
+    *stats = regs_stats;
+}
+
+/*******************************************************************************
+* Function Name: regs_prepare_burst
+********************************************************************************
+* Summary:
+*  Copy the span from the first changed register to the last one before the
+*  next read-only register to the burst buffer, and clear their marks.
+*
+*  The unchanged registers inside the span are rewritten with their value.
+*  This is safe because the cache holds what the codec holds: it is loaded
+*  from the codec, every later write goes through it, and the AK4954A does
+*  not change its writable registers by itself. The writable registers of
+*  the cache are plain settings, so writing a register with its current
+*  value has no effect.
+*
+* Return:
+*  uint32_t: registers of the burst, 0 if nothing has changed
+*
+*******************************************************************************/
+static uint32_t regs_prepare_burst(void)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    uint32_t mask = regs_dirty;
+    uint32_t read_only;
+    uint32_t first;
+    uint32_t last;
+    uint32_t length;
+
+    if (mask != 0u)
+    {
+        /* The lowest set bit is isolated to find the first register */
+        first = 31u - __CLZ(mask & (0u - mask));
+
+        /* The span ends before the first read-only register above it */
+        read_only = AK4954A_REGS_READ_ONLY & ~((2uL << first) - 1u);
+        if (read_only != 0u)
+        {
+            mask &= (read_only & (0u - read_only)) - 1u;
+        }
+
+        last   = 31u - __CLZ(mask);
+        length = (last - first) + 1u;
+
+        regs_burst[0] = (uint8_t) first;
+        memcpy(&regs_burst[1], &regs_shadow[first], length);
+        regs_burst_length = length + 1u;
+        regs_dirty &= ~mask;
+    }
+
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    return mask;
+}
+
+/*******************************************************************************
+* Function Name: regs_i2c_callback
+********************************************************************************
+* Summary:
+*  I2C event handler. Ends the asynchronous burst; on error, its registers
+*  are marked to be written again.
+*
+* Parameters:
+*  callback_arg: not used
+*  event: event that occurred
+*
+*******************************************************************************/
+static void regs_i2c_callback(void *callback_arg, cyhal_i2c_event_t event)
+{
+    ak4954a_regs_done_t done = regs_done;
+    bool success = ((event & CYHAL_I2C_MASTER_ERR_EVENT) == 0u);
+
+    (void) callback_arg;
+
+    if (!success)
+    {
+        regs_dirty |= regs_burst_mask;
+    }
+
+    regs_done = NULL;
+    regs_busy = false;
+
+    if (done != NULL)
+    {
+        done(success);
+    }
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,77 @@
+/*****************************************************************************
+* File Name: ak4954a_regs.h
+*
+* Description: This file contains the definitions of the AK4954A register shadow
+*              cache.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AK4954A_REGS_H
+    #define AK4954A_REGS_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "cyhal.h"
+
+    /* Registers held in the cache, from Power Management 1 (00H) to the Rch
+    *  digital volume (14H) */
+    #define AK4954A_REGS_COUNT      0x15u
+    /* Read-only registers of the cache, one bit per register: ALC Volume
+    *  (0FH), the gain the ALC applies. They are never written, and their
+    *  cached value is the one read at initialization. */
+    #define AK4954A_REGS_READ_ONLY  (1uL << 0x0Fu)
+
+    /* Called from the I2C ISR at the end of an asynchronous flush */
+    typedef void (*ak4954a_regs_done_t)(bool success);
+
+    typedef struct
+    {
+        uint32_t updates;           /* Register updates requested */
+        uint32_t skipped;           /* Updates that did not change the value */
+        uint32_t transactions;      /* I2C write transactions */
+        uint32_t bytes;             /* Bytes written, register addresses included */
+    } ak4954a_regs_stats_t;
+
+    cy_rslt_t ak4954a_regs_init(cyhal_i2c_t *i2c);
+    uint8_t ak4954a_regs_read(uint8_t reg);
+    void ak4954a_regs_update(uint8_t reg, uint8_t mask, uint8_t value);
+    bool ak4954a_regs_is_dirty(void);
+    bool ak4954a_regs_is_busy(void);
+    bool ak4954a_regs_flush_async(ak4954a_regs_done_t done);
+    void ak4954a_regs_get_stats(ak4954a_regs_stats_t *stats);
+
+#endif
+
+/* [] END OF FILE */
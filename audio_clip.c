@@ -0,0 +1,95 @@
+/*****************************************************************************
+* File Name: audio_clip.c
+*
+* Description: This file contains the PCM clip voice.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "audio_clip.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t audio_clip_render(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+
+/*******************************************************************************
+* Function Name: audio_clip_voice_init
+********************************************************************************
+* Summary:
+*  Prepare a voice to play a clip from the beginning. The voice gain starts at
+*  the loudness normalization gain of the clip, so it is applied by the mixer
+*  gain stage along with any gain change made by the caller.
+*
+* Parameters:
+*  obj: clip voice object
+*  clip: clip to play
+*
+*******************************************************************************/
+void audio_clip_voice_init(audio_clip_voice_t *obj, const audio_clip_t *clip)
+{
+    obj->voice.render = audio_clip_render;
+    obj->voice.gain   = clip->gain;
+    obj->voice.pan    = AUDIO_PAN_CENTER;
+    obj->clip         = clip;
+    obj->position     = 0;
+}
+
+/*******************************************************************************
+* Function Name: audio_clip_render
+********************************************************************************
+* Summary:
+*  Render callback of the clip voice. Converts the 16-bit samples of the first
+*  channel to mix scale.
+*
+*******************************************************************************/
+static uint32_t audio_clip_render(audio_voice_t *voice, int32_t *dst, uint32_t frames)
+{
+    audio_clip_voice_t *obj = (audio_clip_voice_t *) voice;
+    const audio_clip_t *clip = obj->clip;
+    uint32_t remaining = clip->frames - obj->position;
+    uint32_t count = (frames < remaining) ? frames : remaining;
+    const int16_t *src = &clip->data[obj->position * clip->channels];
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        dst[n] = AUDIO_MIX_FROM_PCM16(*src);
+        src += clip->channels;
+    }
+
+    obj->position += count;
+
+    return count;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,71 @@
+/*****************************************************************************
+* File Name: audio_clip.h
+*
+* Description: This file contains the definitions of the PCM clip voice, which
+*              plays a sound track stored in flash memory.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_CLIP_H
+    #define AUDIO_CLIP_H
+
+    #include <stdint.h>
+
+    #include "audio_mixer.h"
+
+    /* 16-bit PCM sound track. Only the first channel of each frame is
+    *  played; the mixer positions it with the voice pan. The header is
+    *  generated by tools/wav2c.py. */
+    typedef struct
+    {
+        const int16_t *data;    /* Interleaved PCM samples */
+        uint32_t frames;        /* Number of frames */
+        uint8_t channels;       /* Samples stored per frame */
+        uint16_t gain;          /* Q14 loudness normalization gain */
+        uint32_t sample_rate_hz; /* Native sample rate */
+    } audio_clip_t;
+
+    /* Voice that plays an audio_clip_t */
+    typedef struct
+    {
+        audio_voice_t voice;    /* Must be the first member */
+        const audio_clip_t *clip;
+        uint32_t position;      /* Next frame to play */
+    } audio_clip_voice_t;
+
+    void audio_clip_voice_init(audio_clip_voice_t *obj, const audio_clip_t *clip);
+
+#endif
+
+/* [] END OF FILE */
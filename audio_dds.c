@@ -0,0 +1,270 @@
+/*****************************************************************************
+* File Name: audio_dds.c
+*
+* Description: This file contains the DDS voice. A 32-bit phase accumulator
+*              indexes a 256-entry waveform table with linear interpolation.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "audio_dds.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Waveform table length, must be a power of 2 */
+#define DDS_TABLE_BITS          8u
+#define DDS_TABLE_SIZE          (1u << DDS_TABLE_BITS)
+/* Fractional phase bits used for the interpolation */
+#define DDS_FRAC_BITS           16u
+/* Envelope resolution */
+#define DDS_ENV_BITS            24u
+#define DDS_ENV_MAX             (1uL << DDS_ENV_BITS)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t audio_dds_render(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* One cycle of each waveform at Q15, with the first entry repeated at the end
+*  so the interpolation never wraps. Square and saw are Fourier series up to
+*  the 15th harmonic with Lanczos sigma factors. */
+static const int16_t dds_sine_table[DDS_TABLE_SIZE + 1u] = {
+     0,    804,   1608,   2410,   3212,   4011,   4808,   5602, /* 0-7 */
+  6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793, /* 8-15 */
+ 12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530, /* 16-23 */
+ 18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594, /* 24-31 */
+ 23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790, /* 32-39 */
+ 27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956, /* 40-47 */
+ 30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971, /* 48-55 */
+ 32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757, /* 56-63 */
+ 32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285, /* 64-71 */
+ 32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571, /* 72-79 */
+ 30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683, /* 80-87 */
+ 27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731, /* 88-95 */
+ 23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868, /* 96-103 */
+ 18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279, /* 104-111 */
+ 12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179, /* 112-119 */
+  6393,   5602,   4808,   4011,   3212,   2410,   1608,    804, /* 120-127 */
+     0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602, /* 128-135 */
+ -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793, /* 136-143 */
+-12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, /* 144-151 */
+-18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594, /* 152-159 */
+-23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790, /* 160-167 */
+-27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956, /* 168-175 */
+-30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971, /* 176-183 */
+-32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757, /* 184-191 */
+-32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, /* 192-199 */
+-32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571, /* 200-207 */
+-30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683, /* 208-215 */
+-27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731, /* 216-223 */
+-23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868, /* 224-231 */
+-18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279, /* 232-239 */
+-12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179, /* 240-247 */
+ -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804, /* 248-255 */
+     0}; /* 256 */
+
+static const int16_t dds_square_table[DDS_TABLE_SIZE + 1u] = {
+     0,   4703,   9282,  13621,  17617,  21189,  24278,  26852, /* 0-7 */
+ 28908,  30466,  31567,  32270,  32645,  32767,  32711,  32547, /* 8-15 */
+ 32334,  32120,  31939,  31811,  31743,  31732,  31770,  31839, /* 16-23 */
+ 31925,  32011,  32085,  32137,  32163,  32164,  32142,  32106, /* 24-31 */
+ 32062,  32017,  31980,  31953,  31940,  31940,  31952,  31973, /* 32-39 */
+ 31998,  32023,  32044,  32059,  32067,  32067,  32060,  32049, /* 40-47 */
+ 32035,  32021,  32009,  32000,  31996,  31995,  31998,  32003, /* 48-55 */
+ 32009,  32016,  32021,  32025,  32028,  32029,  32030,  32030, /* 56-63 */
+ 32030,  32030,  32030,  32029,  32028,  32025,  32021,  32016, /* 64-71 */
+ 32009,  32003,  31998,  31995,  31996,  32000,  32009,  32021, /* 72-79 */
+ 32035,  32049,  32060,  32067,  32067,  32059,  32044,  32023, /* 80-87 */
+ 31998,  31973,  31952,  31940,  31940,  31953,  31980,  32017, /* 88-95 */
+ 32062,  32106,  32142,  32164,  32163,  32137,  32085,  32011, /* 96-103 */
+ 31925,  31839,  31770,  31732,  31743,  31811,  31939,  32120, /* 104-111 */
+ 32334,  32547,  32711,  32767,  32645,  32270,  31567,  30466, /* 112-119 */
+ 28908,  26852,  24278,  21189,  17617,  13621,   9282,   4703, /* 120-127 */
+     0,  -4703,  -9282, -13621, -17617, -21189, -24278, -26852, /* 128-135 */
+-28908, -30466, -31567, -32270, -32645, -32767, -32711, -32547, /* 136-143 */
+-32334, -32120, -31939, -31811, -31743, -31732, -31770, -31839, /* 144-151 */
+-31925, -32011, -32085, -32137, -32163, -32164, -32142, -32106, /* 152-159 */
+-32062, -32017, -31980, -31953, -31940, -31940, -31952, -31973, /* 160-167 */
+-31998, -32023, -32044, -32059, -32067, -32067, -32060, -32049, /* 168-175 */
+-32035, -32021, -32009, -32000, -31996, -31995, -31998, -32003, /* 176-183 */
+-32009, -32016, -32021, -32025, -32028, -32029, -32030, -32030, /* 184-191 */
+-32030, -32030, -32030, -32029, -32028, -32025, -32021, -32016, /* 192-199 */
+-32009, -32003, -31998, -31995, -31996, -32000, -32009, -32021, /* 200-207 */
+-32035, -32049, -32060, -32067, -32067, -32059, -32044, -32023, /* 208-215 */
+-31998, -31973, -31952, -31940, -31940, -31953, -31980, -32017, /* 216-223 */
+-32062, -32106, -32142, -32164, -32163, -32137, -32085, -32011, /* 224-231 */
+-31925, -31839, -31770, -31732, -31743, -31811, -31939, -32120, /* 232-239 */
+-32334, -32547, -32711, -32767, -32645, -32270, -31567, -30466, /* 240-247 */
+-28908, -26852, -24278, -21189, -17617, -13621,  -9282,  -4703, /* 248-255 */
+     0}; /* 256 */
+
+static const int16_t dds_saw_table[DDS_TABLE_SIZE + 1u] = {
+     0,    285,    568,    849,   1127,   1402,   1673,   1943, /* 0-7 */
+  2210,   2478,   2747,   3019,   3294,   3572,   3853,   4137, /* 8-15 */
+  4422,   4707,   4991,   5272,   5550,   5824,   6095,   6364, /* 16-23 */
+  6631,   6898,   7167,   7438,   7713,   7991,   8273,   8558, /* 24-31 */
+  8844,   9130,   9415,   9697,   9975,  10249,  10519,  10786, /* 32-39 */
+ 11051,  11317,  11584,  11854,  12129,  12408,  12691,  12978, /* 40-47 */
+ 13267,  13555,  13842,  14125,  14403,  14676,  14944,  15209, /* 48-55 */
+ 15471,  15733,  15998,  16266,  16540,  16821,  17107,  17398, /* 56-63 */
+ 17691,  17984,  18275,  18560,  18839,  19110,  19374,  19633, /* 64-71 */
+ 19888,  20143,  20402,  20667,  20940,  21224,  21516,  21816, /* 72-79 */
+ 22120,  22424,  22723,  23014,  23293,  23560,  23813,  24057, /* 80-87 */
+ 24295,  24533,  24777,  25033,  25307,  25599,  25911,  26237, /* 88-95 */
+ 26572,  26908,  27233,  27538,  27816,  28061,  28275,  28463, /* 96-103 */
+ 28635,  28807,  28998,  29228,  29514,  29867,  30290,  30774, /* 104-111 */
+ 31296,  31816,  32281,  32624,  32767,  32628,  32123,  31176, /* 112-119 */
+ 29723,  27720,  25144,  22004,  18333,  14197,   9686,   4911, /* 120-127 */
+     0,  -4911,  -9686, -14197, -18333, -22004, -25144, -27720, /* 128-135 */
+-29723, -31176, -32123, -32628, -32767, -32624, -32281, -31816, /* 136-143 */
+-31296, -30774, -30290, -29867, -29514, -29228, -28998, -28807, /* 144-151 */
+-28635, -28463, -28275, -28061, -27816, -27538, -27233, -26908, /* 152-159 */
+-26572, -26237, -25911, -25599, -25307, -25033, -24777, -24533, /* 160-167 */
+-24295, -24057, -23813, -23560, -23293, -23014, -22723, -22424, /* 168-175 */
+-22120, -21816, -21516, -21224, -20940, -20667, -20402, -20143, /* 176-183 */
+-19888, -19633, -19374, -19110, -18839, -18560, -18275, -17984, /* 184-191 */
+-17691, -17398, -17107, -16821, -16540, -16266, -15998, -15733, /* 192-199 */
+-15471, -15209, -14944, -14676, -14403, -14125, -13842, -13555, /* 200-207 */
+-13267, -12978, -12691, -12408, -12129, -11854, -11584, -11317, /* 208-215 */
+-11051, -10786, -10519, -10249,  -9975,  -9697,  -9415,  -9130, /* 216-223 */
+ -8844,  -8558,  -8273,  -7991,  -7713,  -7438,  -7167,  -6898, /* 224-231 */
+ -6631,  -6364,  -6095,  -5824,  -5550,  -5272,  -4991,  -4707, /* 232-239 */
+ -4422,  -4137,  -3853,  -3572,  -3294,  -3019,  -2747,  -2478, /* 240-247 */
+ -2210,  -1943,  -1673,  -1402,  -1127,   -849,   -568,   -285, /* 248-255 */
+     0}; /* 256 */
+
+static const int16_t * const dds_tables[] = {
+    [AUDIO_DDS_SINE]   = dds_sine_table,
+    [AUDIO_DDS_SQUARE] = dds_square_table,
+    [AUDIO_DDS_SAW]    = dds_saw_table,
+};
+
+/*******************************************************************************
+* Function Name: audio_dds_voice_init
+********************************************************************************
+* Summary:
+*  Prepare a voice to play a tone.
+*
+* Parameters:
+*  obj: DDS voice object
+*  tone: tone description
+*  sample_rate_hz: output sample rate
+*
+*******************************************************************************/
+void audio_dds_voice_init(audio_dds_voice_t *obj, const audio_dds_tone_t *tone, uint32_t sample_rate_hz)
+{
+    uint32_t length  = (uint32_t) (((uint64_t) tone->duration_ms * sample_rate_hz) / 1000u);
+    uint32_t attack  = (uint32_t) (((uint64_t) tone->attack_ms * sample_rate_hz) / 1000u);
+    uint32_t release = (uint32_t) (((uint64_t) tone->release_ms * sample_rate_hz) / 1000u);
+    uint32_t start_inc = (uint32_t) (((uint64_t) tone->start_hz << 32) / sample_rate_hz);
+    uint32_t end_inc   = (uint32_t) (((uint64_t) tone->end_hz << 32) / sample_rate_hz);
+
+    if ((attack + release) > length)
+    {
+        attack  = length / 2u;
+        release = length - attack;
+    }
+
+    obj->voice.render   = audio_dds_render;
+    obj->voice.gain     = tone->gain;
+    obj->voice.pan      = AUDIO_PAN_CENTER;
+    obj->table          = dds_tables[tone->wave];
+    obj->phase          = 0;
+    obj->phase_inc      = start_inc;
+    obj->phase_inc_step = (length > 0u) ?
+                          (int32_t) (((int64_t) end_inc - (int64_t) start_inc) / (int64_t) length) : 0;
+    obj->envelope       = (attack > 0u) ? 0u : DDS_ENV_MAX;
+    obj->attack_step    = (attack > 0u) ? (DDS_ENV_MAX / attack) : 0u;
+    obj->release_step   = (release > 0u) ? (DDS_ENV_MAX / release) : 0u;
+    obj->position       = 0;
+    obj->attack_end     = attack;
+    obj->release_start  = length - release;
+    obj->length         = length;
+}
+
+/*******************************************************************************
+* Function Name: audio_dds_render
+********************************************************************************
+* Summary:
+*  Render callback of the DDS voice.
+*
+*******************************************************************************/
+static uint32_t audio_dds_render(audio_voice_t *voice, int32_t *dst, uint32_t frames)
+{
+    audio_dds_voice_t *obj = (audio_dds_voice_t *) voice;
+    const int16_t *table = obj->table;
+    uint32_t remaining = obj->length - obj->position;
+    uint32_t count = (frames < remaining) ? frames : remaining;
+    uint32_t phase = obj->phase;
+    uint32_t phase_inc = obj->phase_inc;
+    uint32_t envelope = obj->envelope;
+    uint32_t position = obj->position;
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        uint32_t index = phase >> (32u - DDS_TABLE_BITS);
+        int32_t frac = (int32_t) ((phase >> (32u - DDS_TABLE_BITS - DDS_FRAC_BITS)) & ((1uL << DDS_FRAC_BITS) - 1u));
+        int32_t a = table[index];
+        int32_t b = table[index + 1u];
+        int32_t sample = a + (((b - a) * frac) >> DDS_FRAC_BITS);
+
+        if (position < obj->attack_end)
+        {
+            envelope += obj->attack_step;
+        }
+        else if (position >= obj->release_start)
+        {
+            envelope = (envelope > obj->release_step) ? (envelope - obj->release_step) : 0u;
+        }
+
+        /* Q15 sample * Q15 envelope, scaled to the 24-bit mix */
+        dst[n] = (sample * (int32_t) (envelope >> (DDS_ENV_BITS - 15u))) >> (30u - (AUDIO_MIX_BITS - 1u));
+
+        phase     += phase_inc;
+        phase_inc += (uint32_t) obj->phase_inc_step;
+        position++;
+    }
+
+    obj->phase     = phase;
+    obj->phase_inc = phase_inc;
+    obj->envelope  = envelope;
+    obj->position  = position;
+
+    return count;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,93 @@
+/*****************************************************************************
+* File Name: audio_dds.h
+*
+* Description: This file contains the definitions of the direct digital synthesis
+*              (DDS) voice, which generates beeps and chirps from a few bytes of
+*              tone description instead of stored PCM data.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_DDS_H
+    #define AUDIO_DDS_H
+
+    #include <stdint.h>
+
+    #include "audio_mixer.h"
+
+    /* Waveforms. Square and saw are band-limited to 15 harmonics, so they
+    *  are alias-free for fundamentals up to sample_rate / 30. The sine has
+    *  a THD+N of about -90 dB, set by the linear interpolation of its 256
+    *  entries; it is meant for beeps, not for test tones. */
+    typedef enum
+    {
+        AUDIO_DDS_SINE,
+        AUDIO_DDS_SQUARE,
+        AUDIO_DDS_SAW,
+    } audio_dds_wave_t;
+
+    /* Tone description. A tone has a linear attack, a sustain and a linear
+    *  release, and sweeps linearly from start_hz to end_hz over its length. */
+    typedef struct
+    {
+        audio_dds_wave_t wave;  /* Waveform */
+        uint16_t start_hz;      /* Frequency at the start of the tone */
+        uint16_t end_hz;        /* Frequency at the end; start_hz for no sweep */
+        uint16_t duration_ms;   /* Total length, attack and release included */
+        uint16_t attack_ms;     /* Ramp up time */
+        uint16_t release_ms;    /* Ramp down time */
+        uint16_t gain;          /* Q14 peak gain */
+    } audio_dds_tone_t;
+
+    /* Voice that plays an audio_dds_tone_t */
+    typedef struct
+    {
+        audio_voice_t voice;    /* Must be the first member */
+        const int16_t *table;   /* Waveform table */
+        uint32_t phase;         /* Phase accumulator, one cycle is 2^32 */
+        uint32_t phase_inc;     /* Phase increment per sample */
+        int32_t phase_inc_step; /* Sweep slope, added to phase_inc per sample */
+        uint32_t envelope;      /* Q24 envelope level */
+        uint32_t attack_step;   /* Envelope increment per attack sample */
+        uint32_t release_step;  /* Envelope decrement per release sample */
+        uint32_t position;      /* Samples played */
+        uint32_t attack_end;    /* First sample after the attack */
+        uint32_t release_start; /* First sample of the release */
+        uint32_t length;        /* Total number of samples */
+    } audio_dds_voice_t;
+
+    void audio_dds_voice_init(audio_dds_voice_t *obj, const audio_dds_tone_t *tone, uint32_t sample_rate_hz);
+
+#endif
+
+/* [] END OF FILE */
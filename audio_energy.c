@@ -0,0 +1,258 @@
+/*****************************************************************************
+* File Name: audio_energy.c
+*
+* Description: This file accounts the CPU active cycles, the sleep time, the
+*              wake-ups and the estimated energy of each played clip.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "cyhal.h"
+
+#include "audio_energy.h"
+#include "cycle_counter.h"
+#include "power_model.h"
+#include "timebase.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* A segment is closed once it reaches half the range of the 32-bit cycle
+*  counter (about 22 s at 98 MHz), well before the counter wraps */
+#define ENERGY_SEGMENT_MAX_CYCLES   0x80000000u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void energy_close_segment(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Set while a clip is accounted */
+static bool energy_active;
+/* CPU clock of the current segment */
+static uint32_t energy_cpu_hz;
+/* Cycle counter and timebase at the start of the current segment */
+static uint32_t energy_mark_cycles;
+static uint32_t energy_mark_time;
+static uint32_t energy_start_time;
+static uint32_t energy_clips;
+/* Clip being played */
+static audio_energy_clip_t energy_clip;
+/* Last clip played */
+static audio_energy_clip_t energy_last;
+
+/*******************************************************************************
+* Function Name: audio_energy_clip_start
+********************************************************************************
+* Summary:
+*  Start the accounting of a clip.
+*
+*******************************************************************************/
+void audio_energy_clip_start(void)
+{
+    memset(&energy_clip, 0, sizeof(energy_clip));
+
+    energy_start_time  = timebase_now();
+    energy_mark_time   = energy_start_time;
+    energy_mark_cycles = cycle_counter_read();
+    energy_active      = true;
+}
+
+/*******************************************************************************
+* Function Name: audio_energy_clip_cancel
+********************************************************************************
+* Summary:
+*  Drop the accounting of a clip that could not be started.
+*
+*******************************************************************************/
+void audio_energy_clip_cancel(void)
+{
+    energy_active = false;
+}
+
+/*******************************************************************************
+* Function Name: audio_energy_clip_stop
+********************************************************************************
+* Summary:
+*  Complete the accounting of the clip. The result is kept until the next
+*  clip stops.
+*
+*******************************************************************************/
+void audio_energy_clip_stop(void)
+{
+    uint32_t interrupt_state;
+
+    if (!energy_active)
+    {
+        return;
+    }
+
+    energy_close_segment();
+    energy_active = false;
+
+    energy_clip.clip        = ++energy_clips;
+    energy_clip.duration_us = timebase_ticks_to_us(energy_mark_time - energy_start_time);
+    if (energy_clip.duration_us > 0u)
+    {
+        energy_clip.load_permille = (uint32_t) (((uint64_t) energy_clip.active_us * 1000u) / energy_clip.duration_us);
+    }
+
+    interrupt_state = cyhal_system_critical_section_enter();
+    energy_last = energy_clip;
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    trace_log(TRACE_CLIP_ENERGY, energy_clip.load_permille, (uint32_t) (energy_clip.energy_nj / 1000u));
+}
+
+/*******************************************************************************
+* Function Name: audio_energy_on_cpu_clock
+********************************************************************************
+* Summary:
+*  Called from the main loop when the CPU clock changes. The time before the
+*  change is accounted at the previous clock.
+*
+* Parameters:
+*  cpu_hz: new CPU clock
+*
+*******************************************************************************/
+void audio_energy_on_cpu_clock(uint32_t cpu_hz)
+{
+    /* The I2S ISR can stop the clip and close its last segment */
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+    if (energy_active)
+    {
+        energy_close_segment();
+    }
+    energy_cpu_hz = cpu_hz;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: audio_energy_on_block
+********************************************************************************
+* Summary:
+*  Called from the I2S ISR for each block queued. Closes the segment before
+*  its cycle count can wrap, when the CPU clock has not changed for a long
+*  time.
+*
+*******************************************************************************/
+void audio_energy_on_block(void)
+{
+    if (energy_active && ((cycle_counter_read() - energy_mark_cycles) >= ENERGY_SEGMENT_MAX_CYCLES))
+    {
+        energy_close_segment();
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_energy_on_wakeup
+********************************************************************************
+* Summary:
+*  Called when the CPU wakes up from the idle mode.
+*
+*******************************************************************************/
+void audio_energy_on_wakeup(void)
+{
+    if (energy_active)
+    {
+        energy_clip.wakeups++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_energy_get_clip
+********************************************************************************
+* Summary:
+*  Get the accounting of the last clip played.
+*
+* Parameters:
+*  clip: filled with the accounting, all zero before the first clip stops
+*
+*******************************************************************************/
+void audio_energy_get_clip(audio_energy_clip_t *clip)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+    *clip = energy_last;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: energy_close_segment
+********************************************************************************
+* Summary:
+*  Account the time since the last mark at the current CPU clock. The cycle
+*  counter stops while the CPU sleeps, so it counts the active cycles only;
+*  the rest of the elapsed time is spent in Sleep mode. Called from the main
+*  loop and the I2S ISR: the clip and the marks are updated in a critical
+*  section.
+*
+*******************************************************************************/
+static void energy_close_segment(void)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    uint32_t now_cycles = cycle_counter_read();
+    uint32_t now_time = timebase_now();
+    uint32_t cycles = now_cycles - energy_mark_cycles;
+    uint32_t elapsed_us = timebase_ticks_to_us(now_time - energy_mark_time);
+    uint32_t active_us = 0;
+    uint32_t sleep_us;
+
+    if (energy_cpu_hz > 0u)
+    {
+        active_us = (uint32_t) (((uint64_t) cycles * 1000000u) / energy_cpu_hz);
+    }
+    /* The timebase is coarser than the cycle counter */
+    sleep_us = (elapsed_us > active_us) ? (elapsed_us - active_us) : 0u;
+
+    energy_clip.active_cycles += cycles;
+    energy_clip.active_us     += active_us;
+    energy_clip.sleep_us      += sleep_us;
+    energy_clip.energy_nj     += power_model_energy_nj(active_us, sleep_us, energy_cpu_hz);
+
+    energy_mark_cycles = now_cycles;
+    energy_mark_time   = now_time;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/* [] END OF FILE */
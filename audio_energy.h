@@ -0,0 +1,68 @@
+/*****************************************************************************
+* File Name: audio_energy.h
+*
+* Description: This file contains the definitions of the per-clip energy and CPU
+*              load accounting.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_ENERGY_H
+    #define AUDIO_ENERGY_H
+
+    #include <stdint.h>
+
+    /* Energy and CPU load of one played clip */
+    typedef struct
+    {
+        uint32_t clip;              /* Clips played since reset, this one included */
+        uint32_t duration_us;       /* From the start to the last block queued */
+        uint64_t active_cycles;     /* CPU cycles spent running */
+        uint32_t active_us;         /* Time spent running */
+        uint32_t sleep_us;          /* Time spent in Sleep mode */
+        uint32_t wakeups;           /* Wake-ups from the idle mode */
+        uint32_t load_permille;     /* Active time over the duration */
+        uint64_t energy_nj;         /* Estimate from power_model.h */
+    } audio_energy_clip_t;
+
+    void audio_energy_clip_start(void);
+    void audio_energy_clip_cancel(void);
+    void audio_energy_clip_stop(void);
+    void audio_energy_on_cpu_clock(uint32_t cpu_hz);
+    void audio_energy_on_block(void);
+    void audio_energy_on_wakeup(void);
+    void audio_energy_get_clip(audio_energy_clip_t *clip);
+
+#endif
+
+/* [] END OF FILE */
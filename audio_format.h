@@ -0,0 +1,141 @@
+/*****************************************************************************
+* File Name: audio_format.h
+*
+* Description: This file contains the sample format definitions shared by the
+*              audio pipeline, including the build-time output word length.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_FORMAT_H
+    #define AUDIO_FORMAT_H
+
+    #include <stdint.h>
+
+    /* Output word length in bits (16, 24 or 32). Set it from the Makefile
+    *  with DEFINES+=AUDIO_WORD_LENGTH=<bits> */
+    #ifndef AUDIO_WORD_LENGTH
+        #define AUDIO_WORD_LENGTH   16
+    #endif
+
+    #if (AUDIO_WORD_LENGTH != 16) && (AUDIO_WORD_LENGTH != 24) && (AUDIO_WORD_LENGTH != 32)
+        #error "AUDIO_WORD_LENGTH must be 16, 24 or 32"
+    #endif
+
+    /* I2S channel length in bits (the word is left-justified in the slot) */
+    #define AUDIO_CHANNEL_LENGTH    32u
+    /* Number of interleaved channels in an output frame */
+    #define AUDIO_CHANNELS          2u
+    /* Number of frames rendered per pipeline block */
+    #define AUDIO_BLOCK_FRAMES      128u
+    /* Number of output words in a pipeline block */
+    #define AUDIO_BLOCK_WORDS       (AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS)
+
+    /* The mixer works on int32 samples scaled to 24-bit full scale, which
+    *  leaves 8 bits of headroom for summing voices before the output stage
+    *  saturates */
+    #define AUDIO_MIX_BITS          24u
+    #define AUDIO_MIX_MAX           ((int32_t) ((1L << (AUDIO_MIX_BITS - 1u)) - 1))
+    #define AUDIO_MIX_MIN           ((int32_t) (-(1L << (AUDIO_MIX_BITS - 1u))))
+    /* Shift that scales a 16-bit PCM sample to the mix scale */
+    #define AUDIO_MIX_SHIFT_PCM16   (AUDIO_MIX_BITS - 16u)
+    /* Convert a 16-bit PCM sample to mix scale */
+    #define AUDIO_MIX_FROM_PCM16(x) ((int32_t) (x) * (int32_t) (1L << AUDIO_MIX_SHIFT_PCM16))
+
+    /* Gains are unsigned Q14: 16384 is unity, 65535 is about +12 dB */
+    #define AUDIO_GAIN_FRAC_BITS    14u
+    #define AUDIO_GAIN_UNITY        (1u << AUDIO_GAIN_FRAC_BITS)
+
+    /* Word written to the I2S TX FIFO. Word lengths above 16 bits are
+    *  transferred as 32-bit FIFO entries */
+    #if (AUDIO_WORD_LENGTH == 16)
+        typedef int16_t audio_sample_t;
+    #else
+        typedef int32_t audio_sample_t;
+    #endif
+
+    /***************************************************************************
+    * Function Name: audio_format_pack
+    ****************************************************************************
+    * Summary:
+    *  Saturate a mix-scale sample and convert it to the output word length.
+    *
+    * Parameters:
+    *  mix: sample at 24-bit mix scale
+    *
+    * Return:
+    *  audio_sample_t: sample ready for the I2S TX FIFO
+    *
+    ***************************************************************************/
+    static inline audio_sample_t audio_format_pack(int32_t mix)
+    {
+        if (mix > AUDIO_MIX_MAX)
+        {
+            mix = AUDIO_MIX_MAX;
+        }
+        else if (mix < AUDIO_MIX_MIN)
+        {
+            mix = AUDIO_MIX_MIN;
+        }
+
+    #if (AUDIO_WORD_LENGTH == 16)
+        return (audio_sample_t) (mix >> (AUDIO_MIX_BITS - 16u));
+    #elif (AUDIO_WORD_LENGTH == 24)
+        return (audio_sample_t) mix;
+    #else
+        return (audio_sample_t) ((uint32_t) mix << (32u - AUDIO_MIX_BITS));
+    #endif
+    }
+
+    /***************************************************************************
+    * Function Name: audio_gain_apply
+    ****************************************************************************
+    * Summary:
+    *  Scale a mix-scale sample by a Q14 gain.
+    *
+    * Parameters:
+    *  sample: sample at 24-bit mix scale
+    *  gain: Q14 gain
+    *
+    * Return:
+    *  int32_t: scaled sample (not saturated)
+    *
+    ***************************************************************************/
+    static inline int32_t audio_gain_apply(int32_t sample, uint32_t gain)
+    {
+        return (int32_t) (((int64_t) sample * (int64_t) gain) >> AUDIO_GAIN_FRAC_BITS);
+    }
+
+#endif
+
+/* [] END OF FILE */
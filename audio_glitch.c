@@ -0,0 +1,156 @@
+/*****************************************************************************
+* File Name: audio_glitch.c
+*
+* Description: This file contains the glitch telemetry of the audio output. The
+*              pipeline reports each underrun or overrun it detects; they are
+*              counted per type and the last ones are logged with the state of
+*              the pipeline.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cyhal.h"
+
+#include "audio_glitch.h"
+#include "audio_mixer.h"
+#include "cpu_governor.h"
+#include "timebase.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static uint32_t glitch_counts[AUDIO_GLITCH_TYPE_COUNT];
+static uint32_t glitch_blocks;
+static uint32_t glitch_max_late_us;
+/* Last glitches, written circularly */
+static audio_glitch_record_t glitch_log[AUDIO_GLITCH_LOG_SIZE];
+static uint32_t glitch_total;
+
+/*******************************************************************************
+* Function Name: audio_glitch_reset
+********************************************************************************
+* Summary:
+*  Clear the counters and the log.
+*
+*******************************************************************************/
+void audio_glitch_reset(void)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+    memset(glitch_counts, 0, sizeof(glitch_counts));
+    glitch_blocks      = 0;
+    glitch_max_late_us = 0;
+    glitch_total       = 0;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: audio_glitch_on_block
+********************************************************************************
+* Summary:
+*  Count a block queued to the I2S. Called from the I2S ISR.
+*
+*******************************************************************************/
+void audio_glitch_on_block(void)
+{
+    glitch_blocks++;
+}
+
+/*******************************************************************************
+* Function Name: audio_glitch_record
+********************************************************************************
+* Summary:
+*  Count a glitch and log it with the state of the pipeline. Called from the
+*  I2S ISR.
+*
+* Parameters:
+*  type: kind of glitch
+*  block: blocks queued since the clip started
+*  late_us: refill delay past the block period, 0 if not a late refill
+*
+*******************************************************************************/
+void audio_glitch_record(audio_glitch_type_t type, uint32_t block, uint32_t late_us)
+{
+    audio_glitch_record_t *record = &glitch_log[glitch_total % AUDIO_GLITCH_LOG_SIZE];
+
+    trace_log(TRACE_GLITCH, type, block);
+
+    glitch_counts[type]++;
+    glitch_total++;
+    if (late_us > glitch_max_late_us)
+    {
+        glitch_max_late_us = late_us;
+    }
+
+    record->timestamp = timebase_now();
+    record->block     = block;
+    record->late_us   = (late_us > UINT16_MAX) ? UINT16_MAX : (uint16_t) late_us;
+    record->type      = (uint8_t) type;
+    record->voices    = (uint8_t) audio_mixer_get_voice_count();
+    record->cpu_level = (uint8_t) cpu_governor_get_level();
+}
+
+/*******************************************************************************
+* Function Name: audio_glitch_get_report
+********************************************************************************
+* Summary:
+*  Get the counters and the logged glitches.
+*
+* Parameters:
+*  report: filled with the report
+*
+*******************************************************************************/
+void audio_glitch_get_report(audio_glitch_report_t *report)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    uint32_t first;
+
+    memcpy(report->counts, glitch_counts, sizeof(glitch_counts));
+    report->blocks      = glitch_blocks;
+    report->max_late_us = glitch_max_late_us;
+    report->logged      = (glitch_total < AUDIO_GLITCH_LOG_SIZE) ? glitch_total : AUDIO_GLITCH_LOG_SIZE;
+
+    first = glitch_total - report->logged;
+    for (uint32_t i = 0; i < report->logged; i++)
+    {
+        report->log[i] = glitch_log[(first + i) % AUDIO_GLITCH_LOG_SIZE];
+    }
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,84 @@
+/*****************************************************************************
+* File Name: audio_glitch.h
+*
+* Description: This file contains the definitions of the glitch telemetry of
+*              the audio output.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_GLITCH_H
+    #define AUDIO_GLITCH_H
+
+    #include <stdint.h>
+
+    /* Number of glitches kept with their details, the most recent ones */
+    #define AUDIO_GLITCH_LOG_SIZE   8u
+
+    typedef enum
+    {
+        AUDIO_GLITCH_LATE_REFILL,   /* A block was queued after the FIFO margin */
+        AUDIO_GLITCH_TX_UNDERFLOW,  /* The I2S read an empty TX FIFO */
+        AUDIO_GLITCH_TX_OVERFLOW,   /* A word was written to a full TX FIFO */
+        AUDIO_GLITCH_TYPE_COUNT,
+    } audio_glitch_type_t;
+
+    /* Pipeline state when a glitch was detected */
+    typedef struct
+    {
+        uint32_t timestamp;         /* Timebase ticks */
+        uint32_t block;             /* Blocks queued since the clip started */
+        uint16_t late_us;           /* Refill delay past the block period */
+        uint8_t type;               /* audio_glitch_type_t */
+        uint8_t voices;             /* Voices being mixed */
+        uint8_t cpu_level;          /* CPU clock governor level */
+        uint8_t reserved[3];
+    } audio_glitch_record_t;
+
+    typedef struct
+    {
+        uint32_t counts[AUDIO_GLITCH_TYPE_COUNT];
+        uint32_t blocks;            /* Blocks queued since the reset */
+        uint32_t max_late_us;       /* Longest late refill */
+        uint32_t logged;            /* Valid entries of the log */
+        audio_glitch_record_t log[AUDIO_GLITCH_LOG_SIZE];  /* Oldest first */
+    } audio_glitch_report_t;
+
+    void audio_glitch_reset(void);
+    void audio_glitch_on_block(void);
+    void audio_glitch_record(audio_glitch_type_t type, uint32_t block, uint32_t late_us);
+    void audio_glitch_get_report(audio_glitch_report_t *report);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,350 @@
+/*****************************************************************************
+* File Name: audio_mixer.c
+*
+* Description: This file contains the audio mixer. Voices are rendered one block
+*              at a time as mono and summed into an int32 stereo mix buffer,
+*              with a constant-power pan per voice and a master balance.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "audio_mixer.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Q15 scale of the pan and balance gains */
+#define MIXER_Q15_BITS          15u
+#define MIXER_Q15_UNITY         (1uL << MIXER_Q15_BITS)
+/* Number of pan steps from hard left to hard right */
+#define MIXER_PAN_SPAN          ((uint32_t) (AUDIO_PAN_RIGHT - AUDIO_PAN_LEFT))
+/* Power curve gain of the center position, -3 dB */
+#define MIXER_CURVE_CENTER      ((uint32_t) audio_power_curve[MIXER_PAN_SPAN / 2u])
+
+#if ((AUDIO_PAN_RIGHT - AUDIO_PAN_LEFT) != AUDIO_POWER_CURVE_STEPS)
+    #error "The pan range must match the power curve"
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Constant-power pan law. The left gain of a voice at position p (0 = hard
+*  left) is audio_power_curve[p], the right gain is
+*  audio_power_curve[MIXER_PAN_SPAN - p], so L^2 + R^2 is constant. */
+const uint16_t audio_power_curve[AUDIO_POWER_CURVE_STEPS + 1u] = {
+    32768, 32766, 32758, 32746, 32729, 32706, 32679, 32647, /* 0-7 */
+    32610, 32568, 32522, 32470, 32413, 32352, 32286, 32214, /* 8-15 */
+    32138, 32058, 31972, 31881, 31786, 31686, 31581, 31471, /* 16-23 */
+    31357, 31238, 31114, 30986, 30853, 30715, 30572, 30425, /* 24-31 */
+    30274, 30118, 29957, 29792, 29622, 29448, 29269, 29086, /* 32-39 */
+    28899, 28707, 28511, 28311, 28106, 27897, 27684, 27467, /* 40-47 */
+    27246, 27020, 26791, 26557, 26320, 26078, 25833, 25583, /* 48-55 */
+    25330, 25073, 24812, 24548, 24279, 24008, 23732, 23453, /* 56-63 */
+    23170, 22884, 22595, 22302, 22006, 21706, 21403, 21097, /* 64-71 */
+    20788, 20475, 20160, 19841, 19520, 19195, 18868, 18538, /* 72-79 */
+    18205, 17869, 17531, 17190, 16846, 16500, 16151, 15800, /* 80-87 */
+    15447, 15091, 14733, 14373, 14010, 13646, 13279, 12910, /* 88-95 */
+    12540, 12167, 11793, 11417, 11039, 10660, 10279,  9896, /* 96-103 */
+     9512,  9127,  8740,  8351,  7962,  7571,  7180,  6787, /* 104-111 */
+     6393,  5998,  5602,  5205,  4808,  4410,  4011,  3612, /* 112-119 */
+     3212,  2811,  2411,  2009,  1608,  1206,   804,   402, /* 120-127 */
+        0 /* 128 */
+};
+
+/* Q15 master balance gains */
+static uint32_t balance_left  = MIXER_Q15_UNITY;
+static uint32_t balance_right = MIXER_Q15_UNITY;
+
+/* Active voices, NULL for a free slot */
+static audio_voice_t * volatile mixer_voices[AUDIO_MIXER_MAX_VOICES];
+/* Scratch buffer for the mono output of one voice */
+static int32_t voice_buffer[AUDIO_BLOCK_FRAMES];
+
+/*******************************************************************************
+* Function Name: audio_mixer_init
+********************************************************************************
+* Summary:
+*  Remove all the voices from the mixer.
+*
+*******************************************************************************/
+void audio_mixer_init(void)
+{
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        mixer_voices[i] = NULL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_mixer_add
+********************************************************************************
+* Summary:
+*  Add a voice to the mixer. The voice must be fully initialized, as it can be
+*  rendered from the I2S interrupt as soon as this function stores it.
+*
+* Parameters:
+*  voice: voice to add
+*
+* Return:
+*  bool: false if all the voice slots are in use
+*
+*******************************************************************************/
+bool audio_mixer_add(audio_voice_t *voice)
+{
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        if (mixer_voices[i] == voice)
+        {
+            return true;
+        }
+    }
+
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        if (mixer_voices[i] == NULL)
+        {
+            mixer_voices[i] = voice;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: audio_mixer_remove
+********************************************************************************
+* Summary:
+*  Remove a voice from the mixer.
+*
+* Parameters:
+*  voice: voice to remove
+*
+*******************************************************************************/
+void audio_mixer_remove(audio_voice_t *voice)
+{
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        if (mixer_voices[i] == voice)
+        {
+            mixer_voices[i] = NULL;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_mixer_replace
+********************************************************************************
+* Summary:
+*  Swap a voice for another one in the same slot, so the replacement is
+*  rendered from the next block on without a gap.
+*
+* Parameters:
+*  voice: voice currently in the mixer
+*  replacement: fully initialized voice that takes its slot
+*
+* Return:
+*  bool: false if the voice is not in the mixer (it may have just ended)
+*
+*******************************************************************************/
+bool audio_mixer_replace(audio_voice_t *voice, audio_voice_t *replacement)
+{
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        if (mixer_voices[i] == voice)
+        {
+            mixer_voices[i] = replacement;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: audio_mixer_is_idle
+********************************************************************************
+* Summary:
+*  Check if there is no voice left to render.
+*
+* Return:
+*  bool: true if no voice is active
+*
+*******************************************************************************/
+bool audio_mixer_is_idle(void)
+{
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        if (mixer_voices[i] != NULL)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_mixer_get_voice_count
+********************************************************************************
+* Summary:
+*  Get the number of voices being rendered.
+*
+* Return:
+*  uint32_t: number of active voices
+*
+*******************************************************************************/
+uint32_t audio_mixer_get_voice_count(void)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        if (mixer_voices[i] != NULL)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: audio_mixer_set_balance
+********************************************************************************
+* Summary:
+*  Set the master balance. The gains follow the constant-power curve of the
+*  pan, scaled by +3 dB so that the center is at unity: the channel opposite
+*  to the balance direction is attenuated down to silence, the other one
+*  stays at unity.
+*
+* Parameters:
+*  balance: AUDIO_PAN_LEFT to AUDIO_PAN_RIGHT
+*
+*******************************************************************************/
+void audio_mixer_set_balance(int8_t balance)
+{
+    uint32_t position;
+    uint32_t left;
+    uint32_t right;
+
+    if (balance > AUDIO_PAN_RIGHT)
+    {
+        balance = AUDIO_PAN_RIGHT;
+    }
+    else if (balance < AUDIO_PAN_LEFT)
+    {
+        balance = AUDIO_PAN_LEFT;
+    }
+
+    position = (uint32_t) (balance - AUDIO_PAN_LEFT);
+    left  = ((uint32_t) audio_power_curve[position] << MIXER_Q15_BITS) / MIXER_CURVE_CENTER;
+    right = ((uint32_t) audio_power_curve[MIXER_PAN_SPAN - position] << MIXER_Q15_BITS) / MIXER_CURVE_CENTER;
+
+    balance_left  = (left > MIXER_Q15_UNITY) ? MIXER_Q15_UNITY : left;
+    balance_right = (right > MIXER_Q15_UNITY) ? MIXER_Q15_UNITY : right;
+}
+
+/*******************************************************************************
+* Function Name: audio_mixer_render
+********************************************************************************
+* Summary:
+*  Render all the active voices and sum them into an interleaved stereo mix
+*  buffer. The voice gain, pan and master balance are folded into one gain
+*  pair per voice and block, so panning costs a second multiply per sample
+*  only for voices that are off center. Voices that finish during the block
+*  are removed from the mixer.
+*
+* Parameters:
+*  mix: destination buffer, frames * AUDIO_CHANNELS samples at mix scale
+*  frames: number of frames to render (up to AUDIO_BLOCK_FRAMES)
+*
+*******************************************************************************/
+void audio_mixer_render(int32_t *mix, uint32_t frames)
+{
+    memset(mix, 0, frames * AUDIO_CHANNELS * sizeof(int32_t));
+
+    for (uint32_t i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+    {
+        audio_voice_t *voice = mixer_voices[i];
+        if (voice == NULL)
+        {
+            continue;
+        }
+
+        uint32_t count = voice->render(voice, voice_buffer, frames);
+        int32_t pan = voice->pan;
+        if (pan > AUDIO_PAN_RIGHT)
+        {
+            pan = AUDIO_PAN_RIGHT;
+        }
+        else if (pan < AUDIO_PAN_LEFT)
+        {
+            pan = AUDIO_PAN_LEFT;
+        }
+        uint32_t position = (uint32_t) (pan - AUDIO_PAN_LEFT);
+        uint32_t gain_left  = (voice->gain * audio_power_curve[position]) >> MIXER_Q15_BITS;
+        uint32_t gain_right = (voice->gain * audio_power_curve[MIXER_PAN_SPAN - position]) >> MIXER_Q15_BITS;
+        gain_left  = (gain_left * balance_left) >> MIXER_Q15_BITS;
+        gain_right = (gain_right * balance_right) >> MIXER_Q15_BITS;
+
+        if (gain_left == gain_right)
+        {
+            /* Centered voice: one multiply for both channels */
+            for (uint32_t n = 0; n < count; n++)
+            {
+                int32_t sample = audio_gain_apply(voice_buffer[n], gain_left);
+                mix[2u * n]      += sample;
+                mix[2u * n + 1u] += sample;
+            }
+        }
+        else
+        {
+            for (uint32_t n = 0; n < count; n++)
+            {
+                mix[2u * n]      += audio_gain_apply(voice_buffer[n], gain_left);
+                mix[2u * n + 1u] += audio_gain_apply(voice_buffer[n], gain_right);
+            }
+        }
+
+        if (count < frames)
+        {
+            mixer_voices[i] = NULL;
+        }
+    }
+}
+
+/* [] END OF FILE */
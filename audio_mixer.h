@@ -0,0 +1,88 @@
+/*****************************************************************************
+* File Name: audio_mixer.h
+*
+* Description: This file contains the definitions of the audio mixer and the
+*              voice interface used by the sound sources.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_MIXER_H
+    #define AUDIO_MIXER_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "audio_format.h"
+
+    /* Maximum number of voices mixed at the same time */
+    #define AUDIO_MIXER_MAX_VOICES  4u
+
+    /* Pan and balance positions */
+    #define AUDIO_PAN_LEFT          (-64)
+    #define AUDIO_PAN_CENTER        (0)
+    #define AUDIO_PAN_RIGHT         (64)
+
+    /* Quarter cosine used for the constant-power pan law and the equal-power
+    *  crossfade: audio_power_curve[i] = cos(i * pi / 256) in Q15 */
+    #define AUDIO_POWER_CURVE_STEPS 128u
+    extern const uint16_t audio_power_curve[AUDIO_POWER_CURVE_STEPS + 1u];
+
+    typedef struct audio_voice audio_voice_t;
+
+    /* Render callback of a voice. Writes up to 'frames' mono samples at mix
+    *  scale into 'dst' and returns the number of frames written. Returning
+    *  less than 'frames' ends the voice. */
+    typedef uint32_t (*audio_voice_render_t)(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+
+    /* Common header of every sound source. Embed it as the first member of
+    *  the source object. */
+    struct audio_voice
+    {
+        audio_voice_render_t render;    /* Render callback */
+        uint32_t gain;                  /* Q14 voice gain */
+        int8_t pan;                     /* AUDIO_PAN_LEFT to AUDIO_PAN_RIGHT */
+    };
+
+    void audio_mixer_init(void);
+    bool audio_mixer_add(audio_voice_t *voice);
+    void audio_mixer_remove(audio_voice_t *voice);
+    bool audio_mixer_replace(audio_voice_t *voice, audio_voice_t *replacement);
+    bool audio_mixer_is_idle(void);
+    uint32_t audio_mixer_get_voice_count(void);
+    void audio_mixer_set_balance(int8_t balance);
+    void audio_mixer_render(int32_t *mix, uint32_t frames);
+
+#endif
+
+/* [] END OF FILE */
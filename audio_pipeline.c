@@ -0,0 +1,322 @@
+/*****************************************************************************
+* File Name: audio_pipeline.c
+*
+* Description: This file contains the audio output pipeline. Two blocks in the
+*              output word format are ping-ponged: while one is written to the
+*              I2S TX FIFO, the mixer renders the next one into the other.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "audio_pipeline.h"
+#include "audio_format.h"
+#include "audio_mixer.h"
+#include "audio_rate.h"
+#include "audio_glitch.h"
+#include "audio_energy.h"
+#include "cpu_governor.h"
+#include "cycle_counter.h"
+#include "profile.h"
+#include "timebase.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of output blocks */
+#define PIPELINE_BUFFER_COUNT   2u
+/* Words left in the TX FIFO when a block has been written: the HAL refills
+*  the FIFO when it is half empty (half of 128 words) */
+#define PIPELINE_FIFO_MARGIN_WORDS  64u
+/* TX FIFO events reported as glitches */
+#define PIPELINE_FIFO_EVENTS    (CYHAL_I2S_TX_UNDERFLOW | CYHAL_I2S_TX_OVERFLOW)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool pipeline_render(audio_sample_t *dst);
+static void pipeline_check_refill(void);
+static uint32_t pipeline_frames_to_us(uint32_t frames);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Output blocks in the I2S word format */
+static audio_sample_t tx_buffer[PIPELINE_BUFFER_COUNT][AUDIO_BLOCK_WORDS];
+/* Stereo mix buffer */
+static int32_t mix_buffer[AUDIO_BLOCK_WORDS];
+
+static cyhal_i2s_t *pipeline_i2s;
+static volatile bool pipeline_active;
+/* Block being written to the TX FIFO */
+static uint32_t tx_index;
+/* Set when the other block holds rendered data */
+static bool next_ready;
+
+/* Blocks queued since the clip started */
+static uint32_t pipeline_blocks;
+/* Time the last block was queued */
+static uint32_t pipeline_queued_time;
+/* Block period, and the longest interval between two blocks without an
+*  underrun, in us */
+static uint32_t pipeline_period_us;
+static uint32_t pipeline_deadline_us;
+
+/*******************************************************************************
+* Function Name: audio_pipeline_init
+********************************************************************************
+* Summary:
+*  Initialize the pipeline, the mixer and the glitch telemetry.
+*
+* Parameters:
+*  i2s: I2S object the blocks are written to
+*
+*******************************************************************************/
+void audio_pipeline_init(cyhal_i2s_t *i2s)
+{
+    pipeline_i2s    = i2s;
+    pipeline_active = false;
+
+    audio_mixer_init();
+    audio_glitch_reset();
+}
+
+/*******************************************************************************
+* Function Name: audio_pipeline_start
+********************************************************************************
+* Summary:
+*  Render the first two blocks and start the I2S TX. Voices must be added to
+*  the mixer before calling this function.
+*
+* Return:
+*  bool: false if the pipeline is already running or there is nothing to play
+*
+*******************************************************************************/
+bool audio_pipeline_start(void)
+{
+    if (pipeline_active)
+    {
+        return false;
+    }
+
+    /* Render the first blocks at the full CPU clock */
+    audio_energy_clip_start();
+    cpu_governor_start();
+
+    if (!pipeline_render(tx_buffer[0]))
+    {
+        cpu_governor_stop();
+        audio_energy_clip_cancel();
+        return false;
+    }
+    next_ready = pipeline_render(tx_buffer[1]);
+    tx_index   = 0;
+
+    pipeline_period_us   = pipeline_frames_to_us(AUDIO_BLOCK_FRAMES);
+    pipeline_deadline_us = pipeline_period_us + pipeline_frames_to_us(PIPELINE_FIFO_MARGIN_WORDS / AUDIO_CHANNELS);
+    pipeline_blocks      = 1;
+
+    pipeline_active = true;
+
+    /* Start the I2S TX and report the FIFO errors */
+    cyhal_i2s_start_tx(pipeline_i2s);
+    cyhal_i2s_enable_event(pipeline_i2s, (cyhal_i2s_event_t) PIPELINE_FIFO_EVENTS, CYHAL_ISR_PRIORITY_DEFAULT, true);
+
+    trace_log(TRACE_PLAY_START, audio_mixer_get_voice_count(), audio_rate_get());
+
+    /* Initiate the transfer of the first block */
+    pipeline_queued_time = timebase_now();
+    cyhal_i2s_write_async(pipeline_i2s, tx_buffer[0], AUDIO_BLOCK_WORDS);
+    audio_glitch_on_block();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_pipeline_is_active
+********************************************************************************
+* Summary:
+*  Check if the pipeline is streaming.
+*
+* Return:
+*  bool: true while blocks are written to the I2S
+*
+*******************************************************************************/
+bool audio_pipeline_is_active(void)
+{
+    return pipeline_active;
+}
+
+/*******************************************************************************
+* Function Name: audio_pipeline_on_tx_complete
+********************************************************************************
+* Summary:
+*  Called from the I2S ISR when a block has been written to the TX FIFO.
+*  Queues the next block and renders the one after it.
+*
+* Return:
+*  bool: false when there is nothing left to play and the TX can be stopped
+*
+*******************************************************************************/
+bool audio_pipeline_on_tx_complete(void)
+{
+    if (!next_ready)
+    {
+        pipeline_active = false;
+        cyhal_i2s_enable_event(pipeline_i2s, (cyhal_i2s_event_t) PIPELINE_FIFO_EVENTS, CYHAL_ISR_PRIORITY_DEFAULT, false);
+        cpu_governor_stop();
+        audio_energy_clip_stop();
+        trace_log(TRACE_STOP, 0u, pipeline_blocks);
+        return false;
+    }
+
+    pipeline_check_refill();
+
+    tx_index ^= 1u;
+    cyhal_i2s_write_async(pipeline_i2s, tx_buffer[tx_index], AUDIO_BLOCK_WORDS);
+    pipeline_blocks++;
+    trace_log(TRACE_REFILL, tx_index, pipeline_blocks);
+    audio_glitch_on_block();
+    audio_energy_on_block();
+
+    next_ready = pipeline_render(tx_buffer[tx_index ^ 1u]);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_pipeline_on_fifo_event
+********************************************************************************
+* Summary:
+*  Called from the I2S ISR on a TX FIFO underflow or overflow. The underflow
+*  event stays disabled until the next block is queued, so an empty FIFO
+*  counts once instead of raising an interrupt per frame.
+*
+* Parameters:
+*  event: I2S events that occurred
+*
+*******************************************************************************/
+void audio_pipeline_on_fifo_event(cyhal_i2s_event_t event)
+{
+    if ((event & CYHAL_I2S_TX_UNDERFLOW) != 0u)
+    {
+        cyhal_i2s_enable_event(pipeline_i2s, CYHAL_I2S_TX_UNDERFLOW, CYHAL_ISR_PRIORITY_DEFAULT, false);
+        audio_glitch_record(AUDIO_GLITCH_TX_UNDERFLOW, pipeline_blocks, 0u);
+    }
+
+    if ((event & CYHAL_I2S_TX_OVERFLOW) != 0u)
+    {
+        audio_glitch_record(AUDIO_GLITCH_TX_OVERFLOW, pipeline_blocks, 0u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pipeline_render
+********************************************************************************
+* Summary:
+*  Mix one block and convert it to the output word length. The cycles it
+*  takes are reported to the CPU clock governor.
+*
+* Parameters:
+*  dst: output block
+*
+* Return:
+*  bool: false if the mixer had no voice to render
+*
+*******************************************************************************/
+static bool pipeline_render(audio_sample_t *dst)
+{
+    uint32_t start;
+    uint32_t cycles;
+
+    if (audio_mixer_is_idle())
+    {
+        return false;
+    }
+
+    start = cycle_counter_read();
+
+    PROFILE_BEGIN(PROFILE_MIX);
+    audio_mixer_render(mix_buffer, AUDIO_BLOCK_FRAMES);
+    PROFILE_END(PROFILE_MIX);
+
+    PROFILE_BEGIN(PROFILE_PACK);
+    for (uint32_t i = 0; i < AUDIO_BLOCK_WORDS; i++)
+    {
+        dst[i] = audio_format_pack(mix_buffer[i]);
+    }
+    PROFILE_END(PROFILE_PACK);
+
+    cycles = cycle_counter_read() - start;
+    PROFILE_RECORD(PROFILE_RENDER, cycles);
+    cpu_governor_on_block(cycles, AUDIO_BLOCK_FRAMES, audio_rate_get());
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: pipeline_check_refill
+********************************************************************************
+* Summary:
+*  Check that the next block is queued before the TX FIFO runs dry: the
+*  interval since the last block may exceed the block period by the time
+*  the FIFO margin plays. Re-enables the underflow event.
+*
+*******************************************************************************/
+static void pipeline_check_refill(void)
+{
+    uint32_t now = timebase_now();
+    uint32_t interval_us = timebase_ticks_to_us(now - pipeline_queued_time);
+
+    if (interval_us > pipeline_deadline_us)
+    {
+        audio_glitch_record(AUDIO_GLITCH_LATE_REFILL, pipeline_blocks, interval_us - pipeline_period_us);
+    }
+
+    pipeline_queued_time = now;
+    cyhal_i2s_enable_event(pipeline_i2s, CYHAL_I2S_TX_UNDERFLOW, CYHAL_ISR_PRIORITY_DEFAULT, true);
+}
+
+/*******************************************************************************
+* Function Name: pipeline_frames_to_us
+********************************************************************************
+* Summary:
+*  Convert a number of frames to a duration at the current sample rate.
+*
+*******************************************************************************/
+static uint32_t pipeline_frames_to_us(uint32_t frames)
+{
+    return (uint32_t) (((uint64_t) frames * 1000000u) / audio_rate_get());
+}
+
+/* [] END OF FILE */
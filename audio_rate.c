@@ -0,0 +1,314 @@
+/*****************************************************************************
+* File Name: audio_rate.c
+*
+* Description: This file contains the runtime sample rate switch. Between clips,
+*              the clock tree is reprogrammed from the precomputed clock plan of
+*              the new rate and the I2S rate is updated, while the codec stays
+*              configured and is only soft-muted around the change.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "audio_rate.h"
+#include "audio_format.h"
+#include "audio_pipeline.h"
+#include "clock_plan.h"
+#include "codec.h"
+#include "isr_latency.h"
+#include "timebase.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* MCLK duty cycle */
+#define RATE_MCLK_DUTY_CYCLE    50.0f       /* in % */
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void audio_rate_on_muted(bool success);
+static void audio_rate_on_done(bool success);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_i2s_t *rate_i2s;
+static cyhal_pwm_t *rate_mclk_pwm;
+static cyhal_clock_t *rate_pll_clock;
+static cyhal_clock_t *rate_audio_clock;
+
+/* Current sample rate */
+static uint32_t rate_current_hz;
+/* Duration of the last switch */
+static uint32_t rate_switch_us;
+
+/* Switch in progress: new rate, its plan, start time and the caller's
+*  completion */
+static volatile bool rate_switching;
+static uint32_t rate_target_hz;
+static const clock_plan_t *rate_plan;
+static uint32_t rate_start_time;
+static codec_done_t rate_done;
+/* The PLL did not lock with the new plan: the switch ends at the current
+*  rate and fails */
+static bool rate_pll_failed;
+
+/*******************************************************************************
+* Function Name: audio_rate_init
+********************************************************************************
+* Summary:
+*  Store the objects programmed on a rate switch. They must already be
+*  initialized for the given rate.
+*
+* Parameters:
+*  i2s: I2S object
+*  mclk_pwm: PWM generating the MCLK
+*  pll_clock: PLL sourcing HFCLK0 and HFCLK1
+*  audio_clock: HFCLK1
+*  sample_rate_hz: current sample rate
+*
+*******************************************************************************/
+void audio_rate_init(cyhal_i2s_t *i2s, cyhal_pwm_t *mclk_pwm, cyhal_clock_t *pll_clock,
+                     cyhal_clock_t *audio_clock, uint32_t sample_rate_hz)
+{
+    rate_i2s          = i2s;
+    rate_mclk_pwm     = mclk_pwm;
+    rate_pll_clock    = pll_clock;
+    rate_audio_clock  = audio_clock;
+    rate_current_hz   = sample_rate_hz;
+    rate_switch_us    = 0;
+    rate_switching    = false;
+}
+
+/*******************************************************************************
+* Function Name: audio_rate_set
+********************************************************************************
+* Summary:
+*  Start a switch of the output sample rate. Only allowed while the pipeline
+*  is idle, so a clip can be played at its native rate without resampling.
+*
+*  The switch runs in steps and never waits for the codec: the DAC is muted
+*  in the background, then audio_rate_handler() reprograms the clocks from
+*  the main loop, and the codec is configured and unmuted in the background.
+*  The PLL output is also the CPU clock: while it relocks, HFCLK0 runs from
+*  the PLL bypass (IMO). CLK_FAST keeps its divider throughout.
+*
+* Parameters:
+*  sample_rate_hz: new sample rate, one of clock_plan_rates[]
+*  done: called from an ISR at the end of the switch, or before the function
+*        returns if the rate is already set; can be NULL. With false if the
+*        codec could not be muted or configured, in which case the DAC is
+*        left muted, or if the PLL did not lock, in which case the current
+*        rate is kept
+*
+* Return:
+*  bool: false if the pipeline is playing, a switch is in progress, or the
+*  rate has no clock plan or is not supported by the codec; done is not
+*  called then
+*
+*******************************************************************************/
+bool audio_rate_set(uint32_t sample_rate_hz, codec_done_t done)
+{
+    const clock_plan_t *plan;
+
+    if (rate_switching || audio_pipeline_is_active())
+    {
+        return false;
+    }
+
+    if (sample_rate_hz == rate_current_hz)
+    {
+        if (done != NULL)
+        {
+            done(true);
+        }
+        return true;
+    }
+
+    plan = clock_plan_get(sample_rate_hz);
+    if ((plan == NULL) || !codec_supports(sample_rate_hz, AUDIO_WORD_LENGTH))
+    {
+        return false;
+    }
+
+    rate_switching  = true;
+    rate_target_hz  = sample_rate_hz;
+    rate_plan       = plan;
+    rate_done       = done;
+    rate_pll_failed = false;
+    rate_start_time = timebase_now();
+
+    /* Mute the DAC while its clocks change */
+    codec_rate_begin(audio_rate_on_muted);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_rate_handler
+********************************************************************************
+* Summary:
+*  Scheduler handler of SCHEDULER_EVENT_RATE_SWITCH: the DAC is muted,
+*  reprogram the clocks for the new rate and configure the codec. If the PLL
+*  does not lock with the new plan, the plan of the current rate is
+*  restored and the switch fails.
+*
+* Parameters:
+*  event: not used
+*
+*******************************************************************************/
+void audio_rate_handler(const scheduler_event_t *event)
+{
+    const clock_plan_t *plan = rate_plan;
+
+    (void) event;
+
+    if (!rate_switching)
+    {
+        return;
+    }
+
+    cyhal_pwm_stop(rate_mclk_pwm);
+
+    /* Relock the PLL with the dividers of the plan; HFCLK0 falls back to the
+    *  bypass clock meanwhile. If the current plan does not lock again
+    *  either, the system keeps running from the bypass clock. */
+    if (!clock_plan_set_pll(plan))
+    {
+        rate_pll_failed = true;
+        plan = clock_plan_get(rate_current_hz);
+        (void) clock_plan_set_pll(plan);
+    }
+    else
+    {
+        cyhal_clock_set_divider(rate_audio_clock, plan->hfclk1_div);
+        cyhal_i2s_set_sample_rate(rate_i2s, rate_target_hz);
+        rate_current_hz = rate_target_hz;
+    }
+
+    /* CLK_PERI followed the PLL: the MCLK PWM period, the codec I2C clock
+    *  (reprogrammed by codec_rate_end()) and the latency timers are
+    *  recomputed */
+    cyhal_pwm_set_duty_cycle(rate_mclk_pwm, RATE_MCLK_DUTY_CYCLE, plan->mclk_hz);
+    cyhal_pwm_start(rate_mclk_pwm);
+    isr_latency_on_peri_clock();
+
+    trace_log(TRACE_RATE_SWITCH, rate_pll_failed ? 1u : 0u, rate_current_hz);
+
+    codec_rate_end(rate_current_hz, audio_rate_on_done);
+}
+
+/*******************************************************************************
+* Function Name: audio_rate_get
+********************************************************************************
+* Summary:
+*  Get the current output sample rate.
+*
+* Return:
+*  uint32_t: sample rate in Hz
+*
+*******************************************************************************/
+uint32_t audio_rate_get(void)
+{
+    return rate_current_hz;
+}
+
+/*******************************************************************************
+* Function Name: audio_rate_last_switch_us
+********************************************************************************
+* Summary:
+*  Get the duration of the last rate switch, from audio_rate_set() to the
+*  end of the codec settling.
+*
+* Return:
+*  uint32_t: duration in us, 0 if the rate was never switched
+*
+*******************************************************************************/
+uint32_t audio_rate_last_switch_us(void)
+{
+    return rate_switch_us;
+}
+
+/*******************************************************************************
+* Function Name: audio_rate_on_muted
+********************************************************************************
+* Summary:
+*  The DAC is muted, called from an ISR: the clocks are reprogrammed from
+*  the main loop. If the event cannot be posted, the switch ends at the
+*  current rate and the DAC is unmuted. If the mute failed, the clocks are
+*  left as they are and the switch fails.
+*
+* Parameters:
+*  success: false if the DAC could not be muted
+*
+*******************************************************************************/
+static void audio_rate_on_muted(bool success)
+{
+    if (!success)
+    {
+        audio_rate_on_done(false);
+    }
+    else if (!scheduler_post(SCHEDULER_EVENT_RATE_SWITCH, rate_target_hz, timebase_now()))
+    {
+        codec_rate_end(rate_current_hz, audio_rate_on_done);
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_rate_on_done
+********************************************************************************
+* Summary:
+*  End of the switch, called from an ISR: record its duration and report
+*  it.
+*
+* Parameters:
+*  success: false if the codec failed; the switch also fails if the PLL
+*           did not lock
+*
+*******************************************************************************/
+static void audio_rate_on_done(bool success)
+{
+    codec_done_t done = rate_done;
+
+    rate_switch_us = timebase_ticks_to_us(timebase_now() - rate_start_time);
+    rate_done      = NULL;
+    rate_switching = false;
+
+    if (done != NULL)
+    {
+        done(success && !rate_pll_failed);
+    }
+}
+
+/* [] END OF FILE */
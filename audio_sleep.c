@@ -0,0 +1,353 @@
+/*****************************************************************************
+* File Name: audio_sleep.c
+*
+* Description: This file contains the idle power management of the audio
+*              subsystem. After a clip, the codec output is muted and powered
+*              down once an idle timeout expires; the CPU then enters Deep
+*              Sleep: the MCLK is stopped before, and the PLL and the MCLK are
+*              restored by a syspm callback on wake-up. The codec is resumed
+*              only when a clip is about to play, so wake-ups that do not
+*              start playback stay short.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "audio_sleep.h"
+#include "audio_energy.h"
+#include "audio_pipeline.h"
+#include "codec.h"
+#include "timebase.h"
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool audio_sleep_callback(cyhal_syspm_callback_state_t state,
+                                 cyhal_syspm_callback_mode_t mode, void *arg);
+static void audio_sleep_codec_handler(void);
+static void audio_sleep_on_codec_on(bool success);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_pwm_t *sleep_mclk_pwm;
+static cyhal_clock_t *sleep_pll_clock;
+static cyhal_syspm_callback_data_t sleep_callback_data;
+
+/* Power state of the codec output */
+typedef enum
+{
+    SLEEP_CODEC_ON,
+    SLEEP_CODEC_MUTING,             /* Idle timeout expired, mute ramping */
+    SLEEP_CODEC_OFF,
+} sleep_codec_state_t;
+
+static volatile sleep_codec_state_t sleep_codec_state;
+static timebase_alarm_t sleep_codec_alarm;
+/* Timebase time of the last codec power-down */
+static uint32_t sleep_codec_off_time;
+/* Time the codec was powered down, in ticks, the current period excluded */
+static uint64_t sleep_codec_off_ticks;
+/* Power-up in progress: its start time and the caller's completion */
+static uint32_t sleep_resume_time;
+static codec_done_t sleep_resume_done;
+/* Timebase time of the last wake-up from Deep Sleep */
+static uint32_t sleep_wake_time;
+static audio_sleep_stats_t sleep_stats;
+
+/*******************************************************************************
+* Function Name: audio_sleep_init
+********************************************************************************
+* Summary:
+*  Register the Deep Sleep callback and start the codec idle timeout. The
+*  codec must be active and the timebase initialized.
+*
+* Parameters:
+*  mclk_pwm: PWM generating the MCLK
+*  pll_clock: PLL sourcing the audio subsystem
+*
+*******************************************************************************/
+void audio_sleep_init(cyhal_pwm_t *mclk_pwm, cyhal_clock_t *pll_clock)
+{
+    sleep_mclk_pwm        = mclk_pwm;
+    sleep_pll_clock       = pll_clock;
+    sleep_codec_state     = SLEEP_CODEC_ON;
+    sleep_codec_off_ticks = 0;
+
+    memset(&sleep_stats, 0, sizeof(sleep_stats));
+
+    sleep_callback_data.callback     = audio_sleep_callback;
+    sleep_callback_data.states       = CYHAL_SYSPM_CB_CPU_DEEPSLEEP;
+    sleep_callback_data.ignore_modes = (cyhal_syspm_callback_mode_t) 0;
+    sleep_callback_data.args         = NULL;
+    sleep_callback_data.next         = NULL;
+    cyhal_syspm_register_callback(&sleep_callback_data);
+
+    audio_sleep_on_stop();
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_idle
+********************************************************************************
+* Summary:
+*  Enter the idle mode until the next interrupt. While the pipeline plays
+*  or the codec output is powered, or if Deep Sleep is disabled or refused,
+*  the CPU only enters Sleep.
+*
+*******************************************************************************/
+void audio_sleep_idle(void)
+{
+    if ((AUDIO_IDLE_DEEP_SLEEP == 0) || audio_pipeline_is_active() || (sleep_codec_state != SLEEP_CODEC_OFF))
+    {
+        cyhal_syspm_sleep();
+        audio_energy_on_wakeup();
+        return;
+    }
+
+    if (cyhal_syspm_deepsleep() != CY_RSLT_SUCCESS)
+    {
+        cyhal_syspm_sleep();
+    }
+    audio_energy_on_wakeup();
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_resume
+********************************************************************************
+* Summary:
+*  Power the codec output back up before a clip is played, if it was
+*  powered down. The codec registers are retained, so it is not
+*  reinitialized. The DAC stays muted until the caller unmutes it. Returns
+*  at once; does not wait for the codec.
+*
+* Parameters:
+*  done: called once the codec output is powered, from an ISR or before
+*        the function returns; with false if the power-up failed, and the
+*        output is then powered down again
+*
+*******************************************************************************/
+void audio_sleep_resume(codec_done_t done)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    sleep_codec_state_t state = sleep_codec_state;
+
+    timebase_cancel_alarm(&sleep_codec_alarm);
+    sleep_codec_state = SLEEP_CODEC_ON;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    if (state == SLEEP_CODEC_OFF)
+    {
+        sleep_resume_time = timebase_now();
+        sleep_resume_done = done;
+        sleep_codec_off_ticks += sleep_resume_time - sleep_codec_off_time;
+
+        codec_activate(audio_sleep_on_codec_on);
+    }
+    else if (done != NULL)
+    {
+        done(true);
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_on_play
+********************************************************************************
+* Summary:
+*  Called when the first block of a clip is queued to the I2S. Records the
+*  time since the last wake-up from Deep Sleep.
+*
+*******************************************************************************/
+void audio_sleep_on_play(void)
+{
+    if (sleep_stats.deep_sleeps > 0u)
+    {
+        sleep_stats.wake_to_play_us = timebase_ticks_to_us(timebase_now() - sleep_wake_time);
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_on_stop
+********************************************************************************
+* Summary:
+*  Called when a clip has been played. Starts the codec idle timeout.
+*
+*******************************************************************************/
+void audio_sleep_on_stop(void)
+{
+    timebase_set_alarm(&sleep_codec_alarm, timebase_ms_to_ticks(AUDIO_CODEC_IDLE_MS), audio_sleep_codec_handler);
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_get_stats
+********************************************************************************
+* Summary:
+*  Get the cost of the Deep Sleep idle mode and the savings of the codec
+*  power-down, estimated from the codec idle currents of codec.h.
+*
+* Parameters:
+*  stats: filled with the statistics
+*
+*******************************************************************************/
+void audio_sleep_get_stats(audio_sleep_stats_t *stats)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    uint64_t off_ticks = sleep_codec_off_ticks;
+    uint64_t off_ms;
+
+    if (sleep_codec_state == SLEEP_CODEC_OFF)
+    {
+        off_ticks += timebase_now() - sleep_codec_off_time;
+    }
+    *stats = sleep_stats;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    off_ms = (off_ticks * 1000u) / timebase_ms_to_ticks(1000u);
+    stats->codec_off_ms    = (uint32_t) off_ms;
+    stats->codec_saved_uah = (uint32_t) (((uint64_t) (CODEC_IDLE_ON_UA - CODEC_IDLE_OFF_UA) * off_ms) / 3600000u);
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_callback
+********************************************************************************
+* Summary:
+*  Deep Sleep callback. Refuses Deep Sleep while the pipeline plays, stops
+*  the MCLK before and restores the audio clocks after the transition.
+*
+* Return:
+*  bool: false to refuse the transition
+*
+*******************************************************************************/
+static bool audio_sleep_callback(cyhal_syspm_callback_state_t state,
+                                 cyhal_syspm_callback_mode_t mode, void *arg)
+{
+    uint32_t start;
+
+    (void) state;
+    (void) arg;
+
+    switch (mode)
+    {
+        case CYHAL_SYSPM_CHECK_READY:
+            /* The codec commands need the I2C until they are written */
+            return !audio_pipeline_is_active() && codec_is_idle();
+
+        case CYHAL_SYSPM_BEFORE_TRANSITION:
+            cyhal_pwm_stop(sleep_mclk_pwm);
+            sleep_stats.deep_sleeps++;
+            break;
+
+        case CYHAL_SYSPM_AFTER_TRANSITION:
+            start = timebase_now();
+            sleep_wake_time = start;
+
+            /* Wait for the PLL to relock before the MCLK is restarted */
+            cyhal_clock_set_enabled(sleep_pll_clock, true, true);
+            cyhal_pwm_start(sleep_mclk_pwm);
+
+            sleep_stats.restore_us = timebase_ticks_to_us(timebase_now() - start);
+            break;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_codec_handler
+********************************************************************************
+* Summary:
+*  Timebase alarm of the codec power-down. When the idle timeout expires the
+*  DAC is muted; once the mute has ramped down, the output is powered down,
+*  so the amplifiers turn off on silence.
+*
+*******************************************************************************/
+static void audio_sleep_codec_handler(void)
+{
+    if (sleep_codec_state == SLEEP_CODEC_ON)
+    {
+        codec_mute(true);
+        sleep_codec_state = SLEEP_CODEC_MUTING;
+        /* One tick more than the ramp, as the conversion rounds down and the
+        *  current tick has partly elapsed */
+        timebase_set_alarm(&sleep_codec_alarm, timebase_ms_to_ticks(CODEC_MUTE_MS) + 1u, audio_sleep_codec_handler);
+    }
+    else if (sleep_codec_state == SLEEP_CODEC_MUTING)
+    {
+        codec_power_down();
+        sleep_codec_state    = SLEEP_CODEC_OFF;
+        sleep_codec_off_time = timebase_now();
+        sleep_stats.codec_power_downs++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_sleep_on_codec_on
+********************************************************************************
+* Summary:
+*  End of the codec power-up: record its duration and report it. If it
+*  failed, the output is powered down at once, so the next resume powers it
+*  up again; the DAC is still muted.
+*
+* Parameters:
+*  success: false if the power-up failed
+*
+*******************************************************************************/
+static void audio_sleep_on_codec_on(bool success)
+{
+    codec_done_t done = sleep_resume_done;
+
+    if (success)
+    {
+        sleep_stats.codec_resume_us = timebase_ticks_to_us(timebase_now() - sleep_resume_time);
+    }
+    else
+    {
+        codec_power_down();
+        sleep_codec_state    = SLEEP_CODEC_OFF;
+        sleep_codec_off_time = timebase_now();
+    }
+
+    sleep_resume_done = NULL;
+    if (done != NULL)
+    {
+        done(success);
+    }
+}
+
+/* [] END OF FILE */
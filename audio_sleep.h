@@ -0,0 +1,82 @@
+/*****************************************************************************
+* File Name: audio_sleep.h
+*
+* Description: This file contains the definitions of the idle power management
+*              of the audio subsystem.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_SLEEP_H
+    #define AUDIO_SLEEP_H
+
+    #include <stdint.h>
+
+    #include "cyhal.h"
+    #include "codec.h"
+
+    /* Idle mode between clips: 1 for Deep Sleep, 0 for Sleep. Set it from the
+    *  Makefile with DEFINES+=AUDIO_IDLE_DEEP_SLEEP=<mode> */
+    #ifndef AUDIO_IDLE_DEEP_SLEEP
+        #define AUDIO_IDLE_DEEP_SLEEP   1
+    #endif
+
+    /* Time the codec output stays powered after a clip, so that a clip
+    *  played soon after starts without the codec power-up. Set it from the
+    *  Makefile with DEFINES+=AUDIO_CODEC_IDLE_MS=<ms> */
+    #ifndef AUDIO_CODEC_IDLE_MS
+        #define AUDIO_CODEC_IDLE_MS     2000u
+    #endif
+
+    /* Cost and savings of the idle modes */
+    typedef struct
+    {
+        uint32_t deep_sleeps;       /* Deep Sleep entries */
+        uint32_t restore_us;        /* Last clock restore (PLL relock, MCLK) */
+        uint32_t wake_to_play_us;   /* Last wake-up to first block queued */
+        uint32_t codec_power_downs; /* Codec output power-downs */
+        uint32_t codec_resume_us;   /* Last codec power-up, until unmuted */
+        uint32_t codec_off_ms;      /* Time the codec output was powered down */
+        uint32_t codec_saved_uah;   /* Estimated charge saved meanwhile */
+    } audio_sleep_stats_t;
+
+    void audio_sleep_init(cyhal_pwm_t *mclk_pwm, cyhal_clock_t *pll_clock);
+    void audio_sleep_idle(void);
+    void audio_sleep_resume(codec_done_t done);
+    void audio_sleep_on_play(void);
+    void audio_sleep_on_stop(void);
+    void audio_sleep_get_stats(audio_sleep_stats_t *stats);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,330 @@
+/*****************************************************************************
+* File Name: audio_stream.c
+*
+* Description: This file contains the stream voice. Once per block, the buffer
+*              fill is low-pass filtered and a PI controller turns its distance
+*              from half full into a resampling correction in ppm, which tracks
+*              the drift between the source clock and the I2S clock. The samples
+*              are resampled with a 4-point cubic Hermite interpolator on a Q32
+*              read position.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cyhal.h"
+
+#include "audio_stream.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Read position format */
+#define STREAM_POS_FRAC_BITS    32u
+/* Buffer fill low-pass filter: fill += (new - fill) / 2^STREAM_FILL_SHIFT */
+#define STREAM_FILL_SHIFT       5u
+#define STREAM_FILL_FRAC_BITS   8u
+/* Controller gains. Proportional: ppm per sample of fill error. Integral:
+*  ppm per sample of fill error and per block, Q16. */
+#define STREAM_KP               2
+#define STREAM_KI_Q16           100
+#define STREAM_KI_FRAC_BITS     16u
+/* Samples needed around the read position by the interpolator */
+#define STREAM_TAPS_AFTER       2u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t audio_stream_render(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+static void stream_update_drift(audio_stream_t *obj, uint32_t fill);
+static int32_t stream_interpolate(const audio_stream_t *obj, uint32_t index, uint32_t frac);
+
+/*******************************************************************************
+* Function Name: audio_stream_init
+********************************************************************************
+* Summary:
+*  Prepare a stream voice. Playback starts once the buffer is half full, and
+*  the controller then keeps it half full.
+*
+* Parameters:
+*  obj: stream voice object
+*  buffer: ring buffer
+*  size: ring buffer length in samples, a power of 2
+*
+*******************************************************************************/
+void audio_stream_init(audio_stream_t *obj, int16_t *buffer, uint32_t size)
+{
+    obj->voice.render   = audio_stream_render;
+    obj->voice.gain     = AUDIO_GAIN_UNITY;
+    obj->voice.pan      = AUDIO_PAN_CENTER;
+    obj->buffer         = buffer;
+    obj->mask           = size - 1u;
+    obj->write          = 0;
+    obj->position       = 0;
+    obj->started        = false;
+    obj->ended          = false;
+    obj->fill_filtered  = (int32_t) ((size / 2u) << STREAM_FILL_FRAC_BITS);
+    obj->integral       = 0;
+    obj->correction_ppm = 0;
+    obj->underruns      = 0;
+    obj->overruns       = 0;
+}
+
+/*******************************************************************************
+* Function Name: audio_stream_write
+********************************************************************************
+* Summary:
+*  Append received samples to the stream. Samples that do not fit are dropped
+*  and counted as overruns.
+*
+* Parameters:
+*  obj: stream voice object
+*  samples: 16-bit mono samples
+*  count: number of samples
+*
+* Return:
+*  uint32_t: number of samples written
+*
+*******************************************************************************/
+uint32_t audio_stream_write(audio_stream_t *obj, const int16_t *samples, uint32_t count)
+{
+    /* The 64-bit read position is updated by the I2S ISR in two stores */
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    uint32_t read = (uint32_t) (obj->position >> STREAM_POS_FRAC_BITS);
+    cyhal_system_critical_section_exit(interrupt_state);
+    /* Keep the sample before the read position for the interpolator */
+    uint32_t space = obj->mask - (obj->write - read);
+    uint32_t write = obj->write;
+
+    if (count > space)
+    {
+        obj->overruns += count - space;
+        count = space;
+    }
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        obj->buffer[(write + n) & obj->mask] = samples[n];
+    }
+
+    /* Publish the samples only once they are in the buffer */
+    __DMB();
+    obj->write = write + count;
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: audio_stream_end
+********************************************************************************
+* Summary:
+*  Mark the end of the stream. The voice ends once the buffer is drained.
+*
+* Parameters:
+*  obj: stream voice object
+*
+*******************************************************************************/
+void audio_stream_end(audio_stream_t *obj)
+{
+    obj->ended = true;
+}
+
+/*******************************************************************************
+* Function Name: audio_stream_get_stats
+********************************************************************************
+* Summary:
+*  Get the drift and glitch statistics of a stream.
+*
+* Parameters:
+*  obj: stream voice object
+*  stats: filled with the statistics
+*
+*******************************************************************************/
+void audio_stream_get_stats(const audio_stream_t *obj, audio_stream_stats_t *stats)
+{
+    stats->correction_ppm = obj->correction_ppm;
+    stats->fill_average   = (uint32_t) obj->fill_filtered >> STREAM_FILL_FRAC_BITS;
+    stats->underruns      = obj->underruns;
+    stats->overruns       = obj->overruns;
+}
+
+/*******************************************************************************
+* Function Name: audio_stream_render
+********************************************************************************
+* Summary:
+*  Render callback of the stream voice. Plays silence until the buffer is
+*  half full, then resamples it with the current correction.
+*
+*******************************************************************************/
+static uint32_t audio_stream_render(audio_voice_t *voice, int32_t *dst, uint32_t frames)
+{
+    audio_stream_t *obj = (audio_stream_t *) voice;
+    uint32_t write = obj->write;
+    uint32_t read = (uint32_t) (obj->position >> STREAM_POS_FRAC_BITS);
+    uint32_t fill = write - read;
+    uint32_t n = 0;
+
+    if (!obj->started)
+    {
+        if ((fill <= (obj->mask / 2u)) && !obj->ended)
+        {
+            for (; n < frames; n++)
+            {
+                dst[n] = 0;
+            }
+            return frames;
+        }
+        obj->started = true;
+    }
+
+    stream_update_drift(obj, fill);
+
+    /* Q32 step: 1 + correction * 1e-6 */
+    uint64_t step = (1uLL << STREAM_POS_FRAC_BITS) +
+                    (uint64_t) (((int64_t) obj->correction_ppm << STREAM_POS_FRAC_BITS) / 1000000);
+    uint64_t position = obj->position;
+
+    for (; n < frames; n++)
+    {
+        uint32_t index = (uint32_t) (position >> STREAM_POS_FRAC_BITS);
+
+        if ((write - index) <= STREAM_TAPS_AFTER)
+        {
+            break;
+        }
+
+        dst[n] = stream_interpolate(obj, index, (uint32_t) position);
+        position += step;
+    }
+
+    obj->position = position;
+
+    if (n < frames)
+    {
+        if (obj->ended)
+        {
+            return n;
+        }
+
+        /* Starved: pad with silence and wait for the buffer to refill */
+        obj->underruns += frames - n;
+        obj->started = false;
+        for (; n < frames; n++)
+        {
+            dst[n] = 0;
+        }
+    }
+
+    return frames;
+}
+
+/*******************************************************************************
+* Function Name: stream_update_drift
+********************************************************************************
+* Summary:
+*  Filter the buffer fill and update the resampling correction. In steady
+*  state the integral term equals the drift between the two clocks.
+*
+* Parameters:
+*  obj: stream voice object
+*  fill: samples in the buffer
+*
+*******************************************************************************/
+static void stream_update_drift(audio_stream_t *obj, uint32_t fill)
+{
+    int32_t target = (int32_t) (((obj->mask + 1u) / 2u) << STREAM_FILL_FRAC_BITS);
+    int32_t error;
+    int32_t correction;
+
+    obj->fill_filtered += (((int32_t) fill << STREAM_FILL_FRAC_BITS) - obj->fill_filtered) >> STREAM_FILL_SHIFT;
+    error = (obj->fill_filtered - target) >> STREAM_FILL_FRAC_BITS;
+
+    /* Clamp the integral so the integral term alone stays within range */
+    obj->integral += error;
+    if (obj->integral > ((AUDIO_STREAM_MAX_PPM << STREAM_KI_FRAC_BITS) / STREAM_KI_Q16))
+    {
+        obj->integral = (AUDIO_STREAM_MAX_PPM << STREAM_KI_FRAC_BITS) / STREAM_KI_Q16;
+    }
+    else if (obj->integral < -((AUDIO_STREAM_MAX_PPM << STREAM_KI_FRAC_BITS) / STREAM_KI_Q16))
+    {
+        obj->integral = -((AUDIO_STREAM_MAX_PPM << STREAM_KI_FRAC_BITS) / STREAM_KI_Q16);
+    }
+
+    correction = (error * STREAM_KP) + ((obj->integral * STREAM_KI_Q16) >> STREAM_KI_FRAC_BITS);
+    if (correction > AUDIO_STREAM_MAX_PPM)
+    {
+        correction = AUDIO_STREAM_MAX_PPM;
+    }
+    else if (correction < -AUDIO_STREAM_MAX_PPM)
+    {
+        correction = -AUDIO_STREAM_MAX_PPM;
+    }
+
+    obj->correction_ppm = correction;
+}
+
+/*******************************************************************************
+* Function Name: stream_interpolate
+********************************************************************************
+* Summary:
+*  4-point cubic Hermite interpolation between buffer[index] and
+*  buffer[index + 1].
+*
+* Parameters:
+*  obj: stream voice object
+*  index: sample before the read position
+*  frac: Q32 fractional read position
+*
+* Return:
+*  int32_t: interpolated sample at mix scale
+*
+*******************************************************************************/
+static int32_t stream_interpolate(const audio_stream_t *obj, uint32_t index, uint32_t frac)
+{
+    int32_t xm1 = obj->buffer[(index - 1u) & obj->mask];
+    int32_t x0  = obj->buffer[index & obj->mask];
+    int32_t x1  = obj->buffer[(index + 1u) & obj->mask];
+    int32_t x2  = obj->buffer[(index + 2u) & obj->mask];
+    /* Q15 fraction */
+    int64_t t = frac >> 17;
+
+    int64_t c1 = (int64_t) (x1 - xm1) << 14;
+    int64_t c2 = ((int64_t) ((2 * xm1) - (5 * x0) + (4 * x1) - x2)) << 14;
+    int64_t c3 = ((int64_t) ((3 * (x0 - x1)) + x2 - xm1)) << 14;
+
+    /* Horner form in Q15, result scaled from 16-bit to mix scale */
+    int64_t y = ((((((c3 * t) >> 15) + c2) * t >> 15) + c1) * t) >> 15;
+
+    return (int32_t) ((((int64_t) x0 << 15) + y) >> (15u - AUDIO_MIX_SHIFT_PCM16));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,88 @@
+/*****************************************************************************
+* File Name: audio_stream.h
+*
+* Description: This file contains the definitions of the stream voice, which plays
+*              audio received from a source with its own clock, such as a radio or
+*              USB link, and absorbs the clock drift with an adaptive resampler.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_STREAM_H
+    #define AUDIO_STREAM_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "audio_mixer.h"
+
+    /* Largest resampling correction, in ppm */
+    #define AUDIO_STREAM_MAX_PPM    2000
+
+    /* Drift and glitch statistics of a stream */
+    typedef struct
+    {
+        int32_t correction_ppm;     /* Resampling correction in use */
+        uint32_t fill_average;      /* Filtered buffer fill, in samples */
+        uint32_t underruns;         /* Output samples played as silence */
+        uint32_t overruns;          /* Input samples dropped on a full buffer */
+    } audio_stream_stats_t;
+
+    /* Voice that plays a ring buffer of 16-bit mono samples. The producer
+    *  writes with audio_stream_write() from one context (thread or ISR) and the
+    *  mixer reads from the I2S ISR. The buffer needs no lock; only the read
+    *  position is sampled by the producer in a short critical section. */
+    typedef struct
+    {
+        audio_voice_t voice;        /* Must be the first member */
+        int16_t *buffer;            /* Ring buffer */
+        uint32_t mask;              /* Buffer size - 1 */
+        volatile uint32_t write;    /* Samples written, free running */
+        uint64_t position;          /* Q32 read position, free running */
+        bool started;               /* Set once the buffer was half full */
+        volatile bool ended;        /* No more input will be written */
+        int32_t fill_filtered;      /* Q8 low-passed buffer fill */
+        int32_t integral;           /* Integral of the fill error */
+        int32_t correction_ppm;     /* Current resampling correction */
+        uint32_t underruns;
+        uint32_t overruns;
+    } audio_stream_t;
+
+    void audio_stream_init(audio_stream_t *obj, int16_t *buffer, uint32_t size);
+    uint32_t audio_stream_write(audio_stream_t *obj, const int16_t *samples, uint32_t count);
+    void audio_stream_end(audio_stream_t *obj);
+    void audio_stream_get_stats(const audio_stream_t *obj, audio_stream_stats_t *stats);
+
+#endif
+
+/* [] END OF FILE */
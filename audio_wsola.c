@@ -0,0 +1,464 @@
+/*****************************************************************************
+* File Name: audio_wsola.c
+*
+* Description: This file contains the WSOLA (waveform similarity overlap-add)
+*              time-stretch voice. Each output hop overlap-adds a Hann-windowed
+*              input segment, picked within a fixed search range as the best
+*              match of the natural continuation of the previous segment, so
+*              the cost of a hop is the same for every block.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "audio_wsola.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Q16 speed and position */
+#define WSOLA_POS_FRAC_BITS     16u
+/* Q15 window */
+#define WSOLA_WINDOW_BITS       15u
+/* Zeros in front of the input, so the first window starts in silence and
+*  the search range never goes below the start of the input */
+#define WSOLA_PAD               (AUDIO_WSOLA_SEARCH + AUDIO_WSOLA_HOP)
+/* Scaling of the correlation and the energy before the comparison, so the
+*  squared correlation fits in 64 bits and the energy in 32 bits */
+#define WSOLA_CORR_SHIFT        6u
+#define WSOLA_ENERGY_SHIFT      (2u * WSOLA_CORR_SHIFT)
+
+#if ((AUDIO_WSOLA_HOP + AUDIO_WSOLA_CORR) > AUDIO_WSOLA_WINDOW)
+    #error "The natural continuation must lie inside the segment"
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t audio_wsola_render(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+static bool wsola_synthesize(audio_wsola_t *obj);
+static void wsola_load(audio_wsola_t *obj, uint32_t start);
+static uint32_t wsola_search(const audio_wsola_t *obj);
+static bool wsola_score_greater(int64_t corr_sq_a, uint32_t energy_a, int64_t corr_sq_b, uint32_t energy_b);
+static void wsola_mul_96(uint64_t a, uint32_t b, uint64_t *high, uint32_t *low);
+static int16_t wsola_pcm16(int32_t sample);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* First half of a periodic Hann window of AUDIO_WSOLA_WINDOW samples in Q15.
+*  Windows shifted by half their length sum to unity. */
+static const uint16_t wsola_window[AUDIO_WSOLA_HOP + 1u] = {
+        0,     5,    20,    44,    79,   123,   177,   241, /* 0-7 */
+      315,   398,   491,   593,   705,   827,   958,  1098, /* 8-15 */
+     1247,  1406,  1573,  1749,  1935,  2128,  2331,  2542, /* 16-23 */
+     2761,  2989,  3224,  3468,  3719,  3978,  4244,  4518, /* 24-31 */
+     4799,  5087,  5381,  5682,  5990,  6304,  6624,  6950, /* 32-39 */
+     7282,  7619,  7961,  8308,  8661,  9018,  9379,  9745, /* 40-47 */
+    10114, 10487, 10864, 11245, 11628, 12014, 12403, 12794, /* 48-55 */
+    13188, 13583, 13980, 14378, 14778, 15179, 15580, 15982, /* 56-63 */
+    16384, 16786, 17188, 17589, 17990, 18390, 18788, 19185, /* 64-71 */
+    19580, 19974, 20365, 20754, 21140, 21523, 21904, 22281, /* 72-79 */
+    22654, 23023, 23389, 23750, 24107, 24460, 24807, 25149, /* 80-87 */
+    25486, 25818, 26144, 26464, 26778, 27086, 27387, 27681, /* 88-95 */
+    27969, 28250, 28524, 28790, 29049, 29300, 29544, 29779, /* 96-103 */
+    30007, 30226, 30437, 30640, 30833, 31019, 31195, 31362, /* 104-111 */
+    31521, 31670, 31810, 31941, 32063, 32175, 32277, 32370, /* 112-119 */
+    32453, 32527, 32591, 32645, 32689, 32724, 32748, 32763, /* 120-127 */
+    32768 /* 128 */
+};
+
+/*******************************************************************************
+* Function Name: audio_wsola_init
+********************************************************************************
+* Summary:
+*  Prepare a voice to time-stretch a source voice from its current position.
+*  The source must not be in the mixer itself.
+*
+* Parameters:
+*  obj: WSOLA voice object
+*  source: fully initialized source voice
+*  speed: Q16 speed, AUDIO_WSOLA_SPEED_MIN to AUDIO_WSOLA_SPEED_MAX
+*
+*******************************************************************************/
+void audio_wsola_init(audio_wsola_t *obj, audio_voice_t *source, uint32_t speed)
+{
+    obj->voice.render  = audio_wsola_render;
+    obj->voice.gain    = source->gain;
+    obj->voice.pan     = source->pan;
+    obj->source        = source;
+    obj->analysis      = (uint64_t) AUDIO_WSOLA_SEARCH << WSOLA_POS_FRAC_BITS;
+    obj->input_start   = 0;
+    obj->input_fill    = WSOLA_PAD;
+    obj->input_end     = 0;
+    obj->source_ended  = false;
+    obj->has_reference = false;
+    obj->tail_flushed  = false;
+    obj->output_read   = AUDIO_WSOLA_HOP;
+
+    memset(obj->input, 0, sizeof(obj->input));
+    memset(obj->tail, 0, sizeof(obj->tail));
+
+    audio_wsola_set_speed(obj, speed);
+}
+
+/*******************************************************************************
+* Function Name: audio_wsola_set_speed
+********************************************************************************
+* Summary:
+*  Change the speed. Takes effect from the next hop.
+*
+* Parameters:
+*  obj: WSOLA voice object
+*  speed: Q16 speed, clamped to AUDIO_WSOLA_SPEED_MIN..AUDIO_WSOLA_SPEED_MAX
+*
+*******************************************************************************/
+void audio_wsola_set_speed(audio_wsola_t *obj, uint32_t speed)
+{
+    if (speed < AUDIO_WSOLA_SPEED_MIN)
+    {
+        speed = AUDIO_WSOLA_SPEED_MIN;
+    }
+    else if (speed > AUDIO_WSOLA_SPEED_MAX)
+    {
+        speed = AUDIO_WSOLA_SPEED_MAX;
+    }
+
+    obj->speed = speed;
+}
+
+/*******************************************************************************
+* Function Name: audio_wsola_render
+********************************************************************************
+* Summary:
+*  Render callback of the WSOLA voice. Returns the synthesized hops, making a
+*  new one whenever the previous one is used up.
+*
+*******************************************************************************/
+static uint32_t audio_wsola_render(audio_voice_t *voice, int32_t *dst, uint32_t frames)
+{
+    audio_wsola_t *obj = (audio_wsola_t *) voice;
+    uint32_t n = 0;
+
+    while (n < frames)
+    {
+        if (obj->output_read >= AUDIO_WSOLA_HOP)
+        {
+            if (!wsola_synthesize(obj))
+            {
+                break;
+            }
+            obj->output_read = 0;
+        }
+
+        uint32_t count = AUDIO_WSOLA_HOP - obj->output_read;
+        if (count > (frames - n))
+        {
+            count = frames - n;
+        }
+
+        memcpy(&dst[n], &obj->output[obj->output_read], count * sizeof(int32_t));
+        obj->output_read += count;
+        n += count;
+    }
+
+    return n;
+}
+
+/*******************************************************************************
+* Function Name: wsola_synthesize
+********************************************************************************
+* Summary:
+*  Make one output hop: search the segment that best continues the previous
+*  one, overlap-add its first half with the stored tail and keep its second
+*  half as the next tail. Once the input has been played, the last tail is
+*  returned as a final hop.
+*
+* Parameters:
+*  obj: WSOLA voice object
+*
+* Return:
+*  bool: false once the whole input has been played
+*
+*******************************************************************************/
+static bool wsola_synthesize(audio_wsola_t *obj)
+{
+    uint32_t base = (uint32_t) (obj->analysis >> WSOLA_POS_FRAC_BITS);
+
+    if (obj->source_ended && (base >= obj->input_end))
+    {
+        if (obj->tail_flushed)
+        {
+            return false;
+        }
+
+        memcpy(obj->output, obj->tail, sizeof(obj->output));
+        obj->tail_flushed = true;
+        return true;
+    }
+
+    wsola_load(obj, base - AUDIO_WSOLA_SEARCH);
+
+    uint32_t offset = obj->has_reference ? wsola_search(obj) : AUDIO_WSOLA_SEARCH;
+    const int32_t *segment = &obj->input[offset];
+
+    for (uint32_t n = 0; n < AUDIO_WSOLA_HOP; n++)
+    {
+        obj->output[n] = obj->tail[n] +
+            (int32_t) (((int64_t) segment[n] * wsola_window[n]) >> WSOLA_WINDOW_BITS);
+        obj->tail[n] =
+            (int32_t) (((int64_t) segment[AUDIO_WSOLA_HOP + n] * wsola_window[AUDIO_WSOLA_HOP - n]) >> WSOLA_WINDOW_BITS);
+    }
+
+    /* Reference for the next search: what would follow this segment
+    *  without any time-stretch, reduced to 16 bits */
+    for (uint32_t j = 0; j < AUDIO_WSOLA_CORR_TAPS; j++)
+    {
+        obj->reference[j] = wsola_pcm16(segment[AUDIO_WSOLA_HOP + 2u * j]);
+    }
+    obj->has_reference = true;
+
+    obj->analysis += (uint64_t) AUDIO_WSOLA_HOP * obj->speed;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: wsola_load
+********************************************************************************
+* Summary:
+*  Slide the input buffer to a new start position and fill it from the source.
+*  Zeros are used past the end of the source.
+*
+* Parameters:
+*  obj: WSOLA voice object
+*  start: input position of the first sample needed
+*
+*******************************************************************************/
+static void wsola_load(audio_wsola_t *obj, uint32_t start)
+{
+    uint32_t discard = start - obj->input_start;
+
+    if (discard >= obj->input_fill)
+    {
+        obj->input_fill = 0;
+    }
+    else if (discard > 0u)
+    {
+        obj->input_fill -= discard;
+        memmove(obj->input, &obj->input[discard], obj->input_fill * sizeof(int32_t));
+    }
+    obj->input_start = start;
+
+    while (obj->input_fill < AUDIO_WSOLA_INPUT)
+    {
+        uint32_t want = AUDIO_WSOLA_INPUT - obj->input_fill;
+        uint32_t count = 0;
+
+        if (want > AUDIO_BLOCK_FRAMES)
+        {
+            want = AUDIO_BLOCK_FRAMES;
+        }
+
+        if (!obj->source_ended)
+        {
+            count = obj->source->render(obj->source, &obj->input[obj->input_fill], want);
+            if (count < want)
+            {
+                obj->source_ended = true;
+                obj->input_end = obj->input_start + obj->input_fill + count;
+            }
+        }
+
+        memset(&obj->input[obj->input_fill + count], 0, (want - count) * sizeof(int32_t));
+        obj->input_fill += want;
+    }
+}
+
+/*******************************************************************************
+* Function Name: wsola_search
+********************************************************************************
+* Summary:
+*  Find the segment start within +/- AUDIO_WSOLA_SEARCH of the nominal
+*  position that correlates best with the reference. The correlation is
+*  normalized by the energy of the candidate, so loud candidates are not
+*  favored over similar ones: the score is corr * |corr| / energy, which
+*  orders the candidates like corr / sqrt(energy) without a square root.
+*  The scores are compared by cross-multiplying with the energies, so the
+*  search runs without a division and in a fixed time: it always covers the
+*  whole range, (2 * AUDIO_WSOLA_SEARCH + 1) * AUDIO_WSOLA_CORR_TAPS pairs of
+*  multiply-accumulates and one comparison per candidate per hop.
+*
+* Parameters:
+*  obj: WSOLA voice object
+*
+* Return:
+*  uint32_t: index of the segment start in the input buffer
+*
+*******************************************************************************/
+static uint32_t wsola_search(const audio_wsola_t *obj)
+{
+    uint32_t best_offset = AUDIO_WSOLA_SEARCH;
+    int64_t best_corr_sq = 0;
+    uint32_t best_energy = 0;
+
+    for (uint32_t offset = 0; offset <= (2u * AUDIO_WSOLA_SEARCH); offset++)
+    {
+        const int32_t *candidate = &obj->input[offset];
+        int64_t corr = 0;
+        int64_t energy = 0;
+
+        for (uint32_t j = 0; j < AUDIO_WSOLA_CORR_TAPS; j++)
+        {
+            int32_t sample = wsola_pcm16(candidate[2u * j]);
+
+            corr   += sample * (int32_t) obj->reference[j];
+            energy += sample * sample;
+        }
+
+        /* |corr| and energy are below 2^36: the scaled square stays below
+        *  2^60 and the scaled energy plus one below 2^25. A silent candidate
+        *  scores 0. */
+        corr   >>= WSOLA_CORR_SHIFT;
+        energy >>= WSOLA_ENERGY_SHIFT;
+        int64_t corr_sq = corr * ((corr < 0) ? -corr : corr);
+
+        if ((offset == 0u) ||
+            wsola_score_greater(corr_sq, (uint32_t) energy + 1u, best_corr_sq, best_energy))
+        {
+            best_corr_sq = corr_sq;
+            best_energy  = (uint32_t) energy + 1u;
+            best_offset  = offset;
+        }
+    }
+
+    return best_offset;
+}
+
+/*******************************************************************************
+* Function Name: wsola_score_greater
+********************************************************************************
+* Summary:
+*  Compare two candidate scores, corr_sq_a / energy_a > corr_sq_b / energy_b,
+*  as corr_sq_a * energy_b > corr_sq_b * energy_a. The products take up to
+*  85 bits, so their magnitudes are compared in 96 bits.
+*
+* Parameters:
+*  corr_sq_a: corr * |corr| of the first candidate, below 2^60 in magnitude
+*  energy_a: energy plus one of the first candidate, below 2^25
+*  corr_sq_b: corr * |corr| of the second candidate, below 2^60 in magnitude
+*  energy_b: energy plus one of the second candidate, below 2^25
+*
+* Return:
+*  bool: true if the first score is strictly greater
+*
+*******************************************************************************/
+static bool wsola_score_greater(int64_t corr_sq_a, uint32_t energy_a, int64_t corr_sq_b, uint32_t energy_b)
+{
+    uint64_t high_a;
+    uint64_t high_b;
+    uint32_t low_a;
+    uint32_t low_b;
+
+    /* The energies are positive: the signs of the scores decide first */
+    if ((corr_sq_a < 0) != (corr_sq_b < 0))
+    {
+        return (corr_sq_b < 0);
+    }
+
+    wsola_mul_96((uint64_t) ((corr_sq_a < 0) ? -corr_sq_a : corr_sq_a), energy_b, &high_a, &low_a);
+    wsola_mul_96((uint64_t) ((corr_sq_b < 0) ? -corr_sq_b : corr_sq_b), energy_a, &high_b, &low_b);
+
+    /* Of two negative scores, the smaller magnitude is the greater score */
+    if (corr_sq_a < 0)
+    {
+        return (high_a < high_b) || ((high_a == high_b) && (low_a < low_b));
+    }
+
+    return (high_a > high_b) || ((high_a == high_b) && (low_a > low_b));
+}
+
+/*******************************************************************************
+* Function Name: wsola_mul_96
+********************************************************************************
+* Summary:
+*  Multiply a 64-bit value by a 32-bit one into a 96-bit product, with two
+*  32 x 32 bit multiplies (UMULL on the Cortex-M4).
+*
+* Parameters:
+*  a: first factor
+*  b: second factor
+*  high: upper 64 bits of the product
+*  low: lower 32 bits of the product
+*
+*******************************************************************************/
+static void wsola_mul_96(uint64_t a, uint32_t b, uint64_t *high, uint32_t *low)
+{
+    uint64_t product_low = (uint64_t) (uint32_t) a * b;
+
+    *high = ((a >> 32) * b) + (product_low >> 32);
+    *low  = (uint32_t) product_low;
+}
+
+/*******************************************************************************
+* Function Name: wsola_pcm16
+********************************************************************************
+* Summary:
+*  Reduce a mix-scale sample to 16 bits for the similarity search, saturating
+*  the headroom above full scale.
+*
+* Parameters:
+*  sample: sample at 24-bit mix scale
+*
+* Return:
+*  int16_t: saturated 16-bit sample
+*
+*******************************************************************************/
+static int16_t wsola_pcm16(int32_t sample)
+{
+    sample >>= AUDIO_MIX_SHIFT_PCM16;
+
+    if (sample > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    else if (sample < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t) sample;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,91 @@
+/*****************************************************************************
+* File Name: audio_wsola.h
+*
+* Description: This file contains the definitions of the WSOLA time-stretch
+*              voice, which changes the playback speed of a source voice
+*              without changing its pitch.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_WSOLA_H
+    #define AUDIO_WSOLA_H
+
+    #include <stdint.h>
+
+    #include "audio_mixer.h"
+
+    /* Analysis window length; the synthesis hop is half of it */
+    #define AUDIO_WSOLA_WINDOW      256u
+    #define AUDIO_WSOLA_HOP         (AUDIO_WSOLA_WINDOW / 2u)
+    /* Similarity search range around the nominal position, in samples */
+    #define AUDIO_WSOLA_SEARCH      64u
+    /* Correlation length; every second sample is used */
+    #define AUDIO_WSOLA_CORR        128u
+    #define AUDIO_WSOLA_CORR_TAPS   (AUDIO_WSOLA_CORR / 2u)
+    /* Input span needed for one hop */
+    #define AUDIO_WSOLA_INPUT       (AUDIO_WSOLA_WINDOW + 2u * AUDIO_WSOLA_SEARCH)
+
+    /* Supported speed range, Q16 */
+    #define AUDIO_WSOLA_SPEED_MIN   ((uint32_t) (0.75 * 65536))
+    #define AUDIO_WSOLA_SPEED_MAX   ((uint32_t) (1.5 * 65536))
+    #define AUDIO_WSOLA_SPEED_UNITY (65536u)
+
+    /* Voice that time-stretches the output of a source voice. The source is
+    *  pulled in blocks, so streamed sources work as well as clips. The gain
+    *  and pan of the source are taken over by this voice at init. */
+    typedef struct
+    {
+        audio_voice_t voice;                        /* Must be the first member */
+        audio_voice_t *source;                      /* Voice being stretched */
+        uint32_t speed;                             /* Q16 speed, 1.0 = original */
+        uint64_t analysis;                          /* Q16 nominal input position */
+        uint32_t input_start;                       /* Input position of input[0] */
+        uint32_t input_fill;                        /* Valid samples in input[] */
+        uint32_t input_end;                         /* Input length once the source ended */
+        bool source_ended;
+        bool has_reference;
+        bool tail_flushed;                          /* Last tail returned after the input */
+        uint32_t output_read;                       /* Next sample of output[] to return */
+        int32_t input[AUDIO_WSOLA_INPUT];           /* Input around the analysis position */
+        int32_t tail[AUDIO_WSOLA_HOP];              /* Second half of the last segment */
+        int32_t output[AUDIO_WSOLA_HOP];            /* Last synthesized hop */
+        int16_t reference[AUDIO_WSOLA_CORR_TAPS];   /* Natural continuation of the last segment */
+    } audio_wsola_t;
+
+    void audio_wsola_init(audio_wsola_t *obj, audio_voice_t *source, uint32_t speed);
+    void audio_wsola_set_speed(audio_wsola_t *obj, uint32_t speed);
+
+#endif
+
+/* [] END OF FILE */
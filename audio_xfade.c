@@ -0,0 +1,232 @@
+/*****************************************************************************
+* File Name: audio_xfade.c
+*
+* Description: This file contains the crossfade voices. The outgoing and the
+*              incoming sources are faded in their own mixer slots, so each
+*              one keeps its own gain and pan.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+
+#include "audio_xfade.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Fractional bits of the curve position */
+#define XFADE_CURVE_FRAC_BITS   16u
+#define XFADE_CURVE_END         (AUDIO_POWER_CURVE_STEPS << XFADE_CURVE_FRAC_BITS)
+/* Q15 scale of the power curve */
+#define XFADE_Q15_BITS          15u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t audio_xfade_render_in(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+static uint32_t audio_xfade_render_out(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+static uint32_t xfade_apply(int32_t *dst, uint32_t count, uint32_t curve, uint32_t step, bool fade_in);
+static uint32_t xfade_curve(uint32_t position);
+
+/*******************************************************************************
+* Function Name: audio_xfade_start
+********************************************************************************
+* Summary:
+*  Start a crossfade from a voice that is playing to a new voice. The
+*  fade-out voice takes the slot of the outgoing voice in the mixer and the
+*  fade-in voice takes a free slot; at the end of the overlap, the incoming
+*  voice is swapped back in place of the fade-in voice. If the outgoing voice
+*  has already ended or the overlap is empty, the new voice is started
+*  directly; if no slot is free for the fade-in voice, the new voice replaces
+*  the outgoing one without a crossfade.
+*
+* Parameters:
+*  obj: crossfade object
+*  from: voice currently in the mixer
+*  to: fully initialized voice to switch to
+*  duration_ms: length of the overlap
+*  sample_rate_hz: output sample rate
+*
+* Return:
+*  bool: false if no mixer slot was available
+*
+*******************************************************************************/
+bool audio_xfade_start(audio_xfade_t *obj, audio_voice_t *from, audio_voice_t *to,
+                       uint32_t duration_ms, uint32_t sample_rate_hz)
+{
+    uint32_t length = (uint32_t) (((uint64_t) duration_ms * sample_rate_hz) / 1000u);
+
+    if (length == 0u)
+    {
+        return audio_mixer_replace(from, to) || audio_mixer_add(to);
+    }
+
+    obj->voice.render    = audio_xfade_render_in;
+    obj->voice.gain      = to->gain;
+    obj->voice.pan       = to->pan;
+    obj->fade_out.render = audio_xfade_render_out;
+    obj->fade_out.gain   = from->gain;
+    obj->fade_out.pan    = from->pan;
+    obj->from            = from;
+    obj->to              = to;
+    obj->curve_in        = 0u;
+    obj->curve_out       = 0u;
+    obj->curve_step      = (XFADE_CURVE_END + length - 1u) / length;
+
+    /* The fade-in voice starts silent, so a block rendered between the two
+    *  mixer updates only plays the outgoing voice */
+    if (!audio_mixer_add(&obj->voice))
+    {
+        return audio_mixer_replace(from, to);
+    }
+
+    (void) audio_mixer_replace(from, &obj->fade_out);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_xfade_render_in
+********************************************************************************
+* Summary:
+*  Render callback of the fade-in voice. It follows the gain and pan of the
+*  incoming voice and swaps the incoming voice in its slot once faded in.
+*
+*******************************************************************************/
+static uint32_t audio_xfade_render_in(audio_voice_t *voice, int32_t *dst, uint32_t frames)
+{
+    audio_xfade_t *obj = (audio_xfade_t *) voice;
+    uint32_t count = obj->to->render(obj->to, dst, frames);
+
+    voice->gain = obj->to->gain;
+    voice->pan  = obj->to->pan;
+    obj->curve_in = xfade_apply(dst, count, obj->curve_in, obj->curve_step, true);
+
+    if (obj->curve_in >= XFADE_CURVE_END)
+    {
+        (void) audio_mixer_replace(voice, obj->to);
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: audio_xfade_render_out
+********************************************************************************
+* Summary:
+*  Render callback of the fade-out voice. It follows the gain and pan of the
+*  outgoing voice and ends with the overlap, which frees its slot.
+*
+*******************************************************************************/
+static uint32_t audio_xfade_render_out(audio_voice_t *voice, int32_t *dst, uint32_t frames)
+{
+    audio_xfade_t *obj = (audio_xfade_t *) ((uint8_t *) voice - offsetof(audio_xfade_t, fade_out));
+    uint32_t overlap = (XFADE_CURVE_END - obj->curve_out + obj->curve_step - 1u) / obj->curve_step;
+    uint32_t count = 0;
+
+    overlap = (overlap < frames) ? overlap : frames;
+    if (overlap > 0u)
+    {
+        count = obj->from->render(obj->from, dst, overlap);
+    }
+
+    voice->gain = obj->from->gain;
+    voice->pan  = obj->from->pan;
+    obj->curve_out = xfade_apply(dst, count, obj->curve_out, obj->curve_step, false);
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: xfade_apply
+********************************************************************************
+* Summary:
+*  Apply the equal-power curve to a block of samples.
+*
+* Parameters:
+*  dst: samples at mix scale, faded in place
+*  count: number of samples
+*  curve: Q16 curve position of the first sample
+*  step: curve increment per sample
+*  fade_in: true to fade in, false to fade out
+*
+* Return:
+*  uint32_t: curve position after the block
+*
+*******************************************************************************/
+static uint32_t xfade_apply(int32_t *dst, uint32_t count, uint32_t curve, uint32_t step, bool fade_in)
+{
+    for (uint32_t n = 0; n < count; n++)
+    {
+        uint32_t gain = xfade_curve(fade_in ? (XFADE_CURVE_END - curve) : curve);
+
+        dst[n] = audio_gain_apply(dst[n], (AUDIO_GAIN_UNITY * gain) >> XFADE_Q15_BITS);
+
+        curve = (curve < (XFADE_CURVE_END - step)) ? (curve + step) : XFADE_CURVE_END;
+    }
+
+    return curve;
+}
+
+/*******************************************************************************
+* Function Name: xfade_curve
+********************************************************************************
+* Summary:
+*  Interpolate the power curve.
+*
+* Parameters:
+*  position: Q16 position, 0 to AUDIO_POWER_CURVE_STEPS
+*
+* Return:
+*  uint32_t: Q15 gain, cos(position * pi / 256)
+*
+*******************************************************************************/
+static uint32_t xfade_curve(uint32_t position)
+{
+    uint32_t index = position >> XFADE_CURVE_FRAC_BITS;
+
+    if (index >= AUDIO_POWER_CURVE_STEPS)
+    {
+        return audio_power_curve[AUDIO_POWER_CURVE_STEPS];
+    }
+
+    uint32_t frac = (position >> 8u) & 0xFFu;
+    uint32_t a = audio_power_curve[index];
+    uint32_t b = audio_power_curve[index + 1u];
+
+    /* The curve is decreasing */
+    return a - (((a - b) * frac) >> 8u);
+}
+
+/* [] END OF FILE */
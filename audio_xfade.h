@@ -0,0 +1,68 @@
+/*****************************************************************************
+* File Name: audio_xfade.h
+*
+* Description: This file contains the definitions of the crossfade voice, which
+*              switches from one voice to another with equal-power curves.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef AUDIO_XFADE_H
+    #define AUDIO_XFADE_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "audio_mixer.h"
+
+    /* Crossfade of two voices. During the overlap, the fade-out voice plays
+    *  the outgoing source in its mixer slot and the fade-in voice plays the
+    *  incoming one in another slot, each with the gain and pan of its source;
+    *  the incoming source then takes back the slot of the fade-in voice. */
+    typedef struct
+    {
+        audio_voice_t voice;    /* Fade-in voice, must be the first member */
+        audio_voice_t fade_out; /* Fade-out voice */
+        audio_voice_t *from;    /* Outgoing source */
+        audio_voice_t *to;      /* Incoming source */
+        uint32_t curve_in;      /* Q16 position of the fade-in on the power curve */
+        uint32_t curve_out;     /* Q16 position of the fade-out on the power curve */
+        uint32_t curve_step;    /* Curve increment per sample */
+    } audio_xfade_t;
+
+    bool audio_xfade_start(audio_xfade_t *obj, audio_voice_t *from, audio_voice_t *to,
+                           uint32_t duration_ms, uint32_t sample_rate_hz);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,228 @@
+/*****************************************************************************
+* File Name: button.c
+*
+* Description: This file contains the debounce state machine of the user
+*              button. An edge interrupt sets an alarm of the low-power
+*              timebase and the pin is sampled once it has been stable for
+*              the debounce time, so the CPU never waits.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cybsp.h"
+
+#include "button.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void button_gpio_handler(void *arg, cyhal_gpio_event_t event);
+static void button_timer_handler(void);
+static void button_arm_long_press(uint32_t now);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+typedef enum
+{
+    BUTTON_STATE_RELEASED,
+    BUTTON_STATE_PRESS_PENDING,     /* Waiting for the pin to settle low */
+    BUTTON_STATE_PRESSED,           /* Waiting for the long press time */
+    BUTTON_STATE_LONG_PRESSED,
+    BUTTON_STATE_RELEASE_PENDING,   /* Waiting for the pin to settle high */
+} button_state_t;
+
+static cyhal_gpio_t button_pin;
+static cyhal_gpio_callback_data_t button_callback_data;
+static timebase_alarm_t button_alarm;
+
+static button_state_t button_state;
+/* State to return to if a release turns out to be a bounce */
+static button_state_t button_held_state;
+/* Time of the first edge of the transition being debounced */
+static uint32_t button_edge_time;
+/* Time of the accepted press */
+static uint32_t button_press_time;
+
+/*******************************************************************************
+* Function Name: button_init
+********************************************************************************
+* Summary:
+*  Initialize the pin and the edge interrupt. The timebase and the
+*  scheduler must be initialized. The button events are posted to the
+*  scheduler as SCHEDULER_EVENT_BUTTON.
+*
+* Parameters:
+*  pin: button pin, active low
+*
+*******************************************************************************/
+void button_init(cyhal_gpio_t pin)
+{
+    button_pin   = pin;
+    button_state = BUTTON_STATE_RELEASED;
+
+    cyhal_gpio_init(pin, CYHAL_GPIO_DIR_INPUT, CYHAL_GPIO_DRIVE_PULLUP, CYBSP_BTN_OFF);
+    button_callback_data.callback     = button_gpio_handler;
+    button_callback_data.callback_arg = NULL;
+    cyhal_gpio_register_callback(pin, &button_callback_data);
+    /* Both edges wake-up the CPU, also from Deep Sleep */
+    cyhal_gpio_enable_event(pin, CYHAL_GPIO_IRQ_BOTH, CYHAL_ISR_PRIORITY_DEFAULT, true);
+}
+
+/*******************************************************************************
+* Function Name: button_gpio_handler
+********************************************************************************
+* Summary:
+*  Edge interrupt. Starts or restarts the debounce time.
+*
+*******************************************************************************/
+static void button_gpio_handler(void *arg, cyhal_gpio_event_t event)
+{
+    uint32_t now = timebase_now();
+
+    (void) arg;
+    (void) event;
+
+    switch (button_state)
+    {
+        case BUTTON_STATE_RELEASED:
+            button_edge_time = now;
+            button_state     = BUTTON_STATE_PRESS_PENDING;
+            break;
+
+        case BUTTON_STATE_PRESSED:
+        case BUTTON_STATE_LONG_PRESSED:
+            button_edge_time  = now;
+            button_held_state = button_state;
+            button_state      = BUTTON_STATE_RELEASE_PENDING;
+            break;
+
+        default:
+            /* Bounce: wait for the pin to be stable again */
+            break;
+    }
+
+    timebase_set_alarm(&button_alarm, timebase_ms_to_ticks(BUTTON_DEBOUNCE_MS), button_timer_handler);
+}
+
+/*******************************************************************************
+* Function Name: button_timer_handler
+********************************************************************************
+* Summary:
+*  Timebase alarm. Samples the settled pin, or detects a long press.
+*
+*******************************************************************************/
+static void button_timer_handler(void)
+{
+    uint32_t now = timebase_now();
+    bool pressed = (cyhal_gpio_read(button_pin) == CYBSP_BTN_PRESSED);
+
+    switch (button_state)
+    {
+        case BUTTON_STATE_PRESS_PENDING:
+            if (pressed)
+            {
+                button_press_time = button_edge_time;
+                trace_log(TRACE_BUTTON, BUTTON_EVENT_PRESS, button_edge_time);
+                scheduler_post(SCHEDULER_EVENT_BUTTON, BUTTON_EVENT_PRESS, button_edge_time);
+                button_state = BUTTON_STATE_PRESSED;
+                button_arm_long_press(now);
+            }
+            else
+            {
+                button_state = BUTTON_STATE_RELEASED;
+            }
+            break;
+
+        case BUTTON_STATE_PRESSED:
+            if (pressed)
+            {
+                button_arm_long_press(now);
+            }
+            break;
+
+        case BUTTON_STATE_RELEASE_PENDING:
+            if (!pressed)
+            {
+                trace_log(TRACE_BUTTON, BUTTON_EVENT_RELEASE, button_edge_time);
+                scheduler_post(SCHEDULER_EVENT_BUTTON, BUTTON_EVENT_RELEASE, button_edge_time);
+                button_state = BUTTON_STATE_RELEASED;
+            }
+            else
+            {
+                button_state = button_held_state;
+                if (button_state == BUTTON_STATE_PRESSED)
+                {
+                    button_arm_long_press(now);
+                }
+            }
+            break;
+
+        default:
+            /* Match of a stale delay */
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: button_arm_long_press
+********************************************************************************
+* Summary:
+*  Post the long press if the button has been held long enough, otherwise
+*  wake-up again when it will have been.
+*
+* Parameters:
+*  now: current time in timebase ticks
+*
+*******************************************************************************/
+static void button_arm_long_press(uint32_t now)
+{
+    uint32_t held = now - button_press_time;
+    uint32_t long_press = timebase_ms_to_ticks(BUTTON_LONG_PRESS_MS);
+
+    if (held >= long_press)
+    {
+        trace_log(TRACE_BUTTON, BUTTON_EVENT_LONG_PRESS, now);
+        scheduler_post(SCHEDULER_EVENT_BUTTON, BUTTON_EVENT_LONG_PRESS, now);
+        button_state = BUTTON_STATE_LONG_PRESSED;
+    }
+    else
+    {
+        timebase_set_alarm(&button_alarm, long_press - held, button_timer_handler);
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,354 @@
+/*****************************************************************************
+* File Name: clock_plan.c
+*
+* Description: This file contains the audio clock planner. For a sample rate it
+*              searches the PLL, HFCLK1, I2S and MCLK PWM divider combinations
+*              and keeps the one with the lowest clock error.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+
+#include "clock_plan.h"
+#include "audio_format.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* PLL limits */
+#define PLL_P_MIN               22u
+#define PLL_P_MAX               112u
+#define PLL_Q_MIN               1u
+#define PLL_Q_MAX               20u
+#define PLL_OUT_DIV_MIN         2u
+#define PLL_OUT_DIV_MAX         16u
+#define PLL_PFD_MIN_HZ          4000000u
+#define PLL_VCO_MIN_HZ          170000000u
+#define PLL_VCO_MAX_HZ          400000000u
+/* The VCO runs in low-frequency mode below this frequency */
+#define PLL_VCO_LF_MAX_HZ       200000000u
+/* Lowest PLL output searched: the PLL range or the CPU floor */
+#define PLL_FLOOR_HZ            ((CLOCK_PLAN_CPU_MIN_HZ > CLOCK_PLAN_PLL_MIN_HZ) ? \
+                                 CLOCK_PLAN_CPU_MIN_HZ : CLOCK_PLAN_PLL_MIN_HZ)
+/* HFCLK1 dividers */
+#define HFCLK1_DIV_COUNT        4u
+/* I2S interface clock runs at 8x SCK, with a 1 to 64 divider */
+#define I2S_OVERSAMPLE          8u
+#define I2S_DIV_MIN             1u
+#define I2S_DIV_MAX             64u
+/* Minimum PWM period for a 50% duty cycle */
+#define PWM_DIV_MIN             2u
+#define PWM_DIV_MAX             65535u
+/* Bits per I2S frame */
+#define I2S_FRAME_BITS          (AUDIO_CHANNEL_LENGTH * AUDIO_CHANNELS)
+#define PPM                     1000000
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint64_t div_round(uint64_t num, uint64_t den);
+static int32_t error_ppm(uint64_t num, uint64_t den);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Plans solved with the default CPU floor (the whole PLL range), checked by
+*  the host unit test test/test_clock_plan.c:
+*
+*    rate      PLL         error       with CLOCK_PLAN_CPU_MIN_HZ = 90 MHz
+*    8000      86.0 MHz    -186 ppm    90 MHz, -1243 ppm
+*    16000     57.3 MHz    -186 ppm    90 MHz, -1243 ppm
+*    32000     49.1 MHz    -186 ppm    98 MHz, -3092 ppm
+*    44100     none        -3508 ppm   90 MHz, -3508 ppm
+*    48000     49.1 MHz    -186 ppm    98 MHz, -3092 ppm
+*
+*  44.1 kHz has no close plan at any PLL frequency: the IMO reaches no
+*  multiple of 11.2896 MHz within 3500 ppm, so the rate is rejected by
+*  CLOCK_PLAN_MAX_ERROR_PPM. Convert 44.1 kHz clips to 48 kHz. */
+const uint32_t clock_plan_rates[CLOCK_PLAN_RATE_COUNT] = {
+    8000u, 16000u, 32000u, 44100u, 48000u
+};
+
+static const uint8_t hfclk1_dividers[HFCLK1_DIV_COUNT] = { 1u, 2u, 4u, 8u };
+
+/* Plans of clock_plan_rates[], filled by clock_plan_init() */
+static clock_plan_t clock_plans[CLOCK_PLAN_RATE_COUNT];
+static bool clock_plans_valid[CLOCK_PLAN_RATE_COUNT];
+
+/*******************************************************************************
+* Function Name: clock_plan_init
+********************************************************************************
+* Summary:
+*  Solve the plans of all the supported sample rates, so switching rates
+*  later only programs precomputed values.
+*
+*******************************************************************************/
+void clock_plan_init(void)
+{
+    for (uint32_t i = 0; i < CLOCK_PLAN_RATE_COUNT; i++)
+    {
+        clock_plans_valid[i] = clock_plan_solve(clock_plan_rates[i], &clock_plans[i]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: clock_plan_get
+********************************************************************************
+* Summary:
+*  Get the precomputed plan of a sample rate.
+*
+* Parameters:
+*  sample_rate_hz: one of clock_plan_rates[]
+*
+* Return:
+*  const clock_plan_t*: plan, or NULL if the rate is not supported or has no
+*  feasible plan
+*
+*******************************************************************************/
+const clock_plan_t *clock_plan_get(uint32_t sample_rate_hz)
+{
+    for (uint32_t i = 0; i < CLOCK_PLAN_RATE_COUNT; i++)
+    {
+        if ((clock_plan_rates[i] == sample_rate_hz) && clock_plans_valid[i])
+        {
+            return &clock_plans[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: clock_plan_frame_peri_cycles
+********************************************************************************
+* Summary:
+*  Get the exact length of an I2S frame in CLK_PERI cycles. Both clocks come
+*  from the PLL, so the ratio does not depend on the PLL frequency.
+*
+* Parameters:
+*  plan: clock plan in use
+*
+* Return:
+*  uint32_t: CLK_PERI cycles per frame
+*
+*******************************************************************************/
+uint32_t clock_plan_frame_peri_cycles(const clock_plan_t *plan)
+{
+    return ((uint32_t) plan->hfclk1_div * plan->i2s_div * I2S_OVERSAMPLE * I2S_FRAME_BITS) /
+           CLOCK_PLAN_PERI_DIV;
+}
+
+/*******************************************************************************
+* Function Name: clock_plan_solve
+********************************************************************************
+* Summary:
+*  Search all the feasible PLL settings from CLOCK_PLAN_CPU_MIN_HZ up, and the
+*  HFCLK1 dividers. For each, the I2S and PWM dividers are the nearest
+*  integers, so the search is exhaustive. The plan with the lowest worst-case
+*  error (sample rate or MCLK) wins; ties go to the fastest PLL, then to the
+*  largest HFCLK1 divider.
+*
+*  The MCLK frequency of the plan is truncated, like the PWM period computed
+*  from it by the HAL, so the PWM divides CLK_PERI by exactly pwm_div.
+*
+* Parameters:
+*  sample_rate_hz: target sample rate
+*  plan: filled with the best plan
+*
+* Return:
+*  bool: false if no combination is feasible or if the best one is off by
+*  more than CLOCK_PLAN_MAX_ERROR_PPM
+*
+*******************************************************************************/
+bool clock_plan_solve(uint32_t sample_rate_hz, clock_plan_t *plan)
+{
+    bool found = false;
+    uint32_t best_cost = UINT32_MAX;
+
+    for (uint32_t q = PLL_Q_MIN; q <= PLL_Q_MAX; q++)
+    {
+        if ((CLOCK_PLAN_REF_HZ / q) < PLL_PFD_MIN_HZ)
+        {
+            break;
+        }
+
+        for (uint32_t p = PLL_P_MIN; p <= PLL_P_MAX; p++)
+        {
+            uint64_t vco_num = (uint64_t) CLOCK_PLAN_REF_HZ * p;
+            if (((vco_num / q) < PLL_VCO_MIN_HZ) || ((vco_num / q) > PLL_VCO_MAX_HZ))
+            {
+                continue;
+            }
+
+            for (uint32_t od = PLL_OUT_DIV_MIN; od <= PLL_OUT_DIV_MAX; od++)
+            {
+                /* PLL output is vco_num / (q * od) */
+                uint64_t pll_den = (uint64_t) q * od;
+                uint32_t pll_hz = (uint32_t) div_round(vco_num, pll_den);
+                if ((pll_hz < PLL_FLOOR_HZ) || (pll_hz > CLOCK_PLAN_PLL_MAX_HZ))
+                {
+                    continue;
+                }
+
+                /* MCLK: CLK_PERI / pwm_div */
+                uint64_t mclk_den = pll_den * CLOCK_PLAN_PERI_DIV * CLOCK_PLAN_MCLK_RATIO * sample_rate_hz;
+                uint64_t pwm_div = div_round(vco_num, mclk_den);
+                if ((pwm_div < PWM_DIV_MIN) || (pwm_div > PWM_DIV_MAX))
+                {
+                    continue;
+                }
+                int32_t mclk_ppm = error_ppm(vco_num, mclk_den * pwm_div);
+
+                for (uint32_t h = 0; h < HFCLK1_DIV_COUNT; h++)
+                {
+                    /* Sample rate: HFCLK1 / (i2s_div * 8 * frame bits) */
+                    uint64_t rate_den = pll_den * hfclk1_dividers[h] * I2S_OVERSAMPLE *
+                                        I2S_FRAME_BITS * sample_rate_hz;
+                    uint64_t i2s_div = div_round(vco_num, rate_den);
+                    if ((i2s_div < I2S_DIV_MIN) || (i2s_div > I2S_DIV_MAX))
+                    {
+                        continue;
+                    }
+                    int32_t rate_ppm = error_ppm(vco_num, rate_den * i2s_div);
+
+                    uint32_t cost = (uint32_t) ((rate_ppm < 0) ? -rate_ppm : rate_ppm);
+                    uint32_t mclk_cost = (uint32_t) ((mclk_ppm < 0) ? -mclk_ppm : mclk_ppm);
+                    if (mclk_cost > cost)
+                    {
+                        cost = mclk_cost;
+                    }
+
+                    bool better = (cost < best_cost) ||
+                                  ((cost == best_cost) && (pll_hz > plan->pll_hz)) ||
+                                  ((cost == best_cost) && (pll_hz == plan->pll_hz) &&
+                                   (hfclk1_dividers[h] > plan->hfclk1_div));
+                    if (!found || better)
+                    {
+                        found = true;
+                        best_cost = cost;
+
+                        plan->sample_rate_hz = sample_rate_hz;
+                        plan->pll_hz         = pll_hz;
+                        plan->pll_p          = (uint8_t) p;
+                        plan->pll_q          = (uint8_t) q;
+                        plan->pll_out_div    = (uint8_t) od;
+                        plan->hfclk1_div     = hfclk1_dividers[h];
+                        plan->i2s_div        = (uint8_t) i2s_div;
+                        plan->pwm_div        = (uint16_t) pwm_div;
+                        plan->mclk_hz        = (uint32_t) (vco_num / (pll_den * CLOCK_PLAN_PERI_DIV * pwm_div));
+                        plan->rate_error_ppm = rate_ppm;
+                        plan->mclk_error_ppm = mclk_ppm;
+                    }
+                }
+            }
+        }
+    }
+
+    return found && (best_cost <= (uint32_t) CLOCK_PLAN_MAX_ERROR_PPM);
+}
+
+/*******************************************************************************
+* Function Name: clock_plan_set_pll
+********************************************************************************
+* Summary:
+*  Program the PLL with the dividers of a plan. cyhal_clock_set_frequency()
+*  would search its own dividers for the rounded pll_hz, which are not always
+*  the ones the plan was solved for. The PLL output falls back to its
+*  reference (IMO) until it locks again, so HFCLK0 and HFCLK1 keep running.
+*  Once locked, SystemCoreClock and the delay calibration are updated; the
+*  CLK_PERI users are left to the caller.
+*
+* Parameters:
+*  plan: clock plan to apply
+*
+* Return:
+*  bool: false if the PLL could not be configured or did not lock
+*
+*******************************************************************************/
+bool clock_plan_set_pll(const clock_plan_t *plan)
+{
+    uint32_t vco_hz = (uint32_t) (((uint64_t) CLOCK_PLAN_REF_HZ * plan->pll_p) / plan->pll_q);
+    cy_stc_pll_manual_config_t config =
+    {
+        .feedbackDiv  = plan->pll_p,
+        .referenceDiv = plan->pll_q,
+        .outputDiv    = plan->pll_out_div,
+        .lfMode       = (vco_hz < PLL_VCO_LF_MAX_HZ),
+        .outputMode   = CY_SYSCLK_FLLPLL_OUTPUT_AUTO,
+    };
+
+    Cy_SysClk_PllDisable(CLOCK_PLAN_PLL_PATH);
+
+    if (Cy_SysClk_PllManualConfigure(CLOCK_PLAN_PLL_PATH, &config) != CY_SYSCLK_SUCCESS)
+    {
+        return false;
+    }
+
+    if (Cy_SysClk_PllEnable(CLOCK_PLAN_PLL_PATH, CLOCK_PLAN_PLL_LOCK_US) != CY_SYSCLK_SUCCESS)
+    {
+        return false;
+    }
+
+    SystemCoreClockUpdate();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: div_round
+********************************************************************************
+* Summary:
+*  Integer division rounded to the nearest.
+*
+*******************************************************************************/
+static uint64_t div_round(uint64_t num, uint64_t den)
+{
+    return (num + (den / 2u)) / den;
+}
+
+/*******************************************************************************
+* Function Name: error_ppm
+********************************************************************************
+* Summary:
+*  Relative error of the ratio num / den against 1, in ppm.
+*
+*******************************************************************************/
+static int32_t error_ppm(uint64_t num, uint64_t den)
+{
+    int64_t scaled = (int64_t) div_round(num * (uint64_t) PPM, den);
+
+    return (int32_t) (scaled - PPM);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,102 @@
+/*****************************************************************************
+* File Name: clock_plan.h
+*
+* Description: This file contains the definitions of the audio clock planner,
+*              which picks the PLL and divider settings for each sample rate.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CLOCK_PLAN_H
+    #define CLOCK_PLAN_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "cyhal.h"
+
+    /* PLL reference (IMO) */
+    #define CLOCK_PLAN_REF_HZ           8000000u
+    /* PLL output range accepted for the system clock (HFCLK0) */
+    #define CLOCK_PLAN_PLL_MIN_HZ       48000000u
+    #define CLOCK_PLAN_PLL_MAX_HZ       100000000u
+    /* Floor of the PLL output, which is also the CPU clock. By default the
+    *  whole PLL range is searched, for the most exact plans (-186 ppm), with
+    *  the CPU at 49 to 86 MHz. Raising the floor to 90 MHz keeps the CPU near
+    *  98 MHz at the cost of -1243 to -3092 ppm, which also needs a larger
+    *  CLOCK_PLAN_MAX_ERROR_PPM (see the table in clock_plan.c). */
+    #ifndef CLOCK_PLAN_CPU_MIN_HZ
+        #define CLOCK_PLAN_CPU_MIN_HZ   CLOCK_PLAN_PLL_MIN_HZ
+    #endif
+    /* Plans with a larger sample rate or MCLK error are rejected */
+    #ifndef CLOCK_PLAN_MAX_ERROR_PPM
+        #define CLOCK_PLAN_MAX_ERROR_PPM    1000
+    #endif
+    /* Clock path of PLL[0] and its lock timeout */
+    #define CLOCK_PLAN_PLL_PATH         1u
+    #define CLOCK_PLAN_PLL_LOCK_US      10000u
+    /* CLK_PERI divider set by the BSP; it feeds the MCLK PWM */
+    #define CLOCK_PLAN_PERI_DIV         2u
+    /* MCLK to sample rate ratio expected by the codec */
+    #define CLOCK_PLAN_MCLK_RATIO       256u
+    /* Number of supported sample rates */
+    #define CLOCK_PLAN_RATE_COUNT       5u
+
+    /* Clock settings for one sample rate */
+    typedef struct
+    {
+        uint32_t sample_rate_hz;    /* Target sample rate */
+        uint32_t pll_hz;            /* PLL output, rounded to 1 Hz */
+        uint8_t pll_p;              /* PLL feedback divider */
+        uint8_t pll_q;              /* PLL reference divider */
+        uint8_t pll_out_div;        /* PLL output divider */
+        uint8_t hfclk1_div;         /* Audio subsystem clock (HFCLK1) divider */
+        uint8_t i2s_div;            /* I2S interface clock divider */
+        uint16_t pwm_div;           /* CLK_PERI cycles per MCLK cycle */
+        uint32_t mclk_hz;           /* MCLK PWM frequency, truncated to 1 Hz */
+        int32_t rate_error_ppm;     /* Sample rate error */
+        int32_t mclk_error_ppm;     /* MCLK error against CLOCK_PLAN_MCLK_RATIO */
+    } clock_plan_t;
+
+    /* Sample rates planned by clock_plan_init() */
+    extern const uint32_t clock_plan_rates[CLOCK_PLAN_RATE_COUNT];
+
+    void clock_plan_init(void);
+    const clock_plan_t *clock_plan_get(uint32_t sample_rate_hz);
+    bool clock_plan_solve(uint32_t sample_rate_hz, clock_plan_t *plan);
+    uint32_t clock_plan_frame_peri_cycles(const clock_plan_t *plan);
+    bool clock_plan_set_pll(const clock_plan_t *plan);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/*****************************************************************************
+* File Name: codec.h
+*
+* Description: This file contains the codec driver interface. The driver is
+*              selected at build time in the Makefile (CODEC=<driver>), so the calls
+*              are resolved by the linker without any dispatch.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CODEC_H
+    #define CODEC_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "cyhal.h"
+
+    /* Called from an ISR when a power-up or a step of a sample rate switch
+    *  has completed, with false if its I2C writes failed: the DAC is then
+    *  left muted. The calls return at once. The driver runs one such
+    *  sequence at a time. */
+    typedef void (*codec_done_t)(bool success);
+
+    /* Drivers:
+    *  CODEC_AK4954A -- AK4954A configured over I2C (CY8CKIT-028-TFT)
+    *  CODEC_PASSIVE -- DAC without a control interface, such as the Pmod
+    *                   I2S2; the calls compile to nothing and the
+    *                   sequences complete at once
+    *  CODEC_MOCK    -- host simulator only: records the calls for the tests
+    *                   (host/codec_mock.c) */
+    #if defined(CODEC_PASSIVE)
+        #include "codec_passive.h"
+    #elif defined(CODEC_MOCK)
+        #include "codec_mock.h"
+    #elif defined(CODEC_AK4954A)
+        /* Soft mute transition (816/fs) at the lowest sample rate, 8 kHz */
+        #define CODEC_MUTE_MS           103u        /* in ms */
+        /* Typical idle currents with the DAC output powered and powered down
+        *  (VCOM kept); adjust them for the board */
+        #define CODEC_IDLE_ON_UA        1400u       /* in uA */
+        #define CODEC_IDLE_OFF_UA       10u         /* in uA */
+
+        cy_rslt_t codec_init(void);
+        bool codec_supports(uint32_t sample_rate_hz, uint32_t word_length);
+        void codec_activate(codec_done_t done);
+        void codec_power_down(void);
+        void codec_set_volume(uint8_t volume);
+        void codec_mute(bool mute);
+        void codec_rate_begin(codec_done_t done);
+        void codec_rate_end(uint32_t sample_rate_hz, codec_done_t done);
+        bool codec_is_idle(void);
+    #else
+        #error "Select the codec driver in the Makefile with CODEC=AK4954A or CODEC=PASSIVE (CODEC=MOCK on the host)"
+    #endif
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,427 @@
+/*****************************************************************************
+* File Name: codec_ak4954a.c
+*
+* Description: This file contains the codec driver of the AK4954A. The codec is
+*              configured by the AK4954A library at startup; then the registers are
+*              accessed through the register cache and written by the asynchronous
+*              command queue.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "codec.h"
+
+#ifdef CODEC_AK4954A
+
+#include "cybsp.h"
+#include "mtb_ak4954a.h"
+
+#include "ak4954a_regs.h"
+#include "codec_ctrl.h"
+#include "timebase.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Master I2C frequency */
+#define AK4954A_I2C_HZ          400000u     /* in Hz */
+/* AK4954A Mode Control 1 audio interface format (DIF1-0) */
+#define AK4954A_DIF_MASK        0x03u
+#define AK4954A_DIF_I2S         0x03u       /* I2S compatible, up to 24 bits */
+/* AK4954A Mode Control 2: sampling frequency (FS3-0), MCLK = 256fs (CM1-0 = 0) */
+#define AK4954A_FS_MASK         0xCFu
+/* Time for the codec to settle on the new MCLK before unmuting */
+#define AK4954A_SETTLE_MS       1u          /* in ms */
+/* Time for the headphone amplifier outputs to settle after power-up */
+#define AK4954A_POWER_UP_MS     30u         /* in ms */
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint8_t codec_fs(uint32_t sample_rate_hz);
+static void codec_on_powered(codec_ctrl_op_t op, bool success, void *arg);
+static void codec_on_power_settled(void);
+static void codec_on_muted(codec_ctrl_op_t op, bool success, void *arg);
+static void codec_on_rate_written(codec_ctrl_op_t op, bool success, void *arg);
+static void codec_on_rate_settled(void);
+static void codec_complete(bool success);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_i2c_t codec_i2c;
+
+static const cyhal_i2c_cfg_t codec_i2c_config = {
+    .is_slave        = false,
+    .address         = 0,
+    .frequencyhal_hz = AK4954A_I2C_HZ
+};
+
+/* Sequence in progress: completion handler and settling delay */
+static codec_done_t codec_done;
+static timebase_alarm_t codec_alarm;
+
+/*******************************************************************************
+* Function Name: codec_init
+********************************************************************************
+* Summary:
+*  Initialize the I2C master, configure the codec for the I2S format and
+*  enable it. The MCLK must be running.
+*
+* Return:
+*  cy_rslt_t: result of the codec configuration
+*
+*******************************************************************************/
+cy_rslt_t codec_init(void)
+{
+    cy_rslt_t result;
+
+    cyhal_i2c_init(&codec_i2c, CYBSP_I2C_SDA, CYBSP_I2C_SCL, NULL);
+    cyhal_i2c_configure(&codec_i2c, &codec_i2c_config);
+
+    result = mtb_ak4954a_init(&codec_i2c);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    /* Select the I2S format. The codec takes the word MSB first from the
+    *  32-bit slot, so the same setting covers 16-, 24- and 32-bit words */
+    mtb_ak4954a_update_byte(AK4954A_REG_MODE_CTRL1, AK4954A_DIF_MASK, AK4954A_DIF_I2S);
+    mtb_ak4954a_activate();
+    mtb_ak4954a_adjust_volume(AK4954A_HP_VOLUME_DEFAULT);
+
+    /* From now on the registers are accessed through the cache, and written
+    *  by the asynchronous command queue */
+    result = ak4954a_regs_init(&codec_i2c);
+    codec_ctrl_init();
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: codec_supports
+********************************************************************************
+* Summary:
+*  Check if the codec can play a format (EXT slave mode, MCLK = 256fs, I2S
+*  compatible format).
+*
+* Parameters:
+*  sample_rate_hz: sample rate
+*  word_length: I2S word length in bits
+*
+* Return:
+*  bool: true if the format is supported
+*
+*******************************************************************************/
+bool codec_supports(uint32_t sample_rate_hz, uint32_t word_length)
+{
+    (void) word_length;
+
+    switch (sample_rate_hz)
+    {
+        case 8000u:
+        case 16000u:
+        case 32000u:
+        case 44100u:
+        case 48000u:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: codec_activate
+********************************************************************************
+* Summary:
+*  Power the DAC output up: the DAC first, then the headphone amplifiers.
+*  The DAC stays muted as it was powered down. Returns at once: done is
+*  called once the amplifier outputs have settled, so the caller can unmute
+*  without a pop, or with false as soon as the power-up writes fail.
+*
+* Parameters:
+*  done: called from the timebase or I2C ISR at the end, can be NULL
+*
+*******************************************************************************/
+void codec_activate(codec_done_t done)
+{
+    codec_done = done;
+    if (!codec_ctrl_submit(CODEC_CTRL_POWER, 1u, codec_on_powered, NULL))
+    {
+        codec_on_powered(CODEC_CTRL_POWER, false, NULL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: codec_power_down
+********************************************************************************
+* Summary:
+*  Power the DAC output down: the headphone amplifiers first, then the DAC.
+*  Mute the DAC CODEC_MUTE_MS before, so the output is silent when the
+*  amplifiers turn off. The registers are retained. Returns at once; can be
+*  called from an ISR.
+*
+*******************************************************************************/
+void codec_power_down(void)
+{
+    codec_ctrl_submit(CODEC_CTRL_POWER, 0u, NULL, NULL);
+}
+
+/*******************************************************************************
+* Function Name: codec_set_volume
+********************************************************************************
+* Summary:
+*  Set the digital volume of both channels. Returns at once.
+*
+* Parameters:
+*  volume: AK4954A digital volume code
+*
+*******************************************************************************/
+void codec_set_volume(uint8_t volume)
+{
+    codec_ctrl_submit(CODEC_CTRL_VOLUME, volume, NULL, NULL);
+}
+
+/*******************************************************************************
+* Function Name: codec_mute
+********************************************************************************
+* Summary:
+*  Soft mute or unmute the DAC. Returns at once; can be called from an ISR.
+*
+* Parameters:
+*  mute: true to mute
+*
+*******************************************************************************/
+void codec_mute(bool mute)
+{
+    codec_ctrl_submit(CODEC_CTRL_MUTE, mute ? 1u : 0u, NULL, NULL);
+}
+
+/*******************************************************************************
+* Function Name: codec_rate_begin
+********************************************************************************
+* Summary:
+*  Prepare the codec for a change of its clocks: mute the DAC. Returns at
+*  once: done is called once the mute is written, with false if it could not
+*  be written; the clocks must not be changed then.
+*
+* Parameters:
+*  done: called from the I2C ISR at the end, can be NULL
+*
+*******************************************************************************/
+void codec_rate_begin(codec_done_t done)
+{
+    codec_done = done;
+    if (!codec_ctrl_submit(CODEC_CTRL_MUTE, 1u, codec_on_muted, NULL))
+    {
+        codec_complete(false);
+    }
+}
+
+/*******************************************************************************
+* Function Name: codec_rate_end
+********************************************************************************
+* Summary:
+*  Configure the codec for the new sample rate once its clocks run, and
+*  unmute the DAC when it has settled. The I2C clock divider is recomputed
+*  first, as CLK_PERI follows the PLL. Returns at once: done is called when
+*  the unmute is queued, or with false if the rate could not be written;
+*  the DAC then stays muted.
+*
+* Parameters:
+*  sample_rate_hz: new sample rate
+*  done: called from the timebase or I2C ISR at the end, can be NULL
+*
+*******************************************************************************/
+void codec_rate_end(uint32_t sample_rate_hz, codec_done_t done)
+{
+    codec_done = done;
+    cyhal_i2c_configure(&codec_i2c, &codec_i2c_config);
+    ak4954a_regs_update(AK4954A_REG_MODE_CTRL2, AK4954A_FS_MASK, codec_fs(sample_rate_hz));
+    if (!codec_ctrl_submit(CODEC_CTRL_FLUSH, 0u, codec_on_rate_written, NULL))
+    {
+        codec_on_rate_written(CODEC_CTRL_FLUSH, false, NULL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: codec_is_idle
+********************************************************************************
+* Summary:
+*  Check if all the codec commands have been written.
+*
+* Return:
+*  bool: true when the I2C is not needed anymore
+*
+*******************************************************************************/
+bool codec_is_idle(void)
+{
+    return codec_ctrl_is_idle();
+}
+
+/*******************************************************************************
+* Function Name: codec_fs
+********************************************************************************
+* Summary:
+*  Get the AK4954A FS3-0 code of a sample rate (EXT slave mode, MCLK = 256fs).
+*
+*******************************************************************************/
+static uint8_t codec_fs(uint32_t sample_rate_hz)
+{
+    switch (sample_rate_hz)
+    {
+        case 8000u:
+            return 0x00u;
+        case 32000u:
+            return 0x0Au;
+        case 44100u:
+            return 0x0Fu;
+        case 48000u:
+            return 0x0Bu;
+        case 16000u:
+        default:
+            return 0x02u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: codec_on_powered
+********************************************************************************
+* Summary:
+*  End of the power-up writes, from the I2C ISR: wait for the amplifier
+*  outputs to settle. A failure is reported at once.
+*
+*******************************************************************************/
+static void codec_on_powered(codec_ctrl_op_t op, bool success, void *arg)
+{
+    (void) op;
+    (void) arg;
+
+    if (!success)
+    {
+        codec_complete(false);
+        return;
+    }
+
+    timebase_set_alarm(&codec_alarm, timebase_ms_to_ticks(AK4954A_POWER_UP_MS), codec_on_power_settled);
+}
+
+/*******************************************************************************
+* Function Name: codec_on_power_settled
+********************************************************************************
+* Summary:
+*  The amplifier outputs have settled, from the timebase ISR.
+*
+*******************************************************************************/
+static void codec_on_power_settled(void)
+{
+    codec_complete(true);
+}
+
+/*******************************************************************************
+* Function Name: codec_on_muted
+********************************************************************************
+* Summary:
+*  End of the mute before a rate switch, from the I2C ISR.
+*
+*******************************************************************************/
+static void codec_on_muted(codec_ctrl_op_t op, bool success, void *arg)
+{
+    (void) op;
+    (void) arg;
+
+    codec_complete(success);
+}
+
+/*******************************************************************************
+* Function Name: codec_on_rate_written
+********************************************************************************
+* Summary:
+*  End of the sample rate write, from the I2C ISR: wait for the codec to
+*  settle on the new MCLK. On a failure the DAC stays muted: the registers
+*  are written again with the next command.
+*
+*******************************************************************************/
+static void codec_on_rate_written(codec_ctrl_op_t op, bool success, void *arg)
+{
+    (void) op;
+    (void) arg;
+
+    if (!success)
+    {
+        codec_complete(false);
+        return;
+    }
+
+    timebase_set_alarm(&codec_alarm, timebase_ms_to_ticks(AK4954A_SETTLE_MS), codec_on_rate_settled);
+}
+
+/*******************************************************************************
+* Function Name: codec_on_rate_settled
+********************************************************************************
+* Summary:
+*  The codec has settled after a rate switch, from the timebase ISR: unmute
+*  the DAC in the background.
+*
+*******************************************************************************/
+static void codec_on_rate_settled(void)
+{
+    codec_ctrl_submit(CODEC_CTRL_MUTE, 0u, NULL, NULL);
+    codec_complete(true);
+}
+
+/*******************************************************************************
+* Function Name: codec_complete
+********************************************************************************
+* Summary:
+*  End of the sequence in progress: report it.
+*
+* Parameters:
+*  success: false if the I2C writes of the sequence failed
+*
+*******************************************************************************/
+static void codec_complete(bool success)
+{
+    codec_done_t done = codec_done;
+
+    codec_done = NULL;
+    if (done != NULL)
+    {
+        done(success);
+    }
+}
+
+#endif
+
+/* [] END OF FILE */
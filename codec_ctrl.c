@@ -0,0 +1,396 @@
+/*****************************************************************************
+* File Name: codec_ctrl.c
+*
+* Description: This file contains the asynchronous codec command queue. The
+*              commands update the register cache and are written to the codec by
+*              interrupt-driven I2C bursts, one after the other, so the caller never
+*              waits for the bus.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "codec_ctrl.h"
+
+#ifdef CODEC_AK4954A
+
+#include <string.h>
+
+#include "cyhal.h"
+#include "mtb_ak4954a.h"
+
+#include "ak4954a_regs.h"
+#include "cycle_counter.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* AK4954A Power Management 1: DAC */
+#define AK4954A_PMDAC           0x04u
+/* AK4954A Power Management 2: Lch and Rch headphone amplifiers */
+#define AK4954A_PMHP            0x30u
+/* AK4954A Mode Control 3: DAC soft mute */
+#define AK4954A_SMUTE           0x20u
+/* AK4954A Lch and Rch digital volume registers */
+#define AK4954A_DVOL_LCH_REG    0x13u
+#define AK4954A_DVOL_RCH_REG    0x14u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void ctrl_run(void);
+static bool ctrl_apply_step(void);
+static bool ctrl_complete(bool success);
+static void ctrl_on_flush(bool success);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+typedef struct
+{
+    codec_ctrl_op_t op;
+    uint8_t value;
+    uint8_t step;               /* Next step of the command */
+    codec_ctrl_done_t done;
+    void *arg;
+    uint32_t submit_cycles;
+} codec_ctrl_cmd_t;
+
+static codec_ctrl_cmd_t ctrl_queue[CODEC_CTRL_QUEUE_SIZE];
+/* Command being executed, the others follow it */
+static uint32_t ctrl_head;
+static uint32_t ctrl_count;
+/* Set while the commands are executed */
+static volatile bool ctrl_running;
+static codec_ctrl_stats_t ctrl_stats;
+
+/*******************************************************************************
+* Function Name: codec_ctrl_init
+********************************************************************************
+* Summary:
+*  Initialize the command queue. The register cache must be initialized.
+*
+*******************************************************************************/
+void codec_ctrl_init(void)
+{
+    ctrl_head    = 0u;
+    ctrl_count   = 0u;
+    ctrl_running = false;
+    memset(&ctrl_stats, 0, sizeof(ctrl_stats));
+}
+
+/*******************************************************************************
+* Function Name: codec_ctrl_submit
+********************************************************************************
+* Summary:
+*  Queue a codec command. The command starts at once if the queue is idle;
+*  the I2C transfers complete in the background. Can be called from an ISR.
+*
+* Parameters:
+*  op: command
+*  value: argument of the command
+*  done: called when the command has been executed, can be NULL
+*  arg: argument passed to done
+*
+* Return:
+*  bool: false if the queue is full
+*
+*******************************************************************************/
+bool codec_ctrl_submit(codec_ctrl_op_t op, uint8_t value, codec_ctrl_done_t done, void *arg)
+{
+    uint32_t start = cycle_counter_read();
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    codec_ctrl_cmd_t *cmd;
+    bool run;
+    uint32_t cycles;
+
+    if (ctrl_count >= CODEC_CTRL_QUEUE_SIZE)
+    {
+        ctrl_stats.dropped++;
+        cyhal_system_critical_section_exit(interrupt_state);
+        return false;
+    }
+
+    cmd = &ctrl_queue[(ctrl_head + ctrl_count) % CODEC_CTRL_QUEUE_SIZE];
+    cmd->op            = op;
+    cmd->value         = value;
+    cmd->step          = 0u;
+    cmd->done          = done;
+    cmd->arg           = arg;
+    cmd->submit_cycles = start;
+
+    ctrl_count++;
+    ctrl_stats.submitted++;
+    if (ctrl_count > ctrl_stats.max_depth)
+    {
+        ctrl_stats.max_depth = ctrl_count;
+    }
+
+    run = !ctrl_running;
+    ctrl_running = true;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    if (run)
+    {
+        ctrl_run();
+    }
+
+    cycles = cycle_counter_read() - start;
+    if (cycles > ctrl_stats.max_submit_cycles)
+    {
+        ctrl_stats.max_submit_cycles = cycles;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: codec_ctrl_is_idle
+********************************************************************************
+* Summary:
+*  Check if all the commands have been executed.
+*
+* Return:
+*  bool: true when no command is queued or in progress
+*
+*******************************************************************************/
+bool codec_ctrl_is_idle(void)
+{
+    return !ctrl_running;
+}
+
+/*******************************************************************************
+* Function Name: codec_ctrl_get_stats
+********************************************************************************
+* Summary:
+*  Get the statistics of the command queue. The times are in CPU cycles.
+*
+* Parameters:
+*  stats: filled with the statistics
+*
+*******************************************************************************/
+void codec_ctrl_get_stats(codec_ctrl_stats_t *stats)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+    *stats = ctrl_stats;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: ctrl_run
+********************************************************************************
+* Summary:
+*  Execute the steps of the queued commands until an I2C burst is started,
+*  or until the queue is empty. Only one context runs it at a time. The
+*  registers of a step can take several bursts, when they lie on both sides
+*  of a read-only register; the next step starts once they are all written.
+*
+*******************************************************************************/
+static void ctrl_run(void)
+{
+    bool more = true;
+
+    while (more)
+    {
+        if (!ak4954a_regs_is_dirty())
+        {
+            if (!ctrl_apply_step())
+            {
+                more = ctrl_complete(true);
+                continue;
+            }
+            if (!ak4954a_regs_is_dirty())
+            {
+                /* The step did not change any register */
+                continue;
+            }
+        }
+
+        if (ak4954a_regs_flush_async(ctrl_on_flush))
+        {
+            return;
+        }
+        more = ctrl_complete(false);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ctrl_apply_step
+********************************************************************************
+* Summary:
+*  Update the register cache for the next step of the command being
+*  executed. The DAC is powered before the headphone amplifiers and after
+*  them when powering down, so the output is never driven by an unpowered
+*  DAC.
+*
+* Return:
+*  bool: false if the command has no step left
+*
+*******************************************************************************/
+static bool ctrl_apply_step(void)
+{
+    codec_ctrl_cmd_t *cmd = &ctrl_queue[ctrl_head];
+    uint8_t step = cmd->step;
+    bool on = (cmd->value != 0u);
+
+    cmd->step++;
+
+    switch (cmd->op)
+    {
+        case CODEC_CTRL_FLUSH:
+            return (step == 0u);
+
+        case CODEC_CTRL_VOLUME:
+            if (step == 0u)
+            {
+                ak4954a_regs_update(AK4954A_DVOL_LCH_REG, 0xFFu, cmd->value);
+                ak4954a_regs_update(AK4954A_DVOL_RCH_REG, 0xFFu, cmd->value);
+                return true;
+            }
+            return false;
+
+        case CODEC_CTRL_MUTE:
+            if (step == 0u)
+            {
+                ak4954a_regs_update(AK4954A_REG_MODE_CTRL3, AK4954A_SMUTE, on ? AK4954A_SMUTE : 0u);
+                return true;
+            }
+            return false;
+
+        case CODEC_CTRL_POWER:
+            if (step == 0u)
+            {
+                trace_log(TRACE_CODEC_POWER, on ? 1u : 0u, 0u);
+                if (on)
+                {
+                    ak4954a_regs_update(AK4954A_REG_PWR_MGMT1, AK4954A_PMDAC, AK4954A_PMDAC);
+                }
+                else
+                {
+                    ak4954a_regs_update(AK4954A_REG_PWR_MGMT2, AK4954A_PMHP, 0u);
+                }
+                return true;
+            }
+            if (step == 1u)
+            {
+                if (on)
+                {
+                    ak4954a_regs_update(AK4954A_REG_PWR_MGMT2, AK4954A_PMHP, AK4954A_PMHP);
+                }
+                else
+                {
+                    ak4954a_regs_update(AK4954A_REG_PWR_MGMT1, AK4954A_PMDAC, 0u);
+                }
+                return true;
+            }
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: ctrl_complete
+********************************************************************************
+* Summary:
+*  Report the end of the command being executed and remove it from the
+*  queue.
+*
+* Parameters:
+*  success: false if an I2C burst of the command failed
+*
+* Return:
+*  bool: true if another command is queued
+*
+*******************************************************************************/
+static bool ctrl_complete(bool success)
+{
+    codec_ctrl_cmd_t cmd = ctrl_queue[ctrl_head];
+    uint32_t latency = cycle_counter_read() - cmd.submit_cycles;
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    bool more;
+
+    if (success)
+    {
+        ctrl_stats.completed++;
+    }
+    else
+    {
+        ctrl_stats.failed++;
+    }
+    if (latency > ctrl_stats.max_latency_cycles)
+    {
+        ctrl_stats.max_latency_cycles = latency;
+    }
+
+    ctrl_head = (ctrl_head + 1u) % CODEC_CTRL_QUEUE_SIZE;
+    ctrl_count--;
+    more = (ctrl_count > 0u);
+    ctrl_running = more;
+
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    if (cmd.done != NULL)
+    {
+        cmd.done(cmd.op, success, cmd.arg);
+    }
+
+    return more;
+}
+
+/*******************************************************************************
+* Function Name: ctrl_on_flush
+********************************************************************************
+* Summary:
+*  End of an I2C burst, called from the I2C ISR. Continues with the next
+*  step or command.
+*
+* Parameters:
+*  success: false if the burst failed
+*
+*******************************************************************************/
+static void ctrl_on_flush(bool success)
+{
+    if (success || ctrl_complete(false))
+    {
+        ctrl_run();
+    }
+}
+
+#endif
+
+/* [] END OF FILE */
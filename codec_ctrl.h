@@ -0,0 +1,78 @@
+/*****************************************************************************
+* File Name: codec_ctrl.h
+*
+* Description: This file contains the definitions of the asynchronous codec command
+*              queue.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CODEC_CTRL_H
+    #define CODEC_CTRL_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    /* Commands that can wait to be executed */
+    #define CODEC_CTRL_QUEUE_SIZE   8u
+
+    typedef enum
+    {
+        CODEC_CTRL_FLUSH,           /* Write the registers updated in the cache */
+        CODEC_CTRL_VOLUME,          /* value: digital volume code of both channels */
+        CODEC_CTRL_MUTE,            /* value: 1 soft mute, 0 unmute */
+        CODEC_CTRL_POWER,           /* value: 1 power the DAC output up, 0 down */
+    } codec_ctrl_op_t;
+
+    /* Called from the I2C ISR when a command has been executed */
+    typedef void (*codec_ctrl_done_t)(codec_ctrl_op_t op, bool success, void *arg);
+
+    typedef struct
+    {
+        uint32_t submitted;
+        uint32_t completed;
+        uint32_t failed;            /* Commands whose I2C burst failed */
+        uint32_t dropped;           /* Commands refused, the queue was full */
+        uint32_t max_depth;         /* Highest number of commands queued */
+        uint32_t max_latency_cycles;    /* From the submission to the completion */
+        uint32_t max_submit_cycles;     /* Time the caller spent in a submission */
+    } codec_ctrl_stats_t;
+
+    void codec_ctrl_init(void);
+    bool codec_ctrl_submit(codec_ctrl_op_t op, uint8_t value, codec_ctrl_done_t done, void *arg);
+    bool codec_ctrl_is_idle(void);
+    void codec_ctrl_get_stats(codec_ctrl_stats_t *stats);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/*****************************************************************************
+* File Name: codec_passive.h
+*
+* Description: This file contains the codec driver of a passive DAC, such as the
+*              Pmod I2S2 (CS4344). The DAC has no control interface and follows the
+*              I2S clocks by itself, so the calls compile to nothing.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CODEC_PASSIVE_H
+    #define CODEC_PASSIVE_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "cyhal.h"
+
+    /* The DAC cannot be muted or powered down */
+    #define CODEC_MUTE_MS           0u          /* in ms */
+    #define CODEC_IDLE_ON_UA        0u          /* in uA */
+    #define CODEC_IDLE_OFF_UA       0u          /* in uA */
+
+    static inline cy_rslt_t codec_init(void)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    /* The DAC detects the sample rate from the MCLK to LRCK ratio; longer
+    *  words are truncated to 24 bits */
+    static inline bool codec_supports(uint32_t sample_rate_hz, uint32_t word_length)
+    {
+        (void) sample_rate_hz;
+        (void) word_length;
+        return true;
+    }
+
+    /* The sequences complete at once */
+    static inline void codec_activate(codec_done_t done)
+    {
+        if (done != NULL)
+        {
+            done(true);
+        }
+    }
+
+    static inline void codec_power_down(void)
+    {
+    }
+
+    static inline void codec_set_volume(uint8_t volume)
+    {
+        (void) volume;
+    }
+
+    static inline void codec_mute(bool mute)
+    {
+        (void) mute;
+    }
+
+    static inline void codec_rate_begin(codec_done_t done)
+    {
+        if (done != NULL)
+        {
+            done(true);
+        }
+    }
+
+    static inline void codec_rate_end(uint32_t sample_rate_hz, codec_done_t done)
+    {
+        (void) sample_rate_hz;
+        if (done != NULL)
+        {
+            done(true);
+        }
+    }
+
+    static inline bool codec_is_idle(void)
+    {
+        return true;
+    }
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,288 @@
+/*****************************************************************************
+* File Name: cpu_governor.c
+*
+* Description: This file contains the CPU clock governor. The cycles spent
+*              rendering each block give the load at the current CM4 clock;
+*              the CLK_FAST divider goes up as soon as the load is high and
+*              down after a run of blocks that would fit at half the clock.
+*              Peripherals (I2S, MCLK PWM) are not affected.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cpu_governor.h"
+#include "audio_energy.h"
+#include "timebase.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Load above which the clock is raised immediately */
+#define GOVERNOR_UP_PERMILLE        600u
+/* Load the block would have at half the clock, below which it is lowered */
+#define GOVERNOR_DOWN_PERMILLE      400u
+/* Consecutive light blocks needed before lowering the clock */
+#define GOVERNOR_DOWN_BLOCKS        16u
+/* Level used while the pipeline is idle */
+#define GOVERNOR_IDLE_LEVEL         (CPU_GOVERNOR_LEVELS - 1u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void governor_request_level(uint32_t level);
+static void governor_set_level(uint32_t level);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* CLK_FAST divider of each level */
+static const uint8_t governor_dividers[CPU_GOVERNOR_LEVELS] = { 1u, 2u, 4u, 8u };
+
+static cyhal_clock_t *governor_fast_clock;
+/* Level programmed in CLK_FAST */
+static uint32_t governor_level;
+/* Level chosen from the block loads, applied from the main loop */
+static volatile uint32_t governor_target;
+static uint32_t governor_light_blocks;
+static cpu_governor_stats_t governor_stats;
+
+/*******************************************************************************
+* Function Name: cpu_governor_init
+********************************************************************************
+* Summary:
+*  Initialize the governor at the full CPU clock, so the rest of the
+*  initialization runs at full speed. The clock drops to the idle level
+*  when the first clip stops.
+*
+* Parameters:
+*  fast_clock: reserved CLK_FAST (CM4 clock) object
+*
+*******************************************************************************/
+void cpu_governor_init(cyhal_clock_t *fast_clock)
+{
+    uint32_t cpu_hz;
+
+    governor_fast_clock = fast_clock;
+    governor_level  = 0;
+    governor_target = 0;
+
+    memset(&governor_stats, 0, sizeof(governor_stats));
+
+    cyhal_clock_set_divider(governor_fast_clock, governor_dividers[0]);
+
+    /* The first record gives the CPU clock of the trace timestamps */
+    cpu_hz = cyhal_clock_get_frequency(governor_fast_clock);
+    audio_energy_on_cpu_clock(cpu_hz);
+    trace_log(TRACE_CPU_CLOCK, 0u, cpu_hz);
+}
+
+/*******************************************************************************
+* Function Name: cpu_governor_start
+********************************************************************************
+* Summary:
+*  Called from the main loop when the pipeline starts a clip. Restores the
+*  full clock at once, so the first blocks are never late, and clears the
+*  clip statistics.
+*
+*******************************************************************************/
+void cpu_governor_start(void)
+{
+    memset(&governor_stats, 0, sizeof(governor_stats));
+    governor_light_blocks = 0;
+    governor_target = 0;
+
+    governor_set_level(0);
+}
+
+/*******************************************************************************
+* Function Name: cpu_governor_stop
+********************************************************************************
+* Summary:
+*  Called when the pipeline stops, from the I2S ISR. Requests the idle
+*  level.
+*
+*******************************************************************************/
+void cpu_governor_stop(void)
+{
+    governor_request_level(GOVERNOR_IDLE_LEVEL);
+}
+
+/*******************************************************************************
+* Function Name: cpu_governor_on_block
+********************************************************************************
+* Summary:
+*  Account a rendered block and pick the clock level of the next blocks.
+*  Called from the I2S ISR: the level is only requested, and programmed by
+*  cpu_governor_handler() from the main loop.
+*
+* Parameters:
+*  cycles: CPU cycles spent rendering the block
+*  frames: frames in the block
+*  sample_rate_hz: output sample rate
+*
+*******************************************************************************/
+void cpu_governor_on_block(uint32_t cycles, uint32_t frames, uint32_t sample_rate_hz)
+{
+    uint32_t cpu_hz = cyhal_clock_get_frequency(governor_fast_clock);
+    uint32_t block_us = (uint32_t) (((uint64_t) frames * 1000000u) / sample_rate_hz);
+    uint32_t active_us = (uint32_t) (((uint64_t) cycles * 1000000u) / cpu_hz);
+    uint32_t load = (block_us > 0u) ? (uint32_t) (((uint64_t) active_us * 1000u) / block_us) : 0u;
+
+    governor_stats.blocks[governor_level]++;
+    governor_stats.active_cycles += cycles;
+    if (load > governor_stats.peak_load_permille)
+    {
+        governor_stats.peak_load_permille = load;
+    }
+
+    /* A pending request is not changed again before it is applied */
+    if (governor_target != governor_level)
+    {
+        return;
+    }
+
+    if ((load > GOVERNOR_UP_PERMILLE) && (governor_level > 0u))
+    {
+        governor_light_blocks = 0;
+        governor_request_level(governor_level - 1u);
+    }
+    else if (((load * 2u) < GOVERNOR_DOWN_PERMILLE) && (governor_level < (CPU_GOVERNOR_LEVELS - 1u)))
+    {
+        governor_light_blocks++;
+        if (governor_light_blocks >= GOVERNOR_DOWN_BLOCKS)
+        {
+            governor_light_blocks = 0;
+            governor_request_level(governor_level + 1u);
+        }
+    }
+    else
+    {
+        governor_light_blocks = 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cpu_governor_handler
+********************************************************************************
+* Summary:
+*  Scheduler handler of SCHEDULER_EVENT_CPU_LEVEL: program the requested
+*  level. A request made while the event was queued is applied as well.
+*
+* Parameters:
+*  event: not used, the latest request is applied
+*
+*******************************************************************************/
+void cpu_governor_handler(const scheduler_event_t *event)
+{
+    (void) event;
+
+    governor_set_level(governor_target);
+}
+
+/*******************************************************************************
+* Function Name: cpu_governor_get_level
+********************************************************************************
+* Summary:
+*  Get the current clock level.
+*
+* Return:
+*  uint32_t: 0 (full clock) to CPU_GOVERNOR_LEVELS - 1
+*
+*******************************************************************************/
+uint32_t cpu_governor_get_level(void)
+{
+    return governor_level;
+}
+
+/*******************************************************************************
+* Function Name: cpu_governor_get_clip_stats
+********************************************************************************
+* Summary:
+*  Get the statistics of the clip being played, or of the last one.
+*
+* Parameters:
+*  stats: filled with the statistics
+*
+*******************************************************************************/
+void cpu_governor_get_clip_stats(cpu_governor_stats_t *stats)
+{
+    *stats = governor_stats;
+}
+
+/*******************************************************************************
+* Function Name: governor_request_level
+********************************************************************************
+* Summary:
+*  Request a level from an ISR. If the event cannot be queued, the request is
+*  dropped and made again on a later block.
+*
+*******************************************************************************/
+static void governor_request_level(uint32_t level)
+{
+    uint32_t previous = governor_target;
+
+    governor_target = level;
+    if ((level != previous) &&
+        !scheduler_post(SCHEDULER_EVENT_CPU_LEVEL, level, timebase_now()))
+    {
+        governor_target = previous;
+    }
+}
+
+/*******************************************************************************
+* Function Name: governor_set_level
+********************************************************************************
+* Summary:
+*  Program the CLK_FAST divider of a level.
+*
+*******************************************************************************/
+static void governor_set_level(uint32_t level)
+{
+    if (level != governor_level)
+    {
+        uint32_t cpu_hz;
+
+        governor_stats.switches++;
+        governor_level = level;
+        cyhal_clock_set_divider(governor_fast_clock, governor_dividers[level]);
+
+        cpu_hz = cyhal_clock_get_frequency(governor_fast_clock);
+        audio_energy_on_cpu_clock(cpu_hz);
+        trace_log(TRACE_CPU_CLOCK, level, cpu_hz);
+    }
+}
+
+/* [] END OF FILE */
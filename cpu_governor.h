@@ -0,0 +1,71 @@
+/*****************************************************************************
+* File Name: cpu_governor.h
+*
+* Description: This file contains the definitions of the CPU clock governor,
+*              which scales the CM4 clock with the measured audio load.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CPU_GOVERNOR_H
+    #define CPU_GOVERNOR_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "cyhal.h"
+    #include "scheduler.h"
+
+    /* Number of CPU clock levels (CLK_FAST dividers 1, 2, 4 and 8) */
+    #define CPU_GOVERNOR_LEVELS     4u
+
+    /* Statistics of one played clip */
+    typedef struct
+    {
+        uint32_t blocks[CPU_GOVERNOR_LEVELS];   /* Blocks rendered at each level */
+        uint64_t active_cycles;                 /* Cycles spent rendering */
+        uint32_t switches;                      /* Level changes */
+        uint32_t peak_load_permille;            /* Highest block load */
+    } cpu_governor_stats_t;
+
+    void cpu_governor_init(cyhal_clock_t *fast_clock);
+    void cpu_governor_start(void);
+    void cpu_governor_stop(void);
+    void cpu_governor_on_block(uint32_t cycles, uint32_t frames, uint32_t sample_rate_hz);
+    void cpu_governor_handler(const scheduler_event_t *event);
+    uint32_t cpu_governor_get_level(void);
+    void cpu_governor_get_clip_stats(cpu_governor_stats_t *stats);
+
+#endif
+
+/* [] END OF FILE */
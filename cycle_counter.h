@@ -0,0 +1,92 @@
+/*****************************************************************************
+* File Name: cycle_counter.h
+*
+* Description: This file contains the access to the free-running CPU cycle
+*              counter (DWT CYCCNT) used to time the audio code. On a host
+*              build (HOST_BUILD), the counter counts nanoseconds of the
+*              monotonic clock instead.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYCLE_COUNTER_H
+    #define CYCLE_COUNTER_H
+
+    #include <stdint.h>
+
+    #ifdef HOST_BUILD
+        /* CPU cycles of the virtual time the CPU was awake, see
+        *  host/sim_hal.c */
+        uint32_t sim_cycle_counter(void);
+    #else
+        #include "cyhal.h"
+    #endif
+
+    /***************************************************************************
+    * Function Name: cycle_counter_init
+    ****************************************************************************
+    * Summary:
+    *  Enable the cycle counter. It is never reset, so users measure with
+    *  unsigned differences, which stay valid across one wrap.
+    *
+    ***************************************************************************/
+    static inline void cycle_counter_init(void)
+    {
+    #ifndef HOST_BUILD
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    #endif
+    }
+
+    /***************************************************************************
+    * Function Name: cycle_counter_read
+    ****************************************************************************
+    * Summary:
+    *  Read the cycle counter.
+    *
+    * Return:
+    *  uint32_t: CPU cycles (of the simulated CPU clock on a host build)
+    *
+    ***************************************************************************/
+    static inline uint32_t cycle_counter_read(void)
+    {
+    #ifdef HOST_BUILD
+        return sim_cycle_counter();
+    #else
+        return DWT->CYCCNT;
+    #endif
+    }
+
+#endif
+
+/* [] END OF FILE */
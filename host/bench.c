@@ -0,0 +1,920 @@
+/*****************************************************************************
+* File Name: bench.c
+*
+* Description: This file contains the micro-benchmark of the audio kernels.
+*              Each kernel is timed with the cycle counter over several block
+*              sizes. The results are written to a CSV file and compared with a
+*              stored baseline, so a change that slows the audio path fails.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#include "audio_clip.h"
+#include "audio_dds.h"
+#include "audio_format.h"
+#include "audio_mixer.h"
+#include "audio_stream.h"
+#include "audio_wsola.h"
+#include "audio_xfade.h"
+#include "cyhal.h"
+#include "wave.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Frames rendered per repetition, whatever the block size */
+#define BENCH_RUN_FRAMES        16384u
+/* Repetitions per measurement; the fastest one is kept */
+#define BENCH_DEFAULT_RUNS      50u
+/* Slowdown over the baseline that fails the run, in % */
+#define BENCH_DEFAULT_TOLERANCE 25u
+/* Nominal CPU clock: one cycle per nanosecond of the host clock */
+#define BENCH_DEFAULT_CPU_MHZ   1000u
+#define BENCH_NS_PER_S          1000000000.0
+
+#define BENCH_SAMPLE_RATE_HZ    48000u
+#define BENCH_STREAM_SIZE       1024u
+#define BENCH_MAX_RESULTS       128u
+/* Index of the reference kernel in bench_kernels[] */
+#define BENCH_REF_KERNEL        0u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+typedef struct bench_results bench_results_t;
+typedef struct bench_result bench_result_t;
+
+static void bench_usage(const char *program);
+static void bench_noise_init(void);
+static uint32_t bench_noise_render(audio_voice_t *voice, int32_t *dst, uint32_t frames);
+static void bench_noise_voice_init(audio_voice_t *voice, int8_t pan);
+
+static uint32_t bench_ref_run(uint32_t frames);
+static uint32_t bench_gain_run(uint32_t frames);
+static void bench_clip_setup(void);
+static uint32_t bench_clip_run(uint32_t frames);
+static void bench_dds_setup(void);
+static uint32_t bench_dds_run(uint32_t frames);
+static void bench_stream_setup(void);
+static uint32_t bench_stream_run(uint32_t frames);
+static void bench_wsola_setup(void);
+static uint32_t bench_wsola_run(uint32_t frames);
+static void bench_xfade_setup(void);
+static uint32_t bench_xfade_run(uint32_t frames);
+static void bench_mix_setup(uint32_t voices, bool panned);
+static void bench_mix1_setup(void);
+static void bench_mix1_pan_setup(void);
+static void bench_mix4_setup(void);
+static void bench_mix4_pan_setup(void);
+static uint32_t bench_mix_run(uint32_t frames);
+
+static uint32_t bench_measure(uint32_t index, uint32_t frames, uint64_t *samples);
+static uint32_t bench_now_ns(void);
+static bool bench_load_results(const char *path, bench_results_t *results);
+static const bench_result_t *bench_find_result(const bench_results_t *results, const char *kernel,
+                                               uint32_t frames);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Kernel under test. setup() prepares the state before each repetition,
+*  outside of the measurement; run() processes one block and returns the
+*  number of samples produced. */
+typedef struct
+{
+    const char *name;
+    const char *description;
+    void (*setup)(void);
+    uint32_t (*run)(uint32_t frames);
+} bench_kernel_t;
+
+/* The reference kernel comes first. It is a scalar loop that cannot be
+*  vectorized, so its cost follows the speed of the host; the relative costs
+*  of the other kernels, unlike their absolute costs, carry over to another
+*  host. */
+static const bench_kernel_t bench_kernels[] =
+{
+    { "ref",      "reference: 4-tap FIR filter",                bench_pack_setup,      bench_ref_run      },
+    { "pack16",   "mix scale to 16-bit I2S word conversion",    bench_pack_setup,      bench_pack16_run   },
+    { "pack24",   "mix scale to 24-bit I2S word conversion",    bench_pack_setup,      bench_pack24_run   },
+    { "pack32",   "mix scale to 32-bit I2S word conversion",    bench_pack_setup,      bench_pack32_run   },
+    { "gain",     "Q14 gain on interleaved samples",            bench_pack_setup,      bench_gain_run     },
+    { "clip",     "16-bit PCM clip decode",                     bench_clip_setup,      bench_clip_run     },
+    { "dds",      "DDS tone synthesis with sweep",              bench_dds_setup,       bench_dds_run      },
+    { "stream",   "stream write and PI-controlled resampling",  bench_stream_setup,    bench_stream_run   },
+    { "wsola",    "WSOLA time stretch at 1.25x",                bench_wsola_setup,     bench_wsola_run    },
+    { "xfade",    "equal-power crossfade of two voices",        bench_xfade_setup,     bench_xfade_run    },
+    { "mix1",     "mixer, one centered voice",                  bench_mix1_setup,      bench_mix_run      },
+    { "mix1pan",  "mixer, one off-center voice",                bench_mix1_pan_setup,  bench_mix_run      },
+    { "mix4",     "mixer, four centered voices",                bench_mix4_setup,      bench_mix_run      },
+    { "mix4pan",  "mixer, four off-center voices",              bench_mix4_pan_setup,  bench_mix_run      },
+    { "render16", "block render, one voice, 16-bit words",      bench_mix1_setup,      bench_render16_run },
+    { "render24", "block render, one voice, 24-bit words",      bench_mix1_setup,      bench_render24_run },
+    { "render32", "block render, one voice, 32-bit words",      bench_mix1_setup,      bench_render32_run },
+};
+#define BENCH_KERNEL_COUNT  (sizeof(bench_kernels) / sizeof(bench_kernels[0]))
+
+/* Block sizes, up to the mixer limit */
+static const uint32_t bench_block_frames[] = { 16u, 32u, 64u, 128u };
+#define BENCH_BLOCK_COUNT   (sizeof(bench_block_frames) / sizeof(bench_block_frames[0]))
+
+/* Fastest repetition of each measurement, and its number of samples */
+static uint32_t bench_best[BENCH_KERNEL_COUNT][BENCH_BLOCK_COUNT];
+static uint64_t bench_samples[BENCH_KERNEL_COUNT][BENCH_BLOCK_COUNT];
+/* Cost of each measurement, in cycles per sample */
+static double bench_cycles[BENCH_KERNEL_COUNT][BENCH_BLOCK_COUNT];
+
+/* Line of a results file: a kernel at a block size */
+struct bench_result
+{
+    char kernel[16];
+    uint32_t frames;
+    double cycles;              /* Per sample */
+    double relative;            /* Cycles relative to the reference kernel */
+};
+
+/* Results file read back */
+struct bench_results
+{
+    bench_result_t entries[BENCH_MAX_RESULTS];
+    uint32_t count;
+};
+
+static bench_results_t bench_baseline;
+static bench_results_t bench_previous;
+
+/* Inputs: uniform noise at full scale */
+static int16_t bench_noise_pcm[BENCH_NOISE_SIZE];
+int32_t bench_noise_mix[BENCH_NOISE_SIZE + BENCH_NOISE_GUARD];
+
+/* Outputs. Not static: the compiler cannot tell that they are never read,
+*  so the work is not optimized out. */
+int32_t bench_mix_out[AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS];
+int32_t bench_voice_out[AUDIO_BLOCK_FRAMES];
+
+/* Kernel state */
+typedef struct
+{
+    audio_voice_t voice;        /* Must be the first member */
+    uint32_t position;
+} bench_noise_voice_t;
+
+static bench_noise_voice_t bench_sources[AUDIO_MIXER_MAX_VOICES];
+static audio_clip_voice_t bench_clip;
+static audio_dds_voice_t bench_dds;
+static audio_stream_t bench_stream;
+static int16_t bench_stream_buffer[BENCH_STREAM_SIZE];
+static uint32_t bench_stream_input;
+static audio_wsola_t bench_wsola;
+static audio_xfade_t bench_xfade;
+uint32_t bench_input;
+
+static const audio_dds_tone_t bench_tone =
+{
+    .wave        = AUDIO_DDS_SAW,
+    .start_hz    = 200u,
+    .end_hz      = 2000u,
+    .duration_ms = 1000u,
+    .attack_ms   = 10u,
+    .release_ms  = 10u,
+    .gain        = AUDIO_GAIN_UNITY,
+};
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Measure every kernel at every block size, print the results, write them
+*  to the output file and compare them with the baseline.
+*
+* Return:
+*  int: 0 on success, 1 if a kernel is slower than its baseline by more than
+*  the tolerance
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *output_path = NULL;
+    const char *baseline_path = NULL;
+    const char *previous_path = NULL;
+    uint32_t runs = BENCH_DEFAULT_RUNS;
+    uint32_t tolerance = BENCH_DEFAULT_TOLERANCE;
+    uint32_t cpu_mhz = BENCH_DEFAULT_CPU_MHZ;
+    bool absolute = false;
+    uint32_t regressions = 0u;
+    FILE *output = NULL;
+    int option;
+
+    while ((option = getopt(argc, argv, "o:b:am:t:r:c:h")) != -1)
+    {
+        switch (option)
+        {
+            case 'o':
+                output_path = optarg;
+                break;
+
+            case 'b':
+                baseline_path = optarg;
+                break;
+
+            case 'a':
+                absolute = true;
+                break;
+
+            case 'm':
+                previous_path = optarg;
+                break;
+
+            case 't':
+                tolerance = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'r':
+                runs = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'c':
+                cpu_mhz = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+
+            default:
+                bench_usage(argv[0]);
+                break;
+        }
+    }
+    if ((optind != argc) || (runs == 0u) || (cpu_mhz == 0u))
+    {
+        bench_usage(argv[0]);
+    }
+
+    if ((baseline_path != NULL) && !bench_load_results(baseline_path, &bench_baseline))
+    {
+        fprintf(stderr, "cannot read the baseline %s\n", baseline_path);
+        return 2;
+    }
+    if ((previous_path != NULL) && !bench_load_results(previous_path, &bench_previous))
+    {
+        fprintf(stderr, "cannot read the results %s\n", previous_path);
+        return 2;
+    }
+    if (output_path != NULL)
+    {
+        output = fopen(output_path, "w");
+        if (output == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", output_path);
+            return 2;
+        }
+        fprintf(output, "kernel,frames,cycles_per_sample,samples_per_s,relative\n");
+    }
+
+    bench_noise_init();
+
+    /* The repetitions of all the measurements are interleaved, so a period
+    *  of host load slows down one repetition of each rather than all the
+    *  repetitions of one. The fastest repetition is kept. */
+    memset(bench_best, 0xFF, sizeof(bench_best));
+    for (uint32_t r = 0; r < runs; r++)
+    {
+        for (uint32_t k = 0; k < BENCH_KERNEL_COUNT; k++)
+        {
+            for (uint32_t b = 0; b < BENCH_BLOCK_COUNT; b++)
+            {
+                uint32_t cycles = bench_measure(k, bench_block_frames[b], &bench_samples[k][b]);
+
+                if (cycles < bench_best[k][b])
+                {
+                    bench_best[k][b] = cycles;
+                }
+            }
+        }
+    }
+
+    /* Some costs depend on the process, through the physical memory it
+    *  gets: the fastest of several runs is kept by merging their results */
+    for (uint32_t k = 0; k < BENCH_KERNEL_COUNT; k++)
+    {
+        for (uint32_t b = 0; b < BENCH_BLOCK_COUNT; b++)
+        {
+            /* The host clock may be coarser than a repetition */
+            uint32_t ns = (bench_best[k][b] != 0u) ? bench_best[k][b] : 1u;
+            const bench_result_t *previous = bench_find_result(&bench_previous, bench_kernels[k].name,
+                                                               bench_block_frames[b]);
+
+            bench_cycles[k][b] = ((double) ns * cpu_mhz) / (1000.0 * (double) bench_samples[k][b]);
+            if ((previous != NULL) && (previous->cycles < bench_cycles[k][b]))
+            {
+                bench_cycles[k][b] = previous->cycles;
+            }
+        }
+    }
+
+    printf("%-9s %6s %14s %12s %9s %10s\n", "kernel", "frames", "cycles/sample", "Msamples/s", "relative",
+           absolute ? "baseline" : "rel. base");
+    for (uint32_t k = 0; k < BENCH_KERNEL_COUNT; k++)
+    {
+        for (uint32_t b = 0; b < BENCH_BLOCK_COUNT; b++)
+        {
+            uint32_t frames = bench_block_frames[b];
+            double cycles = bench_cycles[k][b];
+            double rate = (BENCH_NS_PER_S * cpu_mhz) / (cycles * 1000.0);
+            double relative = cycles / bench_cycles[BENCH_REF_KERNEL][b];
+            const bench_result_t *baseline = bench_find_result(&bench_baseline, bench_kernels[k].name, frames);
+
+            printf("%-9s %6u %14.2f %12.2f %9.3f", bench_kernels[k].name, frames, cycles, rate / 1e6, relative);
+            /* The reference is the unit of the relative costs */
+            if ((baseline != NULL) && (absolute || (k != BENCH_REF_KERNEL)))
+            {
+                double change = absolute ? ((cycles / baseline->cycles) - 1.0) * 100.0
+                                         : ((relative / baseline->relative) - 1.0) * 100.0;
+                bool regression = change > (double) tolerance;
+
+                printf(" %+9.1f%%%s", change, regression ? "  REGRESSION" : "");
+                if (regression)
+                {
+                    regressions++;
+                }
+            }
+            else if ((baseline_path != NULL) && (baseline == NULL))
+            {
+                printf(" %10s", "new");
+            }
+            printf("\n");
+
+            if (output != NULL)
+            {
+                fprintf(output, "%s,%u,%.3f,%.0f,%.3f\n", bench_kernels[k].name, frames, cycles, rate, relative);
+            }
+        }
+    }
+
+    if (output != NULL)
+    {
+        fclose(output);
+    }
+    if (regressions != 0u)
+    {
+        printf("%u measurements slower than the baseline by more than %u%%\n", regressions, tolerance);
+        return 1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: bench_usage
+********************************************************************************
+* Summary:
+*  Print the usage and the kernels, and exit.
+*
+*******************************************************************************/
+static void bench_usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [-o results.csv] [-m results.csv] [-b baseline.csv [-a]] [-t tolerance_%%] [-r runs] [-c cpu_mhz]\n"
+            "  -o  write the results as CSV: kernel,frames,cycles_per_sample,samples_per_s,relative\n"
+            "  -b  compare the costs relative to the reference kernel with a previous results\n"
+            "      file; exit 1 on a regression\n"
+            "  -a  compare the absolute costs instead, only meaningful on the host of the baseline\n"
+            "  -m  keep the faster of this run and a previous results file of the same host\n"
+            "  -t  slowdown over the baseline that fails, default %u%%\n"
+            "  -r  repetitions per measurement, the fastest is kept, default %u\n"
+            "  -c  CPU clock used to convert the host time to cycles, default %u MHz\n"
+            "kernels:\n",
+            program, BENCH_DEFAULT_TOLERANCE, BENCH_DEFAULT_RUNS, BENCH_DEFAULT_CPU_MHZ);
+    for (uint32_t k = 0; k < BENCH_KERNEL_COUNT; k++)
+    {
+        fprintf(stderr, "  %-9s %s\n", bench_kernels[k].name, bench_kernels[k].description);
+    }
+    exit(2);
+}
+
+/*******************************************************************************
+* Function Name: bench_measure
+********************************************************************************
+* Summary:
+*  Time one repetition of a kernel at a block size: BENCH_RUN_FRAMES frames
+*  rendered from a fresh state.
+*
+* Parameters:
+*  index: kernel index in bench_kernels[]
+*  frames: block size
+*  samples: set to the samples produced
+*
+* Return:
+*  uint32_t: duration in ns of the host clock
+*
+*******************************************************************************/
+static uint32_t bench_measure(uint32_t index, uint32_t frames, uint64_t *samples)
+{
+    const bench_kernel_t *kernel = &bench_kernels[index];
+    uint64_t count = 0;
+    uint32_t start;
+
+    kernel->setup();
+
+    start = bench_now_ns();
+    for (uint32_t done = 0; done < BENCH_RUN_FRAMES; done += frames)
+    {
+        count += kernel->run(frames);
+    }
+
+    *samples = count;
+    return bench_now_ns() - start;
+}
+
+/*******************************************************************************
+* Function Name: bench_now_ns
+********************************************************************************
+* Summary:
+*  Read the host clock. The cycle counter of the host build counts virtual
+*  time, so it cannot time the kernels.
+*
+* Return:
+*  uint32_t: time in ns, wrapping
+*
+*******************************************************************************/
+static uint32_t bench_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) (((uint64_t) now.tv_sec * 1000000000u) + (uint64_t) now.tv_nsec);
+}
+
+/*******************************************************************************
+* Function Name: bench_load_results
+********************************************************************************
+* Summary:
+*  Read a results file written with -o.
+*
+* Parameters:
+*  path: results file
+*  results: filled with its lines
+*
+* Return:
+*  bool: false if the file cannot be read
+*
+*******************************************************************************/
+static bool bench_load_results(const char *path, bench_results_t *results)
+{
+    FILE *file = fopen(path, "r");
+    char line[128];
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    results->count = 0u;
+    while ((fgets(line, sizeof(line), file) != NULL) && (results->count < BENCH_MAX_RESULTS))
+    {
+        bench_result_t *entry = &results->entries[results->count];
+
+        /* The header line does not parse */
+        if (sscanf(line, "%15[^,],%u,%lf,%*f,%lf", entry->kernel, &entry->frames,
+                   &entry->cycles, &entry->relative) == 4)
+        {
+            results->count++;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: bench_find_result
+********************************************************************************
+* Summary:
+*  Find the result of a kernel at a block size.
+*
+* Return:
+*  const bench_result_t *: result, NULL if not in the results
+*
+*******************************************************************************/
+static const bench_result_t *bench_find_result(const bench_results_t *results, const char *kernel,
+                                               uint32_t frames)
+{
+    for (uint32_t i = 0; i < results->count; i++)
+    {
+        if ((results->entries[i].frames == frames) && (strcmp(results->entries[i].kernel, kernel) == 0))
+        {
+            return &results->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: bench_noise_init
+********************************************************************************
+* Summary:
+*  Fill the input tables with a fixed pseudo-random sequence, so every run
+*  processes the same data.
+*
+*******************************************************************************/
+static void bench_noise_init(void)
+{
+    uint32_t state = 1u;
+
+    for (uint32_t i = 0; i < BENCH_NOISE_SIZE; i++)
+    {
+        state = (state * 1664525u) + 1013904223u;
+        bench_noise_pcm[i] = (int16_t) (state >> 16);
+        bench_noise_mix[i] = AUDIO_MIX_FROM_PCM16(bench_noise_pcm[i]);
+    }
+    for (uint32_t i = 0; i < BENCH_NOISE_GUARD; i++)
+    {
+        bench_noise_mix[BENCH_NOISE_SIZE + i] = bench_noise_mix[i];
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_noise_render
+********************************************************************************
+* Summary:
+*  Render callback of the noise source: copies the noise table, so a source
+*  costs little next to the kernel it feeds. It never ends.
+*
+*******************************************************************************/
+static uint32_t bench_noise_render(audio_voice_t *voice, int32_t *dst, uint32_t frames)
+{
+    bench_noise_voice_t *obj = (bench_noise_voice_t *) voice;
+
+    for (uint32_t n = 0; n < frames; n++)
+    {
+        dst[n] = bench_noise_mix[(obj->position + n) & (BENCH_NOISE_SIZE - 1u)];
+    }
+    obj->position += frames;
+
+    return frames;
+}
+
+/*******************************************************************************
+* Function Name: bench_noise_voice_init
+********************************************************************************
+* Summary:
+*  Initialize a noise source at unity gain.
+*
+*******************************************************************************/
+static void bench_noise_voice_init(audio_voice_t *voice, int8_t pan)
+{
+    bench_noise_voice_t *obj = (bench_noise_voice_t *) voice;
+
+    obj->voice.render = bench_noise_render;
+    obj->voice.gain   = AUDIO_GAIN_UNITY;
+    obj->voice.pan    = pan;
+    obj->position     = (uint32_t) (obj - bench_sources) * (BENCH_NOISE_SIZE / AUDIO_MIXER_MAX_VOICES);
+}
+
+/*******************************************************************************
+* Function Name: bench_ref_run
+********************************************************************************
+* Summary:
+*  Reference kernel: a 4-tap FIR filter on mix samples. Like the audio
+*  kernels, it is bound by the multiply and load throughput, so host load
+*  slows it down as much as them.
+*
+*******************************************************************************/
+static uint32_t bench_ref_run(uint32_t frames)
+{
+    static const int32_t taps[4] = { 3277, 13107, 13107, 3277 };
+    const int32_t *src = &bench_noise_mix[bench_input];
+
+    for (uint32_t n = 0; n < frames; n++)
+    {
+        int64_t acc = ((int64_t) src[n] * taps[0]) + ((int64_t) src[n + 1u] * taps[1]) +
+                      ((int64_t) src[n + 2u] * taps[2]) + ((int64_t) src[n + 3u] * taps[3]);
+        bench_voice_out[n] = (int32_t) (acc >> 15);
+    }
+    bench_input = (bench_input + frames) & (BENCH_NOISE_SIZE - 1u);
+
+    return frames;
+}
+
+/*******************************************************************************
+* Function Name: bench_pack_setup
+********************************************************************************
+* Summary:
+*  Restart the input of the pack and gain kernels.
+*
+*******************************************************************************/
+void bench_pack_setup(void)
+{
+    bench_input = 0u;
+}
+
+/*******************************************************************************
+* Function Name: bench_gain_run
+********************************************************************************
+* Summary:
+*  Apply a Q14 gain to a block of interleaved mix samples.
+*
+*******************************************************************************/
+static uint32_t bench_gain_run(uint32_t frames)
+{
+    const int32_t *src = &bench_noise_mix[bench_input];
+    uint32_t words = frames * AUDIO_CHANNELS;
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        bench_mix_out[i] = audio_gain_apply(src[i], AUDIO_GAIN_UNITY / 3u);
+    }
+    bench_input = (bench_input + words) & (BENCH_NOISE_SIZE - 1u);
+
+    return words;
+}
+
+/*******************************************************************************
+* Function Name: bench_clip_setup
+********************************************************************************
+* Summary:
+*  Rewind the clip voice. The clip is longer than one repetition.
+*
+*******************************************************************************/
+static void bench_clip_setup(void)
+{
+    audio_clip_voice_init(&bench_clip, &wave_clip);
+}
+
+/*******************************************************************************
+* Function Name: bench_clip_run
+********************************************************************************
+* Summary:
+*  Decode a block of the clip to mix scale.
+*
+*******************************************************************************/
+static uint32_t bench_clip_run(uint32_t frames)
+{
+    return bench_clip.voice.render(&bench_clip.voice, bench_voice_out, frames);
+}
+
+/*******************************************************************************
+* Function Name: bench_dds_setup
+********************************************************************************
+* Summary:
+*  Restart the tone. It is longer than one repetition.
+*
+*******************************************************************************/
+static void bench_dds_setup(void)
+{
+    audio_dds_voice_init(&bench_dds, &bench_tone, BENCH_SAMPLE_RATE_HZ);
+}
+
+/*******************************************************************************
+* Function Name: bench_dds_run
+********************************************************************************
+* Summary:
+*  Synthesize a block of the tone.
+*
+*******************************************************************************/
+static uint32_t bench_dds_run(uint32_t frames)
+{
+    return bench_dds.voice.render(&bench_dds.voice, bench_voice_out, frames);
+}
+
+/*******************************************************************************
+* Function Name: bench_stream_setup
+********************************************************************************
+* Summary:
+*  Restart the stream with its buffer half full, so it plays from the first
+*  block.
+*
+*******************************************************************************/
+static void bench_stream_setup(void)
+{
+    audio_stream_init(&bench_stream, bench_stream_buffer, BENCH_STREAM_SIZE);
+    audio_stream_write(&bench_stream, bench_noise_pcm, BENCH_STREAM_SIZE / 2u);
+    bench_stream_input = BENCH_STREAM_SIZE / 2u;
+}
+
+/*******************************************************************************
+* Function Name: bench_stream_run
+********************************************************************************
+* Summary:
+*  Write a block to the stream and resample a block out of it. The buffer
+*  fill stays near its target, so the drift filter and the cubic
+*  interpolation run as in steady state.
+*
+*******************************************************************************/
+static uint32_t bench_stream_run(uint32_t frames)
+{
+    audio_stream_write(&bench_stream, &bench_noise_pcm[bench_stream_input], frames);
+    bench_stream_input = (bench_stream_input + frames) & (BENCH_NOISE_SIZE - 1u);
+
+    return bench_stream.voice.render(&bench_stream.voice, bench_voice_out, frames);
+}
+
+/*******************************************************************************
+* Function Name: bench_wsola_setup
+********************************************************************************
+* Summary:
+*  Restart the time stretch of a noise source.
+*
+*******************************************************************************/
+static void bench_wsola_setup(void)
+{
+    bench_noise_voice_init(&bench_sources[0].voice, AUDIO_PAN_CENTER);
+    audio_wsola_init(&bench_wsola, &bench_sources[0].voice, (AUDIO_WSOLA_SPEED_UNITY * 5u) / 4u);
+}
+
+/*******************************************************************************
+* Function Name: bench_wsola_run
+********************************************************************************
+* Summary:
+*  Render a block of the stretched source, similarity search included.
+*
+*******************************************************************************/
+static uint32_t bench_wsola_run(uint32_t frames)
+{
+    return bench_wsola.voice.render(&bench_wsola.voice, bench_voice_out, frames);
+}
+
+/*******************************************************************************
+* Function Name: bench_xfade_setup
+********************************************************************************
+* Summary:
+*  Restart a crossfade between two noise sources, longer than one
+*  repetition, so both sources are rendered throughout.
+*
+*******************************************************************************/
+static void bench_xfade_setup(void)
+{
+    bench_noise_voice_init(&bench_sources[0].voice, AUDIO_PAN_LEFT);
+    bench_noise_voice_init(&bench_sources[1].voice, AUDIO_PAN_RIGHT);
+    audio_mixer_init();
+    (void) audio_mixer_add(&bench_sources[0].voice);
+    (void) audio_xfade_start(&bench_xfade, &bench_sources[0].voice, &bench_sources[1].voice,
+                             1000u, BENCH_SAMPLE_RATE_HZ);
+}
+
+/*******************************************************************************
+* Function Name: bench_xfade_run
+********************************************************************************
+* Summary:
+*  Render a block of both crossfade voices, without the mixer.
+*
+*******************************************************************************/
+static uint32_t bench_xfade_run(uint32_t frames)
+{
+    (void) bench_xfade.fade_out.render(&bench_xfade.fade_out, bench_voice_out, frames);
+    return bench_xfade.voice.render(&bench_xfade.voice, bench_voice_out, frames);
+}
+
+/*******************************************************************************
+* Function Name: bench_mix_setup
+********************************************************************************
+* Summary:
+*  Restart the mixer with noise voices. Centered voices take the single
+*  multiply path of the mixer, off-center voices the two-multiply one, so a
+*  pair at the same voice count isolates the cost of the pan.
+*
+* Parameters:
+*  voices: number of voices, up to AUDIO_MIXER_MAX_VOICES
+*  panned: place the voices off center
+*
+*******************************************************************************/
+static void bench_mix_setup(uint32_t voices, bool panned)
+{
+    static const int8_t pans[AUDIO_MIXER_MAX_VOICES] =
+    {
+        AUDIO_PAN_LEFT / 2, AUDIO_PAN_RIGHT / 2, AUDIO_PAN_LEFT, AUDIO_PAN_RIGHT
+    };
+
+    audio_mixer_init();
+    for (uint32_t i = 0; i < voices; i++)
+    {
+        bench_noise_voice_init(&bench_sources[i].voice, panned ? pans[i] : AUDIO_PAN_CENTER);
+        bench_sources[i].voice.gain = AUDIO_GAIN_UNITY / voices;
+        (void) audio_mixer_add(&bench_sources[i].voice);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_mix1_setup
+********************************************************************************
+* Summary:
+*  Restart the mixer with one centered voice.
+*
+*******************************************************************************/
+static void bench_mix1_setup(void)
+{
+    bench_mix_setup(1u, false);
+}
+
+/*******************************************************************************
+* Function Name: bench_mix1_pan_setup
+********************************************************************************
+* Summary:
+*  Restart the mixer with one off-center voice.
+*
+*******************************************************************************/
+static void bench_mix1_pan_setup(void)
+{
+    bench_mix_setup(1u, true);
+}
+
+/*******************************************************************************
+* Function Name: bench_mix4_setup
+********************************************************************************
+* Summary:
+*  Restart the mixer with all the voices, centered.
+*
+*******************************************************************************/
+static void bench_mix4_setup(void)
+{
+    bench_mix_setup(AUDIO_MIXER_MAX_VOICES, false);
+}
+
+/*******************************************************************************
+* Function Name: bench_mix4_pan_setup
+********************************************************************************
+* Summary:
+*  Restart the mixer with all the voices, off center.
+*
+*******************************************************************************/
+static void bench_mix4_pan_setup(void)
+{
+    bench_mix_setup(AUDIO_MIXER_MAX_VOICES, true);
+}
+
+/*******************************************************************************
+* Function Name: bench_mix_run
+********************************************************************************
+* Summary:
+*  Mix a block of the voices into the stereo mix buffer.
+*
+*******************************************************************************/
+static uint32_t bench_mix_run(uint32_t frames)
+{
+    audio_mixer_render(bench_mix_out, frames);
+
+    return frames * AUDIO_CHANNELS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_enter
+********************************************************************************
+* Summary:
+*  The benchmark is not linked with the HAL, and the producer and the
+*  consumer of the stream run in the same thread: nothing to mask.
+*
+*******************************************************************************/
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    return 0u;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_exit
+********************************************************************************
+* Summary:
+*  See cyhal_system_critical_section_enter().
+*
+*******************************************************************************/
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+    (void) old_state;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,70 @@
+/*****************************************************************************
+* File Name: bench.h
+*
+* Description: This file contains the definitions shared by the micro-benchmark
+*              of the audio kernels and its word-length dependent kernels.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef BENCH_H
+    #define BENCH_H
+
+    #include <stdint.h>
+
+    /* Length of the noise tables, a power of 2 */
+    #define BENCH_NOISE_SIZE        4096u
+    /* Samples repeated past the end of the mix table for the FIR taps */
+    #define BENCH_NOISE_GUARD       3u
+
+    /* Input of the kernels: uniform noise at 24-bit mix scale */
+    extern int32_t bench_noise_mix[BENCH_NOISE_SIZE + BENCH_NOISE_GUARD];
+    /* Input position of the pack and gain kernels */
+    extern uint32_t bench_input;
+
+    /* Kernels of bench_format.c, built once per output word length. The
+    *  pack kernel converts interleaved mix samples to I2S words; the render
+    *  kernel is the block render of the pipeline: the mixer, then the
+    *  conversion. */
+    #define BENCH_FORMAT_KERNELS(bits) \
+        uint32_t bench_pack##bits##_run(uint32_t frames); \
+        uint32_t bench_render##bits##_run(uint32_t frames);
+
+    void bench_pack_setup(void);
+    BENCH_FORMAT_KERNELS(16)
+    BENCH_FORMAT_KERNELS(24)
+    BENCH_FORMAT_KERNELS(32)
+
+#endif
+
+/* [] END OF FILE */
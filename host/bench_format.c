@@ -0,0 +1,106 @@
+/*****************************************************************************
+* File Name: bench_format.c
+*
+* Description: This file contains the kernels of the micro-benchmark that depend
+*              on the output word length. It is built once per word length, with
+*              AUDIO_WORD_LENGTH set to 16, 24 and 32, so the costs of the word
+*              lengths are measured side by side in one run.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "bench.h"
+
+#include "audio_format.h"
+#include "audio_mixer.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define BENCH_CONCAT(a, b, c)   a##b##c
+#define BENCH_NAME(a, bits, c)  BENCH_CONCAT(a, bits, c)
+/* Name of a function or variable of this word length */
+#define BENCH_FORMAT(prefix, suffix) BENCH_NAME(prefix, AUDIO_WORD_LENGTH, suffix)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Outputs. Not static: the compiler cannot tell that they are never read,
+*  so the work is not optimized out. */
+int32_t BENCH_FORMAT(bench_mix, _out)[AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS];
+audio_sample_t BENCH_FORMAT(bench_words, _out)[AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS];
+
+/*******************************************************************************
+* Function Name: bench_pack<bits>_run
+********************************************************************************
+* Summary:
+*  Convert a block of interleaved mix samples to I2S words, as done by the
+*  pipeline after the mixer.
+*
+*******************************************************************************/
+uint32_t BENCH_FORMAT(bench_pack, _run)(uint32_t frames)
+{
+    const int32_t *src = &bench_noise_mix[bench_input];
+    uint32_t words = frames * AUDIO_CHANNELS;
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        BENCH_FORMAT(bench_words, _out)[i] = audio_format_pack(src[i]);
+    }
+    bench_input = (bench_input + words) & (BENCH_NOISE_SIZE - 1u);
+
+    return words;
+}
+
+/*******************************************************************************
+* Function Name: bench_render<bits>_run
+********************************************************************************
+* Summary:
+*  Render a block as the pipeline does: mix the voices, then convert the
+*  mix to I2S words.
+*
+*******************************************************************************/
+uint32_t BENCH_FORMAT(bench_render, _run)(uint32_t frames)
+{
+    uint32_t words = frames * AUDIO_CHANNELS;
+
+    audio_mixer_render(BENCH_FORMAT(bench_mix, _out), frames);
+    for (uint32_t i = 0; i < words; i++)
+    {
+        BENCH_FORMAT(bench_words, _out)[i] = audio_format_pack(BENCH_FORMAT(bench_mix, _out)[i]);
+    }
+
+    return words;
+}
+
+/* [] END OF FILE */
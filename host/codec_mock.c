@@ -0,0 +1,356 @@
+/*****************************************************************************
+* File Name: codec_mock.c
+*
+* Description: This file contains the recording codec of the host simulator. Each
+*              call is logged with its virtual time. The power-up and the steps
+*              of a sample rate switch complete from a simulated interrupt
+*              after the latency set by the test, or at once, and their
+*              completions are logged as well.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "codec.h"
+
+#ifdef CODEC_MOCK
+
+#include "sim.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void mock_record(codec_mock_call_type_t type, uint32_t arg);
+static void mock_start(codec_mock_call_type_t type, uint32_t arg, codec_done_t done);
+static void mock_complete(void);
+static void mock_deadline(sim_device_t *device);
+static void mock_isr(sim_device_t *device);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static codec_mock_call_t mock_calls[CODEC_MOCK_LOG_SIZE];
+static uint32_t mock_call_count;
+
+/* Completion of the sequences, from the interrupt of mock_device */
+static sim_device_t mock_device;
+static uint64_t mock_latency_ns;
+static bool mock_pending;
+static codec_mock_call_type_t mock_pending_type;
+static codec_done_t mock_done;
+/* The next sequence of this type fails, CODEC_MOCK_INIT for none */
+static codec_mock_call_type_t mock_fail_type;
+
+/*******************************************************************************
+* Function Name: codec_init
+********************************************************************************
+* Summary:
+*  Clear the log and register the interrupt of the completions.
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS
+*
+*******************************************************************************/
+cy_rslt_t codec_init(void)
+{
+    mock_call_count = 0u;
+    mock_pending    = false;
+    mock_done       = NULL;
+
+    sim_register(&mock_device, "codec");
+    mock_device.on_deadline  = mock_deadline;
+    mock_device.on_interrupt = mock_isr;
+    /* The completions come from the timebase on the board */
+    mock_device.deep_sleep   = true;
+
+    mock_record(CODEC_MOCK_INIT, 0u);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: codec_supports
+********************************************************************************
+* Summary:
+*  Any format is supported. Not recorded.
+*
+*******************************************************************************/
+bool codec_supports(uint32_t sample_rate_hz, uint32_t word_length)
+{
+    (void) sample_rate_hz;
+    (void) word_length;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: codec_activate
+********************************************************************************
+* Summary:
+*  Record a power-up, completed after the latency.
+*
+*******************************************************************************/
+void codec_activate(codec_done_t done)
+{
+    mock_start(CODEC_MOCK_ACTIVATE, 0u, done);
+}
+
+/*******************************************************************************
+* Function Name: codec_power_down
+********************************************************************************
+* Summary:
+*  Record a power-down.
+*
+*******************************************************************************/
+void codec_power_down(void)
+{
+    mock_record(CODEC_MOCK_POWER_DOWN, 0u);
+}
+
+/*******************************************************************************
+* Function Name: codec_set_volume
+********************************************************************************
+* Summary:
+*  Record a volume change.
+*
+*******************************************************************************/
+void codec_set_volume(uint8_t volume)
+{
+    mock_record(CODEC_MOCK_SET_VOLUME, volume);
+}
+
+/*******************************************************************************
+* Function Name: codec_mute
+********************************************************************************
+* Summary:
+*  Record a mute or an unmute.
+*
+*******************************************************************************/
+void codec_mute(bool mute)
+{
+    mock_record(CODEC_MOCK_MUTE, mute ? 1u : 0u);
+}
+
+/*******************************************************************************
+* Function Name: codec_rate_begin
+********************************************************************************
+* Summary:
+*  Record the start of a rate switch, completed after the latency.
+*
+*******************************************************************************/
+void codec_rate_begin(codec_done_t done)
+{
+    mock_start(CODEC_MOCK_RATE_BEGIN, 0u, done);
+}
+
+/*******************************************************************************
+* Function Name: codec_rate_end
+********************************************************************************
+* Summary:
+*  Record the end of a rate switch, completed after the latency.
+*
+*******************************************************************************/
+void codec_rate_end(uint32_t sample_rate_hz, codec_done_t done)
+{
+    mock_start(CODEC_MOCK_RATE_END, sample_rate_hz, done);
+}
+
+/*******************************************************************************
+* Function Name: codec_is_idle
+********************************************************************************
+* Summary:
+*  Check if no sequence is in progress.
+*
+*******************************************************************************/
+bool codec_is_idle(void)
+{
+    return !mock_pending;
+}
+
+/*******************************************************************************
+* Function Name: codec_mock_set_latency
+********************************************************************************
+* Summary:
+*  Set the time the power-up and the rate switch steps take. With 0, they
+*  complete before the call returns, like a passive DAC.
+*
+* Parameters:
+*  latency_us: time in us
+*
+*******************************************************************************/
+void codec_mock_set_latency(uint32_t latency_us)
+{
+    mock_latency_ns = (uint64_t) latency_us * SIM_NS_PER_US;
+}
+
+/*******************************************************************************
+* Function Name: codec_mock_fail_next
+********************************************************************************
+* Summary:
+*  Make the next power-up or rate switch step of a type fail, as on an I2C
+*  error. It completes after the latency with a failure.
+*
+* Parameters:
+*  type: CODEC_MOCK_ACTIVATE, CODEC_MOCK_RATE_BEGIN or CODEC_MOCK_RATE_END
+*
+*******************************************************************************/
+void codec_mock_fail_next(codec_mock_call_type_t type)
+{
+    mock_fail_type = type;
+}
+
+/*******************************************************************************
+* Function Name: codec_mock_get_calls
+********************************************************************************
+* Summary:
+*  Get the calls recorded since codec_init().
+*
+* Parameters:
+*  calls: set to the log
+*
+* Return:
+*  uint32_t: number of calls in the log
+*
+*******************************************************************************/
+uint32_t codec_mock_get_calls(const codec_mock_call_t **calls)
+{
+    *calls = mock_calls;
+
+    return mock_call_count;
+}
+
+/*******************************************************************************
+* Function Name: mock_record
+********************************************************************************
+* Summary:
+*  Log a call at the current virtual time.
+*
+*******************************************************************************/
+static void mock_record(codec_mock_call_type_t type, uint32_t arg)
+{
+    if (mock_call_count < CODEC_MOCK_LOG_SIZE)
+    {
+        mock_calls[mock_call_count].type = type;
+        mock_calls[mock_call_count].arg  = arg;
+        mock_calls[mock_call_count].time = sim_now();
+        mock_call_count++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: mock_start
+********************************************************************************
+* Summary:
+*  Log a sequence and schedule its completion. A sequence started while
+*  another is in progress is logged: the drivers run one at a time, so the
+*  tests check that it never happens. It replaces the other one.
+*
+*******************************************************************************/
+static void mock_start(codec_mock_call_type_t type, uint32_t arg, codec_done_t done)
+{
+    mock_record(type, arg);
+
+    mock_pending      = true;
+    mock_pending_type = type;
+    mock_done         = done;
+
+    if (mock_latency_ns == 0u)
+    {
+        mock_complete();
+    }
+    else
+    {
+        mock_device.deadline = sim_now() + mock_latency_ns;
+    }
+}
+
+/*******************************************************************************
+* Function Name: mock_complete
+********************************************************************************
+* Summary:
+*  End of the sequence in progress: log it and report it, with a failure if
+*  one was requested for its type.
+*
+*******************************************************************************/
+static void mock_complete(void)
+{
+    codec_done_t done = mock_done;
+    bool success = (mock_pending_type != mock_fail_type);
+
+    if (!success)
+    {
+        mock_fail_type = CODEC_MOCK_INIT;
+    }
+
+    mock_record(success ? CODEC_MOCK_DONE : CODEC_MOCK_FAILED, (uint32_t) mock_pending_type);
+    mock_pending = false;
+    mock_done    = NULL;
+
+    if (done != NULL)
+    {
+        done(success);
+    }
+}
+
+/*******************************************************************************
+* Function Name: mock_deadline
+********************************************************************************
+* Summary:
+*  The latency of the sequence has elapsed: raise the interrupt.
+*
+*******************************************************************************/
+static void mock_deadline(sim_device_t *device)
+{
+    device->deadline = SIM_NEVER;
+    sim_raise(device);
+}
+
+/*******************************************************************************
+* Function Name: mock_isr
+********************************************************************************
+* Summary:
+*  Completion interrupt.
+*
+*******************************************************************************/
+static void mock_isr(sim_device_t *device)
+{
+    (void) device;
+
+    if (mock_pending)
+    {
+        mock_complete();
+    }
+}
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,94 @@
+/*****************************************************************************
+* File Name: codec_mock.h
+*
+* Description: This file contains the definitions of the recording codec of the
+*              host simulator, selected with CODEC=MOCK. It takes the place of
+*              a codec driver, see codec.h, and records each call with its
+*              virtual time for the tests.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CODEC_MOCK_H
+    #define CODEC_MOCK_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "cyhal.h"
+
+    /* Figures of the AK4954A, so the calls follow the timing of the board */
+    #define CODEC_MUTE_MS           103u        /* in ms */
+    #define CODEC_IDLE_ON_UA        1400u       /* in uA */
+    #define CODEC_IDLE_OFF_UA       10u         /* in uA */
+
+    /* Calls recorded, the later ones are dropped */
+    #define CODEC_MOCK_LOG_SIZE     64u
+
+    typedef enum
+    {
+        CODEC_MOCK_INIT,
+        CODEC_MOCK_ACTIVATE,
+        CODEC_MOCK_POWER_DOWN,
+        CODEC_MOCK_SET_VOLUME,      /* arg: volume code */
+        CODEC_MOCK_MUTE,            /* arg: 1 mute, 0 unmute */
+        CODEC_MOCK_RATE_BEGIN,
+        CODEC_MOCK_RATE_END,        /* arg: sample rate */
+        CODEC_MOCK_DONE,            /* arg: call whose sequence completed */
+        CODEC_MOCK_FAILED,          /* arg: call whose sequence failed */
+    } codec_mock_call_type_t;
+
+    typedef struct
+    {
+        codec_mock_call_type_t type;
+        uint32_t arg;
+        uint64_t time;              /* Virtual time, in ns */
+    } codec_mock_call_t;
+
+    cy_rslt_t codec_init(void);
+    bool codec_supports(uint32_t sample_rate_hz, uint32_t word_length);
+    void codec_activate(codec_done_t done);
+    void codec_power_down(void);
+    void codec_set_volume(uint8_t volume);
+    void codec_mute(bool mute);
+    void codec_rate_begin(codec_done_t done);
+    void codec_rate_end(uint32_t sample_rate_hz, codec_done_t done);
+    bool codec_is_idle(void);
+
+    void codec_mock_set_latency(uint32_t latency_us);
+    void codec_mock_fail_next(codec_mock_call_type_t type);
+    uint32_t codec_mock_get_calls(const codec_mock_call_t **calls);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,60 @@
+/*****************************************************************************
+* File Name: cybsp.h
+*
+* Description: This file contains the board definitions of the host simulator:
+*              the pins of the CY8CKIT-062-WIFI-BT used by the application.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYBSP_H
+    #define CYBSP_H
+
+    #include "cyhal.h"
+
+    #define CYBSP_USER_LED          P13_7
+    #define CYBSP_USER_BTN          P0_4
+    #define CYBSP_I2C_SCL           P6_0
+    #define CYBSP_I2C_SDA           P6_1
+
+    /* The LED and the button are active low */
+    #define CYBSP_LED_STATE_ON      0u
+    #define CYBSP_LED_STATE_OFF     1u
+    #define CYBSP_BTN_PRESSED       0u
+    #define CYBSP_BTN_OFF           1u
+
+    cy_rslt_t cybsp_init(void);
+
+#endif
+
+/* [] END OF FILE */
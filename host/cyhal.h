@@ -0,0 +1,539 @@
+/*****************************************************************************
+* File Name: cyhal.h
+*
+* Description: This file contains the subset of the HAL and the CMSIS core
+*              functions used by the application, for the host simulator. The
+*              types follow the PSoC 6 HAL; the functions are implemented
+*              against the virtual clock of sim.c.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYHAL_H
+    #define CYHAL_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+    #include <stddef.h>
+
+    /***************************************************************************
+    * Results
+    ***************************************************************************/
+    typedef uint32_t cy_rslt_t;
+
+    #define CY_RSLT_SUCCESS                 ((cy_rslt_t) 0u)
+    /* Request refused: transfer in progress, or Deep Sleep refused by a
+    *  callback */
+    #define CYHAL_RSLT_ERR_BUSY             ((cy_rslt_t) 0x04000001u)
+    /* I2C address not acknowledged: no device at the address */
+    #define CYHAL_I2C_RSLT_ERR_NACK         ((cy_rslt_t) 0x04000002u)
+
+    void sim_fail(const char *format, ...);
+
+    #define CY_ASSERT(x)    do { if (!(x)) { sim_fail("%s:%d: assertion failed: %s", __FILE__, __LINE__, #x); } } while (0)
+
+    /***************************************************************************
+    * Core
+    ***************************************************************************/
+    #define CYHAL_ISR_PRIORITY_DEFAULT      7u
+
+    uint32_t sim_irq_disable(void);
+    void sim_irq_restore(uint32_t state);
+
+    static inline void __enable_irq(void)
+    {
+        sim_irq_restore(0u);
+    }
+
+    static inline void __DMB(void)
+    {
+        __sync_synchronize();
+    }
+
+    /* ISRs only run at the HAL calls of the simulator, so an exclusive
+    *  access is never interrupted */
+    static inline uint32_t __LDREXW(volatile uint32_t *address)
+    {
+        return *address;
+    }
+
+    static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *address)
+    {
+        *address = value;
+        return 0u;
+    }
+
+    static inline void __CLREX(void)
+    {
+    }
+
+    static inline uint32_t __CLZ(uint32_t value)
+    {
+        return (value == 0u) ? 32u : (uint32_t) __builtin_clz(value);
+    }
+
+    void NVIC_SystemReset(void);
+
+    uint32_t cyhal_system_critical_section_enter(void);
+    void cyhal_system_critical_section_exit(uint32_t old_state);
+    cy_rslt_t cyhal_system_delay_ms(uint32_t milliseconds);
+    void cyhal_system_delay_us(uint16_t microseconds);
+
+    /***************************************************************************
+    * GPIO
+    ***************************************************************************/
+    typedef uint8_t cyhal_gpio_t;
+
+    #define CYHAL_GET_GPIO(port, pin)       ((cyhal_gpio_t) (((port) << 3) + (pin)))
+    #define CYHAL_GPIO_COUNT                (14u * 8u)
+    #define NC                              ((cyhal_gpio_t) 0xFFu)
+
+    #define P0_4                            CYHAL_GET_GPIO(0, 4)
+    #define P5_0                            CYHAL_GET_GPIO(5, 0)
+    #define P5_1                            CYHAL_GET_GPIO(5, 1)
+    #define P5_2                            CYHAL_GET_GPIO(5, 2)
+    #define P5_3                            CYHAL_GET_GPIO(5, 3)
+    #define P6_0                            CYHAL_GET_GPIO(6, 0)
+    #define P6_1                            CYHAL_GET_GPIO(6, 1)
+    #define P13_7                           CYHAL_GET_GPIO(13, 7)
+
+    typedef enum
+    {
+        CYHAL_GPIO_DIR_INPUT,
+        CYHAL_GPIO_DIR_OUTPUT,
+        CYHAL_GPIO_DIR_BIDIRECTIONAL,
+    } cyhal_gpio_direction_t;
+
+    typedef enum
+    {
+        CYHAL_GPIO_DRIVE_NONE,
+        CYHAL_GPIO_DRIVE_PULLUP,
+        CYHAL_GPIO_DRIVE_PULLDOWN,
+        CYHAL_GPIO_DRIVE_STRONG,
+    } cyhal_gpio_drive_mode_t;
+
+    typedef enum
+    {
+        CYHAL_GPIO_IRQ_NONE = 0,
+        CYHAL_GPIO_IRQ_RISE = 1,
+        CYHAL_GPIO_IRQ_FALL = 2,
+        CYHAL_GPIO_IRQ_BOTH = 3,
+    } cyhal_gpio_event_t;
+
+    typedef void (*cyhal_gpio_event_callback_t)(void *callback_arg, cyhal_gpio_event_t event);
+
+    typedef struct cyhal_gpio_callback_data_s
+    {
+        cyhal_gpio_event_callback_t callback;
+        void *callback_arg;
+        struct cyhal_gpio_callback_data_s *next;
+        cyhal_gpio_t pin;
+    } cyhal_gpio_callback_data_t;
+
+    cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction,
+                              cyhal_gpio_drive_mode_t drive_mode, bool init_val);
+    bool cyhal_gpio_read(cyhal_gpio_t pin);
+    void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+    void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data);
+    void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority, bool enable);
+
+    /***************************************************************************
+    * Clocks
+    ***************************************************************************/
+    typedef enum
+    {
+        CYHAL_CLOCK_BLOCK_IMO,
+        CYHAL_CLOCK_BLOCK_FLL,
+        CYHAL_CLOCK_BLOCK_PLL,
+        CYHAL_CLOCK_BLOCK_HF,
+        CYHAL_CLOCK_BLOCK_FAST,
+        CYHAL_CLOCK_BLOCK_PERI,
+        CYHAL_CLOCK_BLOCK_PERIPHERAL_16BIT,
+    } cyhal_clock_block_t;
+
+    /* Reference to a clock; its state is kept by the simulator */
+    typedef struct
+    {
+        cyhal_clock_block_t block;
+        uint8_t channel;
+        bool reserved;
+    } cyhal_clock_t;
+
+    typedef struct
+    {
+        uint32_t tolerance;
+    } cyhal_clock_tolerance_t;
+
+    extern const cyhal_clock_t CYHAL_CLOCK_IMO;
+    extern const cyhal_clock_t CYHAL_CLOCK_FLL;
+    extern const cyhal_clock_t CYHAL_CLOCK_PLL[2];
+    extern const cyhal_clock_t CYHAL_CLOCK_HF[5];
+    extern const cyhal_clock_t CYHAL_CLOCK_FAST;
+    extern const cyhal_clock_t CYHAL_CLOCK_PERI;
+
+    cy_rslt_t cyhal_clock_reserve(cyhal_clock_t *clock, const cyhal_clock_t *clock_);
+    cy_rslt_t cyhal_clock_allocate(cyhal_clock_t *clock, cyhal_clock_block_t block);
+    uint32_t cyhal_clock_get_frequency(const cyhal_clock_t *clock);
+    cy_rslt_t cyhal_clock_set_frequency(cyhal_clock_t *clock, uint32_t hz,
+                                        const cyhal_clock_tolerance_t *tolerance);
+    cy_rslt_t cyhal_clock_set_divider(cyhal_clock_t *clock, uint32_t divider);
+    cy_rslt_t cyhal_clock_set_source(cyhal_clock_t *clock, const cyhal_clock_t *source);
+    cy_rslt_t cyhal_clock_set_enabled(cyhal_clock_t *clock, bool enabled, bool wait_for_lock);
+
+    /* PDL functions of the clock paths, for the PLL dividers that the HAL
+    *  does not expose. Clock path 1 is PLL[0], path 2 is PLL[1]. */
+    typedef enum
+    {
+        CY_SYSCLK_SUCCESS,
+        CY_SYSCLK_BAD_PARAM,
+        CY_SYSCLK_TIMEOUT,
+        CY_SYSCLK_INVALID_STATE,
+    } cy_en_sysclk_status_t;
+
+    typedef enum
+    {
+        CY_SYSCLK_FLLPLL_OUTPUT_AUTO,
+        CY_SYSCLK_FLLPLL_OUTPUT_AUTO1,
+        CY_SYSCLK_FLLPLL_OUTPUT_INPUT,
+        CY_SYSCLK_FLLPLL_OUTPUT_OUTPUT,
+    } cy_en_fll_pll_output_mode_t;
+
+    typedef struct
+    {
+        uint8_t feedbackDiv;
+        uint8_t referenceDiv;
+        uint8_t outputDiv;
+        bool lfMode;
+        cy_en_fll_pll_output_mode_t outputMode;
+    } cy_stc_pll_manual_config_t;
+
+    cy_en_sysclk_status_t Cy_SysClk_PllDisable(uint32_t clkPath);
+    cy_en_sysclk_status_t Cy_SysClk_PllManualConfigure(uint32_t clkPath, const cy_stc_pll_manual_config_t *config);
+    cy_en_sysclk_status_t Cy_SysClk_PllEnable(uint32_t clkPath, uint32_t timeoutus);
+
+    /* The delays of the simulator follow the virtual clock */
+    static inline void SystemCoreClockUpdate(void)
+    {
+    }
+
+    /***************************************************************************
+    * PWM
+    ***************************************************************************/
+    typedef struct
+    {
+        cyhal_gpio_t pin;
+        uint32_t frequency_hz;
+        float duty_cycle;
+        bool running;
+    } cyhal_pwm_t;
+
+    cy_rslt_t cyhal_pwm_init(cyhal_pwm_t *obj, cyhal_gpio_t pin, const cyhal_clock_t *clk);
+    cy_rslt_t cyhal_pwm_set_duty_cycle(cyhal_pwm_t *obj, float duty_cycle, uint32_t frequencyhal_hz);
+    cy_rslt_t cyhal_pwm_start(cyhal_pwm_t *obj);
+    cy_rslt_t cyhal_pwm_stop(cyhal_pwm_t *obj);
+
+    /***************************************************************************
+    * Simulated device, see sim.h
+    ***************************************************************************/
+    typedef struct sim_device
+    {
+        const char *name;
+        /* Next hardware event, in ns of virtual time */
+        uint64_t deadline;
+        void (*on_deadline)(struct sim_device *device);
+        /* Interrupt request, served when the priority allows */
+        bool pending;
+        uint8_t priority;
+        void (*on_interrupt)(struct sim_device *device);
+        /* Keeps running in Deep Sleep */
+        bool deep_sleep;
+        uint32_t interrupts;
+        struct sim_device *next;
+    } sim_device_t;
+
+    /***************************************************************************
+    * Timer/counter
+    ***************************************************************************/
+    typedef enum
+    {
+        CYHAL_TIMER_DIR_UP,
+        CYHAL_TIMER_DIR_DOWN,
+        CYHAL_TIMER_DIR_UP_DOWN,
+    } cyhal_timer_direction_t;
+
+    typedef enum
+    {
+        CYHAL_TIMER_IRQ_NONE = 0,
+        CYHAL_TIMER_IRQ_TERMINAL_COUNT = 1,
+        CYHAL_TIMER_IRQ_CAPTURE_COMPARE = 2,
+        CYHAL_TIMER_IRQ_ALL = 3,
+    } cyhal_timer_event_t;
+
+    typedef struct
+    {
+        bool is_continuous;
+        cyhal_timer_direction_t direction;
+        bool is_compare;
+        uint32_t period;
+        uint32_t compare_value;
+        uint32_t value;
+    } cyhal_timer_cfg_t;
+
+    typedef void (*cyhal_timer_event_callback_t)(void *callback_arg, cyhal_timer_event_t event);
+
+    /* Counter of a TCPWM block. The simulated counters are all 32-bit
+    *  (block 0). */
+    typedef struct
+    {
+        uint8_t block_num;
+        uint8_t channel_num;
+    } cyhal_resource_inst_t;
+
+    typedef struct
+    {
+        cyhal_resource_inst_t resource;
+    } cyhal_tcpwm_t;
+
+    typedef struct
+    {
+        sim_device_t device;
+        cyhal_tcpwm_t tcpwm;
+        const cyhal_clock_t *clock;
+        uint32_t frequency_hz;
+        cyhal_timer_cfg_t config;
+        bool running;
+        /* Counter value at start_time */
+        uint32_t start_value;
+        uint64_t start_time;
+        cyhal_timer_event_t events;
+        cyhal_timer_event_callback_t callback;
+        void *callback_arg;
+    } cyhal_timer_t;
+
+    cy_rslt_t cyhal_timer_init(cyhal_timer_t *obj, cyhal_gpio_t pin, const cyhal_clock_t *clk);
+    cy_rslt_t cyhal_timer_configure(cyhal_timer_t *obj, const cyhal_timer_cfg_t *cfg);
+    cy_rslt_t cyhal_timer_set_frequency(cyhal_timer_t *obj, uint32_t hz);
+    cy_rslt_t cyhal_timer_start(cyhal_timer_t *obj);
+    cy_rslt_t cyhal_timer_stop(cyhal_timer_t *obj);
+    cy_rslt_t cyhal_timer_reset(cyhal_timer_t *obj);
+    uint32_t cyhal_timer_read(const cyhal_timer_t *obj);
+    void cyhal_timer_register_callback(cyhal_timer_t *obj, cyhal_timer_event_callback_t callback, void *callback_arg);
+    void cyhal_timer_enable_event(cyhal_timer_t *obj, cyhal_timer_event_t event, uint8_t intr_priority, bool enable);
+
+    /***************************************************************************
+    * Low-power timer
+    ***************************************************************************/
+    typedef enum
+    {
+        CYHAL_LPTIMER_COMPARE_MATCH = 1,
+    } cyhal_lptimer_event_t;
+
+    typedef struct
+    {
+        uint32_t frequency_hz;
+        uint8_t min_set_delay;
+        uint32_t max_counter_value;
+    } cyhal_lptimer_info_t;
+
+    typedef void (*cyhal_lptimer_event_callback_t)(void *callback_arg, cyhal_lptimer_event_t event);
+
+    typedef struct
+    {
+        sim_device_t device;
+        bool enabled;
+        cyhal_lptimer_event_callback_t callback;
+        void *callback_arg;
+    } cyhal_lptimer_t;
+
+    cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj);
+    void cyhal_lptimer_get_info(cyhal_lptimer_t *obj, cyhal_lptimer_info_t *info);
+    uint32_t cyhal_lptimer_read(const cyhal_lptimer_t *obj);
+    cy_rslt_t cyhal_lptimer_set_delay(cyhal_lptimer_t *obj, uint32_t delay);
+    void cyhal_lptimer_register_callback(cyhal_lptimer_t *obj, cyhal_lptimer_event_callback_t callback, void *callback_arg);
+    void cyhal_lptimer_enable_event(cyhal_lptimer_t *obj, cyhal_lptimer_event_t event, uint8_t intr_priority, bool enable);
+
+    /***************************************************************************
+    * I2S
+    ***************************************************************************/
+    /* Entries of the TX FIFO */
+    #define CYHAL_I2S_FIFO_DEPTH            128u
+
+    typedef enum
+    {
+        CYHAL_I2S_TX_NOT_FULL           = 1u << 0,
+        CYHAL_I2S_TX_HALF_EMPTY         = 1u << 1,
+        CYHAL_I2S_TX_EMPTY              = 1u << 2,
+        CYHAL_I2S_TX_OVERFLOW           = 1u << 3,
+        CYHAL_I2S_TX_UNDERFLOW          = 1u << 4,
+        CYHAL_I2S_ASYNC_TX_COMPLETE     = 1u << 5,
+    } cyhal_i2s_event_t;
+
+    typedef struct
+    {
+        cyhal_gpio_t sck;
+        cyhal_gpio_t ws;
+        cyhal_gpio_t data;
+        cyhal_gpio_t mclk;
+    } cyhal_i2s_pins_t;
+
+    typedef struct
+    {
+        bool is_tx_slave;
+        bool is_rx_slave;
+        uint32_t mclk_hz;
+        uint8_t channel_length;
+        uint8_t word_length;
+        uint32_t sample_rate_hz;
+    } cyhal_i2s_config_t;
+
+    typedef void (*cyhal_i2s_event_callback_t)(void *callback_arg, cyhal_i2s_event_t event);
+
+    typedef struct
+    {
+        sim_device_t device;
+        uint8_t word_length;
+        uint32_t sample_rate_hz;
+        bool tx_running;
+        /* Frames clocked out since the rate anchor */
+        uint64_t frames;
+        uint64_t anchor_time;
+        /* TX FIFO */
+        uint32_t fifo[CYHAL_I2S_FIFO_DEPTH];
+        uint32_t fifo_read;
+        uint32_t fifo_count;
+        /* Asynchronous transfer */
+        const void *tx_data;
+        size_t tx_remaining;
+        cyhal_i2s_event_t events;
+        cyhal_i2s_event_t raised;
+        cyhal_i2s_event_callback_t callback;
+        void *callback_arg;
+    } cyhal_i2s_t;
+
+    cy_rslt_t cyhal_i2s_init(cyhal_i2s_t *obj, const cyhal_i2s_pins_t *tx_pins, const cyhal_i2s_pins_t *rx_pins,
+                             const cyhal_i2s_config_t *config, cyhal_clock_t *clk);
+    void cyhal_i2s_register_callback(cyhal_i2s_t *obj, cyhal_i2s_event_callback_t callback, void *callback_arg);
+    void cyhal_i2s_enable_event(cyhal_i2s_t *obj, cyhal_i2s_event_t event, uint8_t intr_priority, bool enable);
+    cy_rslt_t cyhal_i2s_set_sample_rate(cyhal_i2s_t *obj, uint32_t sample_rate_hz);
+    cy_rslt_t cyhal_i2s_start_tx(cyhal_i2s_t *obj);
+    cy_rslt_t cyhal_i2s_stop_tx(cyhal_i2s_t *obj);
+    cy_rslt_t cyhal_i2s_write_async(cyhal_i2s_t *obj, const void *tx, size_t tx_length);
+    bool cyhal_i2s_is_write_pending(cyhal_i2s_t *obj);
+
+    /***************************************************************************
+    * I2C master
+    ***************************************************************************/
+    typedef enum
+    {
+        CYHAL_I2C_EVENT_NONE            = 0,
+        CYHAL_I2C_MASTER_WR_CMPLT_EVENT = 1u << 16,
+        CYHAL_I2C_MASTER_RD_CMPLT_EVENT = 1u << 17,
+        CYHAL_I2C_MASTER_ERR_EVENT      = 1u << 18,
+    } cyhal_i2c_event_t;
+
+    typedef struct
+    {
+        bool is_slave;
+        uint16_t address;
+        uint32_t frequencyhal_hz;
+    } cyhal_i2c_cfg_t;
+
+    typedef void (*cyhal_i2c_event_callback_t)(void *callback_arg, cyhal_i2c_event_t event);
+
+    /* Bus clock until cyhal_i2c_configure() */
+    #define CYHAL_I2C_DEFAULT_HZ            100000u
+
+    typedef struct
+    {
+        sim_device_t device;
+        uint32_t frequency_hz;
+        /* Asynchronous transfer, done at the deadline of the device */
+        bool busy;
+        uint16_t address;
+        const uint8_t *tx_data;
+        size_t tx_size;
+        uint8_t *rx_data;
+        size_t rx_size;
+        cyhal_i2c_event_t events;
+        cyhal_i2c_event_t raised;
+        cyhal_i2c_event_callback_t callback;
+        void *callback_arg;
+    } cyhal_i2c_t;
+
+    cy_rslt_t cyhal_i2c_init(cyhal_i2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl, const cyhal_clock_t *clk);
+    cy_rslt_t cyhal_i2c_configure(cyhal_i2c_t *obj, const cyhal_i2c_cfg_t *cfg);
+    cy_rslt_t cyhal_i2c_master_write(cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size,
+                                     uint32_t timeout, bool send_stop);
+    cy_rslt_t cyhal_i2c_master_read(cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size,
+                                    uint32_t timeout, bool send_stop);
+    cy_rslt_t cyhal_i2c_master_transfer_async(cyhal_i2c_t *obj, uint16_t address, const void *tx, size_t tx_size,
+                                              void *rx, size_t rx_size);
+    void cyhal_i2c_register_callback(cyhal_i2c_t *obj, cyhal_i2c_event_callback_t callback, void *callback_arg);
+    void cyhal_i2c_enable_event(cyhal_i2c_t *obj, cyhal_i2c_event_t event, uint8_t intr_priority, bool enable);
+
+    /***************************************************************************
+    * System power management
+    ***************************************************************************/
+    typedef enum
+    {
+        CYHAL_SYSPM_CB_CPU_SLEEP        = 1u << 0,
+        CYHAL_SYSPM_CB_CPU_DEEPSLEEP    = 1u << 1,
+    } cyhal_syspm_callback_state_t;
+
+    typedef enum
+    {
+        CYHAL_SYSPM_CHECK_READY         = 1u << 0,
+        CYHAL_SYSPM_CHECK_FAIL          = 1u << 1,
+        CYHAL_SYSPM_BEFORE_TRANSITION   = 1u << 2,
+        CYHAL_SYSPM_AFTER_TRANSITION    = 1u << 3,
+    } cyhal_syspm_callback_mode_t;
+
+    typedef bool (*cyhal_syspm_callback_t)(cyhal_syspm_callback_state_t state,
+                                           cyhal_syspm_callback_mode_t mode, void *callback_arg);
+
+    typedef struct cyhal_syspm_callback_data
+    {
+        cyhal_syspm_callback_t callback;
+        cyhal_syspm_callback_state_t states;
+        cyhal_syspm_callback_mode_t ignore_modes;
+        void *args;
+        struct cyhal_syspm_callback_data *next;
+    } cyhal_syspm_callback_data_t;
+
+    void cyhal_syspm_register_callback(cyhal_syspm_callback_data_t *callback_data);
+    cy_rslt_t cyhal_syspm_sleep(void);
+    cy_rslt_t cyhal_syspm_deepsleep(void);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+################################################################################
+# \file golden.py
+# \version 1.0
+#
+# \brief
+# Bit-exact regression test of the playback pipeline. Runs the scenarios of
+# golden/scenarios.txt through the host simulator and compares the SHA-256 of
+# each I2S capture, and of the energy record of the clips played, with
+# golden/golden.sha256.
+#
+# A capture that matches is kept in build/golden/ref. When a capture differs,
+# it is compared with that reference: by tools/wavcmp.py for the I2S output,
+# which reports the first differing sample, and line by line for the energy
+# record. Run with --update to accept the current output.
+#
+# The glitch counters printed by the simulator are checked against the
+# expectation of each scenario: a clean scenario must report no glitch, and
+# a glitchy one late refills and FIFO underflows, so a broken detector fails
+# even though the I2S output is unchanged.
+#
+# The hashes are valid for the options of the host Makefile.
+#
+################################################################################
+# \copyright
+# Copyright 2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import difflib
+import glob
+import hashlib
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+
+HOST_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HOST_DIR, '..', 'tools'))
+
+import wavcmp  # noqa: E402
+
+# Glitch expectations of the scenarios
+EXPECTATIONS = ('clean', 'glitchy')
+GLITCH_REPORT = re.compile(r'^glitches\s+late refill (\d+), underflow (\d+), overflow (\d+)$', re.MULTILINE)
+
+
+def read_scenarios(path):
+    """Return the (name, expectation, arguments) of the scenarios, in file
+    order."""
+    scenarios = []
+    with open(path) as f:
+        for line in f:
+            words = shlex.split(line, comments=True)
+            if not words:
+                continue
+            if len(words) < 2 or words[1] not in EXPECTATIONS:
+                sys.exit('%s: %s: expected %s after the name' % (path, words[0], ' or '.join(EXPECTATIONS)))
+            scenarios.append((words[0], words[1], words[2:]))
+    return scenarios
+
+
+def read_hashes(path):
+    """Return the golden hashes by capture file name."""
+    hashes = {}
+    if os.path.exists(path):
+        with open(path) as f:
+            for line in f:
+                words = line.split()
+                if len(words) == 2:
+                    hashes[words[1]] = words[0]
+    return hashes
+
+
+def sha256(path):
+    with open(path, 'rb') as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+
+def run(sim, out_dir, name, arguments):
+    """Run a scenario and return its capture files and its report. A change
+    of the output format during the run starts a new file, <name>.1.wav and
+    so on; the energy record of the clips is <name>.energy.csv."""
+    for path in glob.glob(os.path.join(out_dir, name + '.*wav')) + glob.glob(os.path.join(out_dir, name + '.*csv')):
+        os.remove(path)
+    output = os.path.join(out_dir, name + '.wav')
+    energy = os.path.join(out_dir, name + '.energy.csv')
+    result = subprocess.run([sim, '-o', output, '-e', energy] + arguments, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        raise RuntimeError('%s failed:\n%s' % (name, result.stdout))
+    captures = sorted(glob.glob(os.path.join(out_dir, name + '.wav')) +
+                      glob.glob(os.path.join(out_dir, name + '.[0-9]*.wav'))) + [energy]
+    return captures, result.stdout
+
+
+def check_glitches(name, expectation, report):
+    """Check the glitch counters of the report against the expectation of
+    the scenario. Return the number of failures."""
+    match = GLITCH_REPORT.search(report)
+    if match is None:
+        print('FAIL %s: no glitch counters in the report' % name)
+        return 1
+
+    late, underflow, overflow = (int(count) for count in match.groups())
+    counts = 'late refill %d, underflow %d, overflow %d' % (late, underflow, overflow)
+    if expectation == 'clean':
+        passed = (late == 0) and (underflow == 0) and (overflow == 0)
+    else:
+        passed = (late > 0) and (underflow > 0)
+    print('%s %s: %s (%s)' % ('ok  ' if passed else 'FAIL', name, expectation, counts))
+    return 0 if passed else 1
+
+
+def compare_text(ref, path):
+    """Print the lines of a text capture that differ from the reference."""
+    with open(ref) as f:
+        expected = f.readlines()
+    with open(path) as f:
+        actual = f.readlines()
+    for line in difflib.unified_diff(expected, actual, ref, path, n=0):
+        print('     ' + line.rstrip('\n'))
+
+
+def check(name, captures, golden, ref_dir):
+    """Compare the captures of a scenario with their golden hashes. Return
+    the number of failures."""
+    failures = 0
+    produced = set(os.path.basename(path) for path in captures)
+    for missing in sorted(f for f in golden if f.startswith(name + '.') and f not in produced):
+        print('FAIL %s: %s was not produced' % (name, missing))
+        failures += 1
+
+    for path in captures:
+        file = os.path.basename(path)
+        ref = os.path.join(ref_dir, file)
+        if file not in golden:
+            print('FAIL %s: no golden hash for %s, run with --update' % (name, file))
+            failures += 1
+        elif sha256(path) == golden[file]:
+            print('ok   %s' % file)
+            shutil.copyfile(path, ref)
+        else:
+            print('FAIL %s: %s differs from the golden output' % (name, file))
+            if os.path.exists(ref) and file.endswith('.wav'):
+                wavcmp.compare(ref, path)
+            elif os.path.exists(ref):
+                compare_text(ref, path)
+            else:
+                print('     no reference capture in %s: run golden.py on a passing tree first' % ref_dir)
+            failures += 1
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check the simulator output against golden hashes.')
+    parser.add_argument('--sim', default=os.path.join(HOST_DIR, 'audio_sim'), help='simulator binary')
+    parser.add_argument('--out-dir', default=os.path.join(HOST_DIR, 'build', 'golden'),
+                        help='directory of the captures (default: build/golden)')
+    parser.add_argument('--update', action='store_true', help='accept the current output as golden')
+    parser.add_argument('scenario', nargs='*', help='scenarios to run (default: all)')
+    args = parser.parse_args()
+
+    golden_dir = os.path.join(HOST_DIR, 'golden')
+    hashes_path = os.path.join(golden_dir, 'golden.sha256')
+    ref_dir = os.path.join(args.out_dir, 'ref')
+    os.makedirs(ref_dir, exist_ok=True)
+
+    scenarios = read_scenarios(os.path.join(golden_dir, 'scenarios.txt'))
+    unknown = set(args.scenario) - set(name for name, _, _ in scenarios)
+    if unknown:
+        sys.exit('unknown scenario: %s' % ', '.join(sorted(unknown)))
+
+    golden = read_hashes(hashes_path)
+    failures = 0
+    for name, expectation, arguments in scenarios:
+        if args.scenario and name not in args.scenario:
+            continue
+        try:
+            captures, report = run(args.sim, args.out_dir, name, arguments)
+        except RuntimeError as error:
+            print('FAIL %s' % error)
+            failures += 1
+            continue
+
+        failures += check_glitches(name, expectation, report)
+
+        if args.update:
+            for file in [f for f in golden if f.startswith(name + '.')]:
+                del golden[file]
+            for path in captures:
+                golden[os.path.basename(path)] = sha256(path)
+                shutil.copyfile(path, os.path.join(ref_dir, os.path.basename(path)))
+                print('updated %s' % os.path.basename(path))
+        else:
+            failures += check(name, captures, golden, ref_dir)
+
+    if args.update:
+        with open(hashes_path, 'w') as f:
+            for file in sorted(golden):
+                f.write('%s  %s\n' % (golden[file], file))
+    if failures:
+        print('%d failures' % failures)
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,58 @@
+/*****************************************************************************
+* File Name: mtb_ak4954a.h
+*
+* Description: This file contains the register addresses of the AK4954A driver
+*              library used by the codec command queue on the host. The driver
+*              itself is not simulated: the register writes go to the device
+*              attached to the simulated I2C (see sim_i2c_attach()).
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MTB_AK4954A_H
+    #define MTB_AK4954A_H
+
+    #include "cyhal.h"
+
+    typedef enum
+    {
+        AK4954A_REG_PWR_MGMT1   = 0x00,
+        AK4954A_REG_PWR_MGMT2   = 0x01,
+        AK4954A_REG_MODE_CTRL1  = 0x05,
+        AK4954A_REG_MODE_CTRL2  = 0x06,
+        AK4954A_REG_MODE_CTRL3  = 0x07,
+    } mtb_ak4954a_reg_t;
+
+#endif
+
+/* [] END OF FILE */
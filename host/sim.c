@@ -0,0 +1,539 @@
+/*****************************************************************************
+* File Name: sim.c
+*
+* Description: This file contains the virtual clock of the host simulator. Time
+*              only advances when the application waits: in a delay, or in the
+*              sleep modes, where it jumps to the next hardware event. Each
+*              device schedules its next hardware event; an event may raise an
+*              interrupt, whose ISR runs as soon as the interrupt mask and the
+*              priority of the running code allow, as on the Cortex-M4. The run
+*              is deterministic: it does not depend on the host speed.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static sim_device_t *sim_next_event(uint64_t until);
+static void sim_step(sim_device_t *device);
+static bool sim_is_pending(void);
+static bool sim_dispatch(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Virtual time in ns */
+static uint64_t sim_time;
+/* The run ends when the application waits past this time */
+static uint64_t sim_end_time;
+static bool sim_verbose;
+static sim_device_t *sim_devices;
+/* Interrupts masked (PRIMASK) */
+static bool sim_masked;
+/* Priority of the running code */
+static uint8_t sim_priority;
+/* Set in Deep Sleep: only the devices that keep running advance */
+static bool sim_deep_sleep;
+static sim_stats_t sim_stats;
+static sim_idle_hook_t sim_idle_hook;
+
+/*******************************************************************************
+* Function Name: sim_init
+********************************************************************************
+* Summary:
+*  Reset the virtual clock. Called before the application starts.
+*
+* Parameters:
+*  end_time: virtual time at which the run ends, in ns
+*  verbose: log the activity of the devices
+*
+*******************************************************************************/
+void sim_init(uint64_t end_time, bool verbose)
+{
+    sim_time       = 0;
+    sim_end_time   = end_time;
+    sim_verbose    = verbose;
+    sim_devices    = NULL;
+    sim_masked     = false;
+    sim_priority   = SIM_THREAD_PRIORITY;
+    sim_deep_sleep = false;
+    sim_idle_hook  = NULL;
+
+    memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+/*******************************************************************************
+* Function Name: sim_now
+********************************************************************************
+* Summary:
+*  Get the virtual time.
+*
+* Return:
+*  uint64_t: time in ns since the start
+*
+*******************************************************************************/
+uint64_t sim_now(void)
+{
+    return sim_time;
+}
+
+/*******************************************************************************
+* Function Name: sim_register
+********************************************************************************
+* Summary:
+*  Add a device to the simulation, without hardware event or interrupt. The
+*  caller sets the handlers. Registering a device again resets it.
+*
+* Parameters:
+*  device: device, kept by the caller
+*  name: name of the device in the logs
+*
+*******************************************************************************/
+void sim_register(sim_device_t *device, const char *name)
+{
+    sim_device_t *other;
+
+    device->name       = name;
+    device->deadline   = SIM_NEVER;
+    device->pending    = false;
+    device->priority   = CYHAL_ISR_PRIORITY_DEFAULT;
+    device->deep_sleep = false;
+    device->interrupts = 0;
+
+    for (other = sim_devices; other != NULL; other = other->next)
+    {
+        if (other == device)
+        {
+            return;
+        }
+    }
+
+    device->next = sim_devices;
+    sim_devices  = device;
+}
+
+/*******************************************************************************
+* Function Name: sim_raise
+********************************************************************************
+* Summary:
+*  Request the interrupt of a device. Requests are not counted: an interrupt
+*  raised again before its ISR runs is served once.
+*
+* Parameters:
+*  device: device raising its interrupt
+*
+*******************************************************************************/
+void sim_raise(sim_device_t *device)
+{
+    device->pending = true;
+}
+
+/*******************************************************************************
+* Function Name: sim_advance
+********************************************************************************
+* Summary:
+*  Busy-wait: advance the virtual time while the hardware keeps running and
+*  the ISRs preempt the caller.
+*
+* Parameters:
+*  ns: time to wait
+*
+*******************************************************************************/
+void sim_advance(uint64_t ns)
+{
+    uint64_t target = sim_time + ns;
+    sim_device_t *device;
+
+    while ((device = sim_next_event(target)) != NULL)
+    {
+        sim_step(device);
+        sim_dispatch();
+    }
+
+    /* An ISR that busy-waited may have moved the time past the target */
+    if (sim_time < target)
+    {
+        sim_time = target;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_wait
+********************************************************************************
+* Summary:
+*  Wait for an interrupt (WFI). The time jumps from one hardware event to the
+*  next until an interrupt is raised. Its ISR runs before this function
+*  returns, unless the interrupts are masked. When no event is left before
+*  the end time, the run ends.
+*
+* Parameters:
+*  deep_sleep: only the devices that run in Deep Sleep advance
+*
+*******************************************************************************/
+void sim_wait(bool deep_sleep)
+{
+    uint64_t start = sim_time;
+    sim_device_t *device;
+
+    if (sim_idle_hook != NULL)
+    {
+        sim_idle_hook();
+    }
+
+    sim_deep_sleep = deep_sleep;
+
+    while (!sim_is_pending())
+    {
+        device = sim_next_event(sim_end_time);
+        if (device == NULL)
+        {
+            sim_finish();
+        }
+        sim_step(device);
+    }
+
+    sim_deep_sleep = false;
+
+    if (deep_sleep)
+    {
+        sim_stats.deep_sleeps++;
+        sim_stats.deep_sleep_ns += sim_time - start;
+    }
+    else
+    {
+        sim_stats.sleeps++;
+        sim_stats.sleep_ns += sim_time - start;
+    }
+
+    sim_dispatch();
+}
+
+/*******************************************************************************
+* Function Name: sim_set_idle_hook
+********************************************************************************
+* Summary:
+*  Set the function called before each wait for an interrupt, NULL for none.
+*
+*******************************************************************************/
+void sim_set_idle_hook(sim_idle_hook_t hook)
+{
+    sim_idle_hook = hook;
+}
+
+/*******************************************************************************
+* Function Name: sim_finish
+********************************************************************************
+* Summary:
+*  End the run. The exit handlers close the sinks and print the report.
+*
+*******************************************************************************/
+void sim_finish(void)
+{
+    sim_log("end of the run");
+    exit(EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+* Function Name: sim_fail
+********************************************************************************
+* Summary:
+*  Abort the run on an error of the application or of the simulator.
+*
+* Parameters:
+*  format: printf format of the message, followed by its arguments
+*
+*******************************************************************************/
+void sim_fail(const char *format, ...)
+{
+    va_list args;
+
+    fprintf(stderr, "%12.3f ms  error: ", (double) sim_time / SIM_NS_PER_MS);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+
+    exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************
+* Function Name: sim_log
+********************************************************************************
+* Summary:
+*  Log a line with the virtual time, in verbose mode only.
+*
+* Parameters:
+*  format: printf format of the message, followed by its arguments
+*
+*******************************************************************************/
+void sim_log(const char *format, ...)
+{
+    va_list args;
+
+    if (!sim_verbose)
+    {
+        return;
+    }
+
+    printf("%12.3f ms  ", (double) sim_time / SIM_NS_PER_MS);
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    putchar('\n');
+}
+
+/*******************************************************************************
+* Function Name: sim_on_frame
+********************************************************************************
+* Summary:
+*  Count a frame clocked out of the I2S.
+*
+* Parameters:
+*  underflow: the TX FIFO was empty
+*
+*******************************************************************************/
+void sim_on_frame(bool underflow)
+{
+    sim_stats.frames++;
+    if (underflow)
+    {
+        sim_stats.underflow_frames++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_get_stats
+********************************************************************************
+* Summary:
+*  Get the run counters.
+*
+* Parameters:
+*  stats: filled with the counters
+*
+*******************************************************************************/
+void sim_get_stats(sim_stats_t *stats)
+{
+    *stats = sim_stats;
+}
+
+/*******************************************************************************
+* Function Name: sim_irq_disable
+********************************************************************************
+* Summary:
+*  Mask the interrupts.
+*
+* Return:
+*  uint32_t: previous mask, for sim_irq_restore()
+*
+*******************************************************************************/
+uint32_t sim_irq_disable(void)
+{
+    uint32_t state = sim_masked ? 1u : 0u;
+
+    sim_masked = true;
+
+    return state;
+}
+
+/*******************************************************************************
+* Function Name: sim_irq_restore
+********************************************************************************
+* Summary:
+*  Restore the interrupt mask. The interrupts raised while they were masked
+*  are served on unmasking.
+*
+* Parameters:
+*  state: mask returned by sim_irq_disable(), 0 to unmask
+*
+*******************************************************************************/
+void sim_irq_restore(uint32_t state)
+{
+    sim_masked = (state != 0u);
+
+    sim_dispatch();
+}
+
+/*******************************************************************************
+* Function Name: sim_ticks_to_ns
+********************************************************************************
+* Summary:
+*  Convert ticks of a clock to ns, rounded up: a counter has reached the
+*  tick at the returned time.
+*
+*******************************************************************************/
+uint64_t sim_ticks_to_ns(uint64_t ticks, uint32_t hz)
+{
+    return (uint64_t) ((((unsigned __int128) ticks * SIM_NS_PER_S) + hz - 1u) / hz);
+}
+
+/*******************************************************************************
+* Function Name: sim_ns_to_ticks
+********************************************************************************
+* Summary:
+*  Convert ns to the number of ticks of a clock elapsed.
+*
+*******************************************************************************/
+uint64_t sim_ns_to_ticks(uint64_t ns, uint32_t hz)
+{
+    return (uint64_t) (((unsigned __int128) ns * hz) / SIM_NS_PER_S);
+}
+
+/*******************************************************************************
+* Function Name: sim_next_event
+********************************************************************************
+* Summary:
+*  Find the device with the earliest hardware event, up to a time. Devices
+*  registered first win a tie, so the order of the events is reproducible.
+*
+*******************************************************************************/
+static sim_device_t *sim_next_event(uint64_t until)
+{
+    sim_device_t *next = NULL;
+    sim_device_t *device;
+
+    for (device = sim_devices; device != NULL; device = device->next)
+    {
+        if ((sim_deep_sleep && !device->deep_sleep) || (device->deadline > until))
+        {
+            continue;
+        }
+        if ((next == NULL) || (device->deadline <= next->deadline))
+        {
+            next = device;
+        }
+    }
+
+    return next;
+}
+
+/*******************************************************************************
+* Function Name: sim_step
+********************************************************************************
+* Summary:
+*  Advance the time to the hardware event of a device and run it.
+*
+*******************************************************************************/
+static void sim_step(sim_device_t *device)
+{
+    if (device->deadline > sim_time)
+    {
+        sim_time = device->deadline;
+    }
+    device->deadline = SIM_NEVER;
+    device->on_deadline(device);
+}
+
+/*******************************************************************************
+* Function Name: sim_is_pending
+********************************************************************************
+* Summary:
+*  Check if an interrupt is raised. A raised interrupt wakes-up the CPU even
+*  if the interrupts are masked.
+*
+*******************************************************************************/
+static bool sim_is_pending(void)
+{
+    sim_device_t *device;
+
+    for (device = sim_devices; device != NULL; device = device->next)
+    {
+        if (device->pending)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: sim_dispatch
+********************************************************************************
+* Summary:
+*  Run the ISRs of the raised interrupts that have a higher priority than the
+*  running code, highest first. An ISR is preempted in the same way when it
+*  unmasks the interrupts or waits.
+*
+* Return:
+*  bool: true if an ISR ran
+*
+*******************************************************************************/
+static bool sim_dispatch(void)
+{
+    sim_device_t *device;
+    sim_device_t *next;
+    uint8_t priority;
+    bool served = false;
+
+    while (!sim_masked)
+    {
+        next = NULL;
+        for (device = sim_devices; device != NULL; device = device->next)
+        {
+            if (device->pending && (device->priority < sim_priority) &&
+                ((next == NULL) || (device->priority <= next->priority)))
+            {
+                next = device;
+            }
+        }
+        if (next == NULL)
+        {
+            break;
+        }
+
+        next->pending = false;
+        next->interrupts++;
+        sim_stats.interrupts++;
+
+        priority     = sim_priority;
+        sim_priority = next->priority;
+        next->on_interrupt(next);
+        sim_priority = priority;
+        /* The ISR returns with the interrupts unmasked */
+        sim_masked   = false;
+
+        served = true;
+    }
+
+    return served;
+}
+
+/* [] END OF FILE */
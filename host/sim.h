@@ -0,0 +1,102 @@
+/*****************************************************************************
+* File Name: sim.h
+*
+* Description: This file contains the definitions of the virtual clock of the
+*              host simulator: the simulated devices, their interrupts, and the
+*              sleep modes.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SIM_H
+    #define SIM_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    #include "cyhal.h"
+
+    /* Deadline of a device without a pending hardware event */
+    #define SIM_NEVER               UINT64_MAX
+    /* Priority of the thread mode, below all interrupts */
+    #define SIM_THREAD_PRIORITY     8u
+
+    #define SIM_NS_PER_S            1000000000u
+    #define SIM_NS_PER_MS           1000000u
+    #define SIM_NS_PER_US           1000u
+
+    /* Run counters of the simulator */
+    typedef struct
+    {
+        uint32_t interrupts;        /* ISRs run */
+        uint32_t sleeps;            /* Sleep entries */
+        uint32_t deep_sleeps;       /* Deep Sleep entries */
+        uint64_t sleep_ns;          /* Time spent in Sleep */
+        uint64_t deep_sleep_ns;     /* Time spent in Deep Sleep */
+        uint64_t frames;            /* Frames clocked out of the I2S */
+        uint64_t underflow_frames;  /* Frames played from an empty TX FIFO */
+    } sim_stats_t;
+
+    /* Device on the I2C bus, see sim_i2c_attach(). The handlers return false
+    *  to NACK the transfer. */
+    typedef struct
+    {
+        uint16_t address;
+        bool (*on_write)(const uint8_t *data, size_t size);
+        bool (*on_read)(uint8_t *data, size_t size);
+    } sim_i2c_slave_t;
+
+    /* Called each time the application waits for an interrupt */
+    typedef void (*sim_idle_hook_t)(void);
+
+    void sim_init(uint64_t end_time, bool verbose);
+    uint64_t sim_now(void);
+    void sim_register(sim_device_t *device, const char *name);
+    void sim_raise(sim_device_t *device);
+    void sim_advance(uint64_t ns);
+    void sim_wait(bool deep_sleep);
+    void sim_set_idle_hook(sim_idle_hook_t hook);
+    void sim_finish(void);
+    void sim_get_stats(sim_stats_t *stats);
+    void sim_log(const char *format, ...);
+    void sim_on_frame(bool underflow);
+
+    /* Helpers of the HAL and the sinks, see sim_hal.c and sim_wav.c */
+    uint64_t sim_ticks_to_ns(uint64_t ticks, uint32_t hz);
+    uint64_t sim_ns_to_ticks(uint64_t ns, uint32_t hz);
+    void sim_gpio_drive(cyhal_gpio_t pin, bool level);
+    void sim_i2c_attach(const sim_i2c_slave_t *slave);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,1784 @@
+/*****************************************************************************
+* File Name: sim_hal.c
+*
+* Description: This file contains the HAL functions of the host simulator: the
+*              clock tree, the GPIOs, the PWM, the timers, the low-power timer,
+*              the I2S TX and the power modes, against the virtual clock of
+*              sim.c. The I2S clocks one frame out of its TX FIFO per sample
+*              period into the WAV sink.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cyhal.h"
+#include "cybsp.h"
+#include "sim.h"
+#include "sim_wav.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Channels per clock block in the clock table */
+#define SIM_CLOCK_CHANNELS      16u
+#define SIM_CLOCK_INDEX(block, channel) (((uint32_t) (block) * SIM_CLOCK_CHANNELS) + (channel))
+#define SIM_CLOCK_COUNT         SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_PERIPHERAL_16BIT + 1u, 0u)
+/* Clock without a source */
+#define SIM_CLOCK_ROOT          (-1)
+/* PLLs, on clock paths 1 and up */
+#define SIM_PLL_COUNT           2u
+
+/* Low-power timer (LFCLK from the WCO) */
+#define SIM_LPTIMER_HZ          32768u
+#define SIM_LPTIMER_MIN_DELAY   3u
+/* Frequency of a timer that has no clock */
+#define SIM_TIMER_DEFAULT_HZ    1000000u
+
+/* Words in the TX FIFO under which the HAL refills it */
+#define SIM_I2S_FIFO_TRIGGER    (CYHAL_I2S_FIFO_DEPTH / 2u)
+/* Bits of an I2C byte with its acknowledge */
+#define SIM_I2C_BYTE_BITS       9u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t sim_clock_hz(uint32_t index);
+static void sim_cycles_update(void);
+static void sim_gpio_isr(sim_device_t *device);
+static void sim_timer_schedule(cyhal_timer_t *obj);
+static void sim_timer_tick(sim_device_t *device);
+static void sim_timer_isr(sim_device_t *device);
+static void sim_lptimer_match(sim_device_t *device);
+static void sim_lptimer_isr(sim_device_t *device);
+static void sim_i2s_raise(cyhal_i2s_t *obj, cyhal_i2s_event_t events);
+static void sim_i2s_fill(cyhal_i2s_t *obj);
+static void sim_i2s_schedule(cyhal_i2s_t *obj);
+static void sim_i2s_frame(sim_device_t *device);
+static void sim_i2s_isr(sim_device_t *device);
+static uint64_t sim_i2c_duration(const cyhal_i2c_t *obj, size_t tx_size, size_t rx_size);
+static bool sim_i2c_exchange(uint16_t address, const uint8_t *tx, size_t tx_size, uint8_t *rx, size_t rx_size);
+static void sim_i2c_done(sim_device_t *device);
+static void sim_i2c_isr(sim_device_t *device);
+static bool sim_syspm_notify(cyhal_syspm_callback_data_t *last, cyhal_syspm_callback_mode_t mode);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* State of a clock of the clock tree */
+typedef struct
+{
+    uint32_t hz;                /* Frequency of a root clock */
+    int32_t source;             /* Index of the source, or SIM_CLOCK_ROOT */
+    uint32_t divider;           /* 0 is taken as 1 */
+    bool enabled;
+    bool allocated;             /* Peripheral divider in use */
+} sim_clock_t;
+
+/* State of a pin */
+typedef struct
+{
+    bool level;
+    bool output;
+    cyhal_gpio_event_t events;
+    cyhal_gpio_event_t raised;
+    cyhal_gpio_callback_data_t *callback_data;
+} sim_gpio_t;
+
+const cyhal_clock_t CYHAL_CLOCK_IMO = { CYHAL_CLOCK_BLOCK_IMO, 0u, false };
+const cyhal_clock_t CYHAL_CLOCK_FLL = { CYHAL_CLOCK_BLOCK_FLL, 0u, false };
+const cyhal_clock_t CYHAL_CLOCK_PLL[2] =
+{
+    { CYHAL_CLOCK_BLOCK_PLL, 0u, false },
+    { CYHAL_CLOCK_BLOCK_PLL, 1u, false },
+};
+const cyhal_clock_t CYHAL_CLOCK_HF[5] =
+{
+    { CYHAL_CLOCK_BLOCK_HF, 0u, false },
+    { CYHAL_CLOCK_BLOCK_HF, 1u, false },
+    { CYHAL_CLOCK_BLOCK_HF, 2u, false },
+    { CYHAL_CLOCK_BLOCK_HF, 3u, false },
+    { CYHAL_CLOCK_BLOCK_HF, 4u, false },
+};
+const cyhal_clock_t CYHAL_CLOCK_FAST = { CYHAL_CLOCK_BLOCK_FAST, 0u, false };
+const cyhal_clock_t CYHAL_CLOCK_PERI = { CYHAL_CLOCK_BLOCK_PERI, 0u, false };
+
+/* Clock tree after the BSP initialization. The clocks left out are sourced
+*  by the IMO (index 0) */
+static sim_clock_t sim_clocks[SIM_CLOCK_COUNT] =
+{
+    [SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_IMO, 0u)]  = { .hz = 8000000u, .source = SIM_CLOCK_ROOT, .enabled = true },
+    [SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_FLL, 0u)]  = { .hz = 100000000u, .source = SIM_CLOCK_ROOT, .enabled = true },
+    [SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_PLL, 0u)]  = { .hz = 0u, .source = SIM_CLOCK_ROOT },
+    [SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_PLL, 1u)]  = { .hz = 0u, .source = SIM_CLOCK_ROOT },
+    [SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_HF, 0u)]   = { .source = SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_FLL, 0u), .enabled = true },
+    [SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_FAST, 0u)] = { .source = SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_HF, 0u), .enabled = true },
+    [SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_PERI, 0u)] = { .source = SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_HF, 0u), .divider = 2u, .enabled = true },
+};
+
+/* Dividers of the PLLs, set by Cy_SysClk_PllManualConfigure() */
+static cy_stc_pll_manual_config_t sim_pll_configs[SIM_PLL_COUNT];
+
+static sim_gpio_t sim_gpios[CYHAL_GPIO_COUNT];
+static sim_device_t sim_gpio_device;
+static bool sim_gpio_init;
+
+/* Counters allocated by cyhal_timer_init() */
+static uint32_t sim_timer_count;
+
+/* CPU cycles counted up to sim_cycles_awake_ns of awake time, and the
+*  fraction of a cycle left, in Hz x ns */
+static uint64_t sim_cycles;
+static uint64_t sim_cycles_awake_ns;
+static uint64_t sim_cycles_remainder;
+
+/* Device on the I2C bus, NULL when none */
+static const sim_i2c_slave_t *sim_i2c_slave;
+
+static cyhal_syspm_callback_data_t *sim_syspm_callbacks;
+
+/*******************************************************************************
+* Function Name: cybsp_init
+********************************************************************************
+* Summary:
+*  Initialize the board. The clock tree starts from its static state.
+*
+*******************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: NVIC_SystemReset
+********************************************************************************
+* Summary:
+*  A reset ends the run with an error.
+*
+*******************************************************************************/
+void NVIC_SystemReset(void)
+{
+    sim_fail("system reset");
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_enter
+********************************************************************************
+* Summary:
+*  Mask the interrupts.
+*
+*******************************************************************************/
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    return sim_irq_disable();
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_exit
+********************************************************************************
+* Summary:
+*  Restore the interrupt mask.
+*
+*******************************************************************************/
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+    sim_irq_restore(old_state);
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_delay_ms
+********************************************************************************
+* Summary:
+*  Busy-wait in virtual time.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_system_delay_ms(uint32_t milliseconds)
+{
+    sim_advance((uint64_t) milliseconds * SIM_NS_PER_MS);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_delay_us
+********************************************************************************
+* Summary:
+*  Busy-wait in virtual time.
+*
+*******************************************************************************/
+void cyhal_system_delay_us(uint16_t microseconds)
+{
+    sim_advance((uint64_t) microseconds * SIM_NS_PER_US);
+}
+
+/*******************************************************************************
+* Function Name: cyhal_clock_reserve
+********************************************************************************
+* Summary:
+*  Get a reference to a clock of the clock tree.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_clock_reserve(cyhal_clock_t *clock, const cyhal_clock_t *clock_)
+{
+    *clock = *clock_;
+    clock->reserved = true;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_clock_allocate
+********************************************************************************
+* Summary:
+*  Allocate a peripheral clock divider, sourced by CLK_PERI.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_clock_allocate(cyhal_clock_t *clock, cyhal_clock_block_t block)
+{
+    sim_clock_t *state;
+
+    if (block != CYHAL_CLOCK_BLOCK_PERIPHERAL_16BIT)
+    {
+        sim_fail("clock block %d cannot be allocated", (int) block);
+    }
+
+    for (uint8_t channel = 0; channel < SIM_CLOCK_CHANNELS; channel++)
+    {
+        state = &sim_clocks[SIM_CLOCK_INDEX(block, channel)];
+        if (!state->allocated)
+        {
+            state->allocated = true;
+            state->source    = SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_PERI, 0u);
+            state->divider   = 1u;
+            clock->block     = block;
+            clock->channel   = channel;
+            clock->reserved  = true;
+            return CY_RSLT_SUCCESS;
+        }
+    }
+
+    return CYHAL_RSLT_ERR_BUSY;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_clock_get_frequency
+********************************************************************************
+* Summary:
+*  Get the frequency of a clock from the clock tree.
+*
+*******************************************************************************/
+uint32_t cyhal_clock_get_frequency(const cyhal_clock_t *clock)
+{
+    return sim_clock_hz(SIM_CLOCK_INDEX(clock->block, clock->channel));
+}
+
+/*******************************************************************************
+* Function Name: cyhal_clock_set_frequency
+********************************************************************************
+* Summary:
+*  Set the frequency of a root clock, or the closest divider of a divided
+*  clock. The tolerance is not checked.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_clock_set_frequency(cyhal_clock_t *clock, uint32_t hz,
+                                    const cyhal_clock_tolerance_t *tolerance)
+{
+    sim_clock_t *state = &sim_clocks[SIM_CLOCK_INDEX(clock->block, clock->channel)];
+    uint32_t source_hz;
+
+    (void) tolerance;
+
+    sim_cycles_update();
+    if (state->source == SIM_CLOCK_ROOT)
+    {
+        state->hz = hz;
+    }
+    else
+    {
+        source_hz = sim_clock_hz((uint32_t) state->source);
+        state->divider = (source_hz + (hz / 2u)) / hz;
+    }
+    sim_log("clock %d.%u: %lu Hz", (int) clock->block, clock->channel,
+            (unsigned long) cyhal_clock_get_frequency(clock));
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_clock_set_divider
+********************************************************************************
+* Summary:
+*  Set the divider of a clock.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_clock_set_divider(cyhal_clock_t *clock, uint32_t divider)
+{
+    sim_cycles_update();
+    sim_clocks[SIM_CLOCK_INDEX(clock->block, clock->channel)].divider = divider;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_clock_set_source
+********************************************************************************
+* Summary:
+*  Set the source of a clock.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_clock_set_source(cyhal_clock_t *clock, const cyhal_clock_t *source)
+{
+    sim_cycles_update();
+    sim_clocks[SIM_CLOCK_INDEX(clock->block, clock->channel)].source =
+        (int32_t) SIM_CLOCK_INDEX(source->block, source->channel);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_clock_set_enabled
+********************************************************************************
+* Summary:
+*  Enable or disable a clock. A PLL locks at once.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_clock_set_enabled(cyhal_clock_t *clock, bool enabled, bool wait_for_lock)
+{
+    (void) wait_for_lock;
+
+    sim_cycles_update();
+    sim_clocks[SIM_CLOCK_INDEX(clock->block, clock->channel)].enabled = enabled;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysClk_PllDisable
+********************************************************************************
+* Summary:
+*  Disable a PLL. Its output follows the reference (IMO) until it is enabled.
+*
+*******************************************************************************/
+cy_en_sysclk_status_t Cy_SysClk_PllDisable(uint32_t clkPath)
+{
+    sim_clock_t *state;
+
+    if ((clkPath < 1u) || (clkPath > SIM_PLL_COUNT))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+
+    sim_cycles_update();
+    state = &sim_clocks[SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_PLL, clkPath - 1u)];
+    state->hz = sim_clock_hz(SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_IMO, 0u));
+
+    return CY_SYSCLK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysClk_PllManualConfigure
+********************************************************************************
+* Summary:
+*  Store the dividers of a disabled PLL, within the limits of the device.
+*
+*******************************************************************************/
+cy_en_sysclk_status_t Cy_SysClk_PllManualConfigure(uint32_t clkPath, const cy_stc_pll_manual_config_t *config)
+{
+    if ((clkPath < 1u) || (clkPath > SIM_PLL_COUNT) ||
+        (config->feedbackDiv < 22u) || (config->feedbackDiv > 112u) ||
+        (config->referenceDiv < 1u) || (config->referenceDiv > 20u) ||
+        (config->outputDiv < 2u) || (config->outputDiv > 16u))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+
+    sim_pll_configs[clkPath - 1u] = *config;
+
+    return CY_SYSCLK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysClk_PllEnable
+********************************************************************************
+* Summary:
+*  Enable a PLL with its stored dividers. It locks at once; the frequency is
+*  truncated to 1 Hz, like the HAL reports it.
+*
+*******************************************************************************/
+cy_en_sysclk_status_t Cy_SysClk_PllEnable(uint32_t clkPath, uint32_t timeoutus)
+{
+    const cy_stc_pll_manual_config_t *config;
+    sim_clock_t *state;
+    uint64_t ref_hz;
+
+    (void) timeoutus;
+
+    if ((clkPath < 1u) || (clkPath > SIM_PLL_COUNT))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+
+    config = &sim_pll_configs[clkPath - 1u];
+    if (config->feedbackDiv == 0u)
+    {
+        return CY_SYSCLK_INVALID_STATE;
+    }
+
+    sim_cycles_update();
+    ref_hz = sim_clock_hz(SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_IMO, 0u));
+    state = &sim_clocks[SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_PLL, clkPath - 1u)];
+    state->hz = (uint32_t) ((ref_hz * config->feedbackDiv) /
+                            ((uint64_t) config->referenceDiv * config->outputDiv));
+    state->enabled = true;
+    sim_log("clock %d.%u: %lu Hz (P %u, Q %u, output divider %u)", (int) CYHAL_CLOCK_BLOCK_PLL,
+            (unsigned int) (clkPath - 1u), (unsigned long) state->hz, config->feedbackDiv,
+            config->referenceDiv, config->outputDiv);
+
+    return CY_SYSCLK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: sim_clock_hz
+********************************************************************************
+* Summary:
+*  Compute the frequency of a clock from its sources.
+*
+*******************************************************************************/
+static uint32_t sim_clock_hz(uint32_t index)
+{
+    const sim_clock_t *state = &sim_clocks[index];
+
+    if (state->source == SIM_CLOCK_ROOT)
+    {
+        return state->hz;
+    }
+
+    return sim_clock_hz((uint32_t) state->source) / ((state->divider != 0u) ? state->divider : 1u);
+}
+
+/*******************************************************************************
+* Function Name: sim_cycle_counter
+********************************************************************************
+* Summary:
+*  Cycle counter of the simulated CPU (DWT CYCCNT). It counts CLK_FAST while
+*  the CPU is awake, in virtual time: the code itself runs in zero time, so
+*  only the busy-waits and the ISRs that busy-wait are counted.
+*
+* Return:
+*  uint32_t: CPU cycles
+*
+*******************************************************************************/
+uint32_t sim_cycle_counter(void)
+{
+    sim_cycles_update();
+
+    return (uint32_t) sim_cycles;
+}
+
+/*******************************************************************************
+* Function Name: sim_cycles_update
+********************************************************************************
+* Summary:
+*  Count the cycles of the awake time since the last update at the current
+*  CPU clock. Called before any change of the clock tree.
+*
+*******************************************************************************/
+static void sim_cycles_update(void)
+{
+    sim_stats_t stats;
+    uint64_t awake_ns;
+
+    sim_get_stats(&stats);
+    awake_ns = sim_now() - stats.sleep_ns - stats.deep_sleep_ns;
+
+    sim_cycles_remainder += (awake_ns - sim_cycles_awake_ns) *
+                            sim_clock_hz(SIM_CLOCK_INDEX(CYHAL_CLOCK_BLOCK_FAST, 0u));
+    sim_cycles          += sim_cycles_remainder / SIM_NS_PER_S;
+    sim_cycles_remainder = sim_cycles_remainder % SIM_NS_PER_S;
+    sim_cycles_awake_ns  = awake_ns;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_init
+********************************************************************************
+* Summary:
+*  Initialize a pin to its initial level.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction,
+                          cyhal_gpio_drive_mode_t drive_mode, bool init_val)
+{
+    (void) drive_mode;
+
+    if (pin >= CYHAL_GPIO_COUNT)
+    {
+        sim_fail("invalid pin %u", pin);
+    }
+
+    if (!sim_gpio_init)
+    {
+        sim_register(&sim_gpio_device, "gpio");
+        sim_gpio_device.on_interrupt = sim_gpio_isr;
+        sim_gpio_device.deep_sleep   = true;
+        sim_gpio_init = true;
+    }
+
+    sim_gpios[pin].level  = init_val;
+    sim_gpios[pin].output = (direction != CYHAL_GPIO_DIR_INPUT);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_read
+********************************************************************************
+* Summary:
+*  Read the level of a pin.
+*
+*******************************************************************************/
+bool cyhal_gpio_read(cyhal_gpio_t pin)
+{
+    return sim_gpios[pin].level;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_write
+********************************************************************************
+* Summary:
+*  Drive an output pin.
+*
+*******************************************************************************/
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    if (sim_gpios[pin].level == value)
+    {
+        return;
+    }
+
+    sim_gpios[pin].level = value;
+    if (pin == CYBSP_USER_LED)
+    {
+        sim_log("LED %s", (value == CYBSP_LED_STATE_ON) ? "on" : "off");
+    }
+    else
+    {
+        sim_log("P%u_%u %u", pin >> 3, pin & 7u, value);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_register_callback
+********************************************************************************
+* Summary:
+*  Set the handler of the edge interrupt of a pin.
+*
+*******************************************************************************/
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data)
+{
+    callback_data->pin  = pin;
+    callback_data->next = NULL;
+    sim_gpios[pin].callback_data = callback_data;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_enable_event
+********************************************************************************
+* Summary:
+*  Enable or disable edge interrupts of a pin. The GPIO interrupts share one
+*  priority.
+*
+*******************************************************************************/
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority, bool enable)
+{
+    if (enable)
+    {
+        sim_gpios[pin].events = (cyhal_gpio_event_t) (sim_gpios[pin].events | event);
+    }
+    else
+    {
+        sim_gpios[pin].events = (cyhal_gpio_event_t) (sim_gpios[pin].events & ~event);
+    }
+    sim_gpio_device.priority = intr_priority;
+}
+
+/*******************************************************************************
+* Function Name: sim_gpio_drive
+********************************************************************************
+* Summary:
+*  Drive an input pin from outside the device, as a button does, and raise
+*  the edge interrupt.
+*
+* Parameters:
+*  pin: input pin
+*  level: new level
+*
+*******************************************************************************/
+void sim_gpio_drive(cyhal_gpio_t pin, bool level)
+{
+    sim_gpio_t *gpio = &sim_gpios[pin];
+    cyhal_gpio_event_t edge;
+
+    if (gpio->output || (gpio->level == level))
+    {
+        return;
+    }
+
+    gpio->level = level;
+    edge = level ? CYHAL_GPIO_IRQ_RISE : CYHAL_GPIO_IRQ_FALL;
+    sim_log("P%u_%u %s", pin >> 3, pin & 7u, level ? "rises" : "falls");
+
+    if ((gpio->events & edge) != 0u)
+    {
+        gpio->raised = (cyhal_gpio_event_t) (gpio->raised | edge);
+        sim_raise(&sim_gpio_device);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_gpio_isr
+********************************************************************************
+* Summary:
+*  GPIO interrupt: calls the handlers of the pins with a latched edge.
+*
+*******************************************************************************/
+static void sim_gpio_isr(sim_device_t *device)
+{
+    cyhal_gpio_event_t edges;
+
+    (void) device;
+
+    for (cyhal_gpio_t pin = 0; pin < CYHAL_GPIO_COUNT; pin++)
+    {
+        edges = sim_gpios[pin].raised;
+        if (edges == CYHAL_GPIO_IRQ_NONE)
+        {
+            continue;
+        }
+
+        sim_gpios[pin].raised = CYHAL_GPIO_IRQ_NONE;
+        if (sim_gpios[pin].callback_data != NULL)
+        {
+            sim_gpios[pin].callback_data->callback(sim_gpios[pin].callback_data->callback_arg, edges);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: cyhal_pwm_init
+********************************************************************************
+* Summary:
+*  Initialize a PWM. The simulator only records its frequency and state.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_pwm_init(cyhal_pwm_t *obj, cyhal_gpio_t pin, const cyhal_clock_t *clk)
+{
+    (void) clk;
+
+    memset(obj, 0, sizeof(*obj));
+    obj->pin = pin;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_pwm_set_duty_cycle
+********************************************************************************
+* Summary:
+*  Set the frequency and the duty cycle of a PWM.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_pwm_set_duty_cycle(cyhal_pwm_t *obj, float duty_cycle, uint32_t frequencyhal_hz)
+{
+    obj->duty_cycle   = duty_cycle;
+    obj->frequency_hz = frequencyhal_hz;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_pwm_start
+********************************************************************************
+* Summary:
+*  Start a PWM.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_pwm_start(cyhal_pwm_t *obj)
+{
+    obj->running = true;
+    sim_log("PWM P%u_%u on, %lu Hz", obj->pin >> 3, obj->pin & 7u, (unsigned long) obj->frequency_hz);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_pwm_stop
+********************************************************************************
+* Summary:
+*  Stop a PWM.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_pwm_stop(cyhal_pwm_t *obj)
+{
+    obj->running = false;
+    sim_log("PWM P%u_%u off", obj->pin >> 3, obj->pin & 7u);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_init
+********************************************************************************
+* Summary:
+*  Initialize a timer counting a clock, or at 1 MHz without a clock.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_timer_init(cyhal_timer_t *obj, cyhal_gpio_t pin, const cyhal_clock_t *clk)
+{
+    (void) pin;
+
+    memset(obj, 0, sizeof(*obj));
+    obj->tcpwm.resource.block_num   = 0;
+    obj->tcpwm.resource.channel_num = (uint8_t) sim_timer_count++;
+    obj->clock        = clk;
+    obj->frequency_hz = SIM_TIMER_DEFAULT_HZ;
+    obj->config.period = UINT32_MAX;
+
+    sim_register(&obj->device, "timer");
+    obj->device.on_deadline  = sim_timer_tick;
+    obj->device.on_interrupt = sim_timer_isr;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_configure
+********************************************************************************
+* Summary:
+*  Set the period and the initial value of a timer.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_timer_configure(cyhal_timer_t *obj, const cyhal_timer_cfg_t *cfg)
+{
+    obj->config      = *cfg;
+    obj->start_value = cfg->value;
+    obj->start_time  = sim_now();
+    sim_timer_schedule(obj);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_set_frequency
+********************************************************************************
+* Summary:
+*  Count at a frequency instead of the clock given at the initialization.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_timer_set_frequency(cyhal_timer_t *obj, uint32_t hz)
+{
+    obj->start_value  = cyhal_timer_read(obj);
+    obj->start_time   = sim_now();
+    obj->clock        = NULL;
+    obj->frequency_hz = hz;
+    sim_timer_schedule(obj);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_start
+********************************************************************************
+* Summary:
+*  Start counting.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_timer_start(cyhal_timer_t *obj)
+{
+    if (!obj->running)
+    {
+        obj->start_time = sim_now();
+        obj->running    = true;
+    }
+    sim_timer_schedule(obj);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_stop
+********************************************************************************
+* Summary:
+*  Stop counting. The counter keeps its value.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_timer_stop(cyhal_timer_t *obj)
+{
+    obj->start_value = cyhal_timer_read(obj);
+    obj->running     = false;
+    sim_timer_schedule(obj);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_reset
+********************************************************************************
+* Summary:
+*  Clear the counter.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_timer_reset(cyhal_timer_t *obj)
+{
+    obj->start_value = 0u;
+    obj->start_time  = sim_now();
+    sim_timer_schedule(obj);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_read
+********************************************************************************
+* Summary:
+*  Read the counter, computed from the virtual time. The clock of the timer
+*  may have changed since it started: the count is then scaled as if the
+*  timer had always run at the new frequency.
+*
+*******************************************************************************/
+uint32_t cyhal_timer_read(const cyhal_timer_t *obj)
+{
+    uint32_t hz = (obj->clock != NULL) ? cyhal_clock_get_frequency(obj->clock) : obj->frequency_hz;
+    uint64_t count = obj->start_value;
+
+    if (obj->running && (hz != 0u))
+    {
+        count += sim_ns_to_ticks(sim_now() - obj->start_time, hz);
+    }
+
+    return (uint32_t) (count % ((uint64_t) obj->config.period + 1u));
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_register_callback
+********************************************************************************
+* Summary:
+*  Set the handler of the timer interrupt.
+*
+*******************************************************************************/
+void cyhal_timer_register_callback(cyhal_timer_t *obj, cyhal_timer_event_callback_t callback, void *callback_arg)
+{
+    obj->callback     = callback;
+    obj->callback_arg = callback_arg;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_timer_enable_event
+********************************************************************************
+* Summary:
+*  Enable or disable the terminal count interrupt of a timer.
+*
+*******************************************************************************/
+void cyhal_timer_enable_event(cyhal_timer_t *obj, cyhal_timer_event_t event, uint8_t intr_priority, bool enable)
+{
+    if (enable)
+    {
+        obj->events = (cyhal_timer_event_t) (obj->events | event);
+    }
+    else
+    {
+        obj->events = (cyhal_timer_event_t) (obj->events & ~event);
+    }
+    obj->device.priority = intr_priority;
+    sim_timer_schedule(obj);
+}
+
+/*******************************************************************************
+* Function Name: sim_timer_schedule
+********************************************************************************
+* Summary:
+*  Schedule the next terminal count of a timer, if its interrupt is enabled.
+*
+*******************************************************************************/
+static void sim_timer_schedule(cyhal_timer_t *obj)
+{
+    uint32_t hz = (obj->clock != NULL) ? cyhal_clock_get_frequency(obj->clock) : obj->frequency_hz;
+    uint64_t modulo = (uint64_t) obj->config.period + 1u;
+    uint64_t elapsed;
+    uint64_t tick;
+
+    obj->device.deadline = SIM_NEVER;
+    if (!obj->running || (hz == 0u) || ((obj->events & CYHAL_TIMER_IRQ_TERMINAL_COUNT) == 0u))
+    {
+        return;
+    }
+
+    /* First tick after now at which the counter wraps to 0 */
+    elapsed = sim_ns_to_ticks(sim_now() - obj->start_time, hz);
+    tick = modulo - ((uint64_t) obj->start_value % modulo);
+    if (tick <= elapsed)
+    {
+        tick += (((elapsed - tick) / modulo) + 1u) * modulo;
+    }
+
+    obj->device.deadline = obj->start_time + sim_ticks_to_ns(tick, hz);
+}
+
+/*******************************************************************************
+* Function Name: sim_timer_tick
+********************************************************************************
+* Summary:
+*  Terminal count of a timer.
+*
+*******************************************************************************/
+static void sim_timer_tick(sim_device_t *device)
+{
+    cyhal_timer_t *obj = (cyhal_timer_t *) device;
+
+    sim_raise(device);
+    if (obj->config.is_continuous)
+    {
+        sim_timer_schedule(obj);
+    }
+    else
+    {
+        obj->start_value = 0u;
+        obj->running     = false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_timer_isr
+********************************************************************************
+* Summary:
+*  Timer interrupt.
+*
+*******************************************************************************/
+static void sim_timer_isr(sim_device_t *device)
+{
+    cyhal_timer_t *obj = (cyhal_timer_t *) device;
+
+    if (obj->callback != NULL)
+    {
+        obj->callback(obj->callback_arg, CYHAL_TIMER_IRQ_TERMINAL_COUNT);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_init
+********************************************************************************
+* Summary:
+*  Initialize the low-power timer: a free-running counter since the start of
+*  the run, which keeps counting in Deep Sleep.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj)
+{
+    memset(obj, 0, sizeof(*obj));
+
+    sim_register(&obj->device, "lptimer");
+    obj->device.on_deadline  = sim_lptimer_match;
+    obj->device.on_interrupt = sim_lptimer_isr;
+    obj->device.deep_sleep   = true;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_get_info
+********************************************************************************
+* Summary:
+*  Get the frequency and the limits of the low-power timer.
+*
+*******************************************************************************/
+void cyhal_lptimer_get_info(cyhal_lptimer_t *obj, cyhal_lptimer_info_t *info)
+{
+    (void) obj;
+
+    info->frequency_hz      = SIM_LPTIMER_HZ;
+    info->min_set_delay     = SIM_LPTIMER_MIN_DELAY;
+    info->max_counter_value = UINT32_MAX;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_read
+********************************************************************************
+* Summary:
+*  Read the counter.
+*
+*******************************************************************************/
+uint32_t cyhal_lptimer_read(const cyhal_lptimer_t *obj)
+{
+    (void) obj;
+
+    return (uint32_t) sim_ns_to_ticks(sim_now(), SIM_LPTIMER_HZ);
+}
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_set_delay
+********************************************************************************
+* Summary:
+*  Set the compare match a number of ticks from now.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_lptimer_set_delay(cyhal_lptimer_t *obj, uint32_t delay)
+{
+    uint64_t match = sim_ns_to_ticks(sim_now(), SIM_LPTIMER_HZ) + delay;
+
+    obj->device.deadline = sim_ticks_to_ns(match, SIM_LPTIMER_HZ);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_register_callback
+********************************************************************************
+* Summary:
+*  Set the handler of the compare match interrupt.
+*
+*******************************************************************************/
+void cyhal_lptimer_register_callback(cyhal_lptimer_t *obj, cyhal_lptimer_event_callback_t callback, void *callback_arg)
+{
+    obj->callback     = callback;
+    obj->callback_arg = callback_arg;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_enable_event
+********************************************************************************
+* Summary:
+*  Enable or disable the compare match interrupt.
+*
+*******************************************************************************/
+void cyhal_lptimer_enable_event(cyhal_lptimer_t *obj, cyhal_lptimer_event_t event, uint8_t intr_priority, bool enable)
+{
+    (void) event;
+
+    obj->enabled = enable;
+    obj->device.priority = intr_priority;
+}
+
+/*******************************************************************************
+* Function Name: sim_lptimer_match
+********************************************************************************
+* Summary:
+*  Compare match of the low-power timer.
+*
+*******************************************************************************/
+static void sim_lptimer_match(sim_device_t *device)
+{
+    cyhal_lptimer_t *obj = (cyhal_lptimer_t *) device;
+
+    if (obj->enabled)
+    {
+        sim_raise(device);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_lptimer_isr
+********************************************************************************
+* Summary:
+*  Low-power timer interrupt.
+*
+*******************************************************************************/
+static void sim_lptimer_isr(sim_device_t *device)
+{
+    cyhal_lptimer_t *obj = (cyhal_lptimer_t *) device;
+
+    if (obj->callback != NULL)
+    {
+        obj->callback(obj->callback_arg, CYHAL_LPTIMER_COMPARE_MATCH);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_init
+********************************************************************************
+* Summary:
+*  Initialize the I2S TX. The pins and the clock are not used: the frames
+*  are clocked at the sample rate.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2s_init(cyhal_i2s_t *obj, const cyhal_i2s_pins_t *tx_pins, const cyhal_i2s_pins_t *rx_pins,
+                         const cyhal_i2s_config_t *config, cyhal_clock_t *clk)
+{
+    (void) tx_pins;
+    (void) rx_pins;
+    (void) clk;
+
+    memset(obj, 0, sizeof(*obj));
+    obj->word_length    = config->word_length;
+    obj->sample_rate_hz = config->sample_rate_hz;
+
+    sim_register(&obj->device, "i2s");
+    obj->device.on_deadline  = sim_i2s_frame;
+    obj->device.on_interrupt = sim_i2s_isr;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_register_callback
+********************************************************************************
+* Summary:
+*  Set the handler of the I2S interrupt.
+*
+*******************************************************************************/
+void cyhal_i2s_register_callback(cyhal_i2s_t *obj, cyhal_i2s_event_callback_t callback, void *callback_arg)
+{
+    obj->callback     = callback;
+    obj->callback_arg = callback_arg;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_enable_event
+********************************************************************************
+* Summary:
+*  Enable or disable I2S events. A disabled event is not latched.
+*
+*******************************************************************************/
+void cyhal_i2s_enable_event(cyhal_i2s_t *obj, cyhal_i2s_event_t event, uint8_t intr_priority, bool enable)
+{
+    if (enable)
+    {
+        obj->events = (cyhal_i2s_event_t) (obj->events | event);
+    }
+    else
+    {
+        obj->events = (cyhal_i2s_event_t) (obj->events & ~event);
+        obj->raised = (cyhal_i2s_event_t) (obj->raised & ~event);
+    }
+    obj->device.priority = intr_priority;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_set_sample_rate
+********************************************************************************
+* Summary:
+*  Change the sample rate. A running TX continues at the new rate from now.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2s_set_sample_rate(cyhal_i2s_t *obj, uint32_t sample_rate_hz)
+{
+    obj->sample_rate_hz = sample_rate_hz;
+    sim_log("I2S rate %lu Hz", (unsigned long) sample_rate_hz);
+
+    if (obj->tx_running)
+    {
+        obj->anchor_time = sim_now();
+        obj->frames      = 0;
+        sim_i2s_schedule(obj);
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_start_tx
+********************************************************************************
+* Summary:
+*  Start clocking the frames out of the TX FIFO.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2s_start_tx(cyhal_i2s_t *obj)
+{
+    if (!obj->tx_running)
+    {
+        obj->tx_running  = true;
+        obj->anchor_time = sim_now();
+        obj->frames      = 0;
+        sim_i2s_schedule(obj);
+        sim_log("I2S TX start");
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_stop_tx
+********************************************************************************
+* Summary:
+*  Stop the TX at once. The words left in the TX FIFO are not played.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2s_stop_tx(cyhal_i2s_t *obj)
+{
+    if (obj->tx_running)
+    {
+        sim_log("I2S TX stop, %lu words dropped", (unsigned long) obj->fifo_count);
+    }
+
+    obj->tx_running      = false;
+    obj->fifo_count      = 0;
+    obj->device.deadline = SIM_NEVER;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_write_async
+********************************************************************************
+* Summary:
+*  Start the transfer of words to the TX FIFO. The FIFO is filled at once,
+*  then refilled by the HAL each time it is half empty.
+*  CYHAL_I2S_ASYNC_TX_COMPLETE is raised when the last word has entered the
+*  FIFO.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2s_write_async(cyhal_i2s_t *obj, const void *tx, size_t tx_length)
+{
+    if (obj->tx_remaining != 0u)
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    obj->tx_data      = tx;
+    obj->tx_remaining = tx_length;
+    sim_i2s_fill(obj);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2s_is_write_pending
+********************************************************************************
+* Summary:
+*  Check if an asynchronous transfer is in progress.
+*
+*******************************************************************************/
+bool cyhal_i2s_is_write_pending(cyhal_i2s_t *obj)
+{
+    return (obj->tx_remaining != 0u);
+}
+
+/*******************************************************************************
+* Function Name: sim_i2s_raise
+********************************************************************************
+* Summary:
+*  Latch the enabled events among the given ones and raise the interrupt.
+*
+*******************************************************************************/
+static void sim_i2s_raise(cyhal_i2s_t *obj, cyhal_i2s_event_t events)
+{
+    events = (cyhal_i2s_event_t) (events & obj->events);
+    if (events != 0u)
+    {
+        obj->raised = (cyhal_i2s_event_t) (obj->raised | events);
+        sim_raise(&obj->device);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_i2s_fill
+********************************************************************************
+* Summary:
+*  Move words of the asynchronous transfer to the TX FIFO. Words of 16 bits
+*  or less are read from a uint16_t buffer, wider words from a uint32_t one.
+*
+*******************************************************************************/
+static void sim_i2s_fill(cyhal_i2s_t *obj)
+{
+    uint32_t write;
+
+    if (obj->tx_remaining == 0u)
+    {
+        return;
+    }
+
+    while ((obj->fifo_count < CYHAL_I2S_FIFO_DEPTH) && (obj->tx_remaining != 0u))
+    {
+        write = (obj->fifo_read + obj->fifo_count) % CYHAL_I2S_FIFO_DEPTH;
+        if (obj->word_length <= 16u)
+        {
+            obj->fifo[write] = (uint32_t) (int32_t) *(const int16_t *) obj->tx_data;
+            obj->tx_data = (const int16_t *) obj->tx_data + 1;
+        }
+        else
+        {
+            obj->fifo[write] = *(const uint32_t *) obj->tx_data;
+            obj->tx_data = (const uint32_t *) obj->tx_data + 1;
+        }
+        obj->fifo_count++;
+        obj->tx_remaining--;
+    }
+
+    if (obj->tx_remaining == 0u)
+    {
+        obj->tx_data = NULL;
+        sim_i2s_raise(obj, CYHAL_I2S_ASYNC_TX_COMPLETE);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_i2s_schedule
+********************************************************************************
+* Summary:
+*  Schedule the next frame of a running TX. The frame times are computed
+*  from the rate anchor, so they do not drift at rates such as 44.1 kHz.
+*
+*******************************************************************************/
+static void sim_i2s_schedule(cyhal_i2s_t *obj)
+{
+    obj->device.deadline = obj->anchor_time + sim_ticks_to_ns(obj->frames + 1u, obj->sample_rate_hz);
+}
+
+/*******************************************************************************
+* Function Name: sim_i2s_frame
+********************************************************************************
+* Summary:
+*  Clock one frame out of the TX FIFO into the WAV sink. An empty FIFO plays
+*  silence and raises CYHAL_I2S_TX_UNDERFLOW.
+*
+*******************************************************************************/
+static void sim_i2s_frame(sim_device_t *device)
+{
+    cyhal_i2s_t *obj = (cyhal_i2s_t *) device;
+    uint32_t frame[2] = { 0u, 0u };
+    cyhal_i2s_event_t events = (cyhal_i2s_event_t) 0;
+    bool underflow = (obj->fifo_count < 2u);
+
+    if (underflow)
+    {
+        obj->fifo_count = 0;
+        events = CYHAL_I2S_TX_UNDERFLOW;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < 2u; i++)
+        {
+            frame[i] = obj->fifo[obj->fifo_read];
+            obj->fifo_read = (obj->fifo_read + 1u) % CYHAL_I2S_FIFO_DEPTH;
+        }
+        obj->fifo_count -= 2u;
+    }
+    sim_wav_write(frame, obj->word_length, obj->sample_rate_hz);
+    sim_on_frame(underflow);
+
+    if (obj->fifo_count <= SIM_I2S_FIFO_TRIGGER)
+    {
+        sim_i2s_fill(obj);
+    }
+
+    /* Level events of the FIFO after the frame */
+    if (obj->fifo_count < CYHAL_I2S_FIFO_DEPTH)
+    {
+        events |= CYHAL_I2S_TX_NOT_FULL;
+    }
+    if (obj->fifo_count <= SIM_I2S_FIFO_TRIGGER)
+    {
+        events |= CYHAL_I2S_TX_HALF_EMPTY;
+    }
+    if (obj->fifo_count == 0u)
+    {
+        events |= CYHAL_I2S_TX_EMPTY;
+    }
+    sim_i2s_raise(obj, events);
+
+    obj->frames++;
+    sim_i2s_schedule(obj);
+}
+
+/*******************************************************************************
+* Function Name: sim_i2s_isr
+********************************************************************************
+* Summary:
+*  I2S interrupt: reports the latched events that are still enabled.
+*
+*******************************************************************************/
+static void sim_i2s_isr(sim_device_t *device)
+{
+    cyhal_i2s_t *obj = (cyhal_i2s_t *) device;
+    cyhal_i2s_event_t events = (cyhal_i2s_event_t) (obj->raised & obj->events);
+
+    obj->raised = (cyhal_i2s_event_t) 0;
+    if ((events != 0u) && (obj->callback != NULL))
+    {
+        obj->callback(obj->callback_arg, events);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_init
+********************************************************************************
+* Summary:
+*  Initialize an I2C master. The pins and the clock are not used: the bytes
+*  are clocked at the frequency of the configuration.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_init(cyhal_i2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl, const cyhal_clock_t *clk)
+{
+    (void) sda;
+    (void) scl;
+    (void) clk;
+
+    memset(obj, 0, sizeof(*obj));
+    obj->frequency_hz = CYHAL_I2C_DEFAULT_HZ;
+
+    sim_register(&obj->device, "i2c");
+    obj->device.on_deadline  = sim_i2c_done;
+    obj->device.on_interrupt = sim_i2c_isr;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_configure
+********************************************************************************
+* Summary:
+*  Set the bus clock. Only the master mode is simulated.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_configure(cyhal_i2c_t *obj, const cyhal_i2c_cfg_t *cfg)
+{
+    if (cfg->is_slave || (cfg->frequencyhal_hz == 0u))
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    obj->frequency_hz = cfg->frequencyhal_hz;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_master_write
+********************************************************************************
+* Summary:
+*  Blocking write: busy-waits for the time of the transfer on the bus.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_master_write(cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size,
+                                 uint32_t timeout, bool send_stop)
+{
+    (void) timeout;
+    (void) send_stop;
+
+    if (obj->busy)
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    sim_advance(sim_i2c_duration(obj, size, 0u));
+
+    return sim_i2c_exchange(dev_addr, data, size, NULL, 0u) ? CY_RSLT_SUCCESS : CYHAL_I2C_RSLT_ERR_NACK;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_master_read
+********************************************************************************
+* Summary:
+*  Blocking read: busy-waits for the time of the transfer on the bus.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_master_read(cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size,
+                                uint32_t timeout, bool send_stop)
+{
+    (void) timeout;
+    (void) send_stop;
+
+    if (obj->busy)
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    sim_advance(sim_i2c_duration(obj, 0u, size));
+
+    return sim_i2c_exchange(dev_addr, NULL, 0u, data, size) ? CY_RSLT_SUCCESS : CYHAL_I2C_RSLT_ERR_NACK;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_master_transfer_async
+********************************************************************************
+* Summary:
+*  Start a write followed by a read, either of which can be empty. The
+*  buffers are used until the transfer completes: the device sees the
+*  transfer at its end, when the completion events are raised.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_master_transfer_async(cyhal_i2c_t *obj, uint16_t address, const void *tx, size_t tx_size,
+                                          void *rx, size_t rx_size)
+{
+    if (obj->busy)
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    obj->busy    = true;
+    obj->address = address;
+    obj->tx_data = (const uint8_t *) tx;
+    obj->tx_size = tx_size;
+    obj->rx_data = (uint8_t *) rx;
+    obj->rx_size = rx_size;
+    obj->device.deadline = sim_now() + sim_i2c_duration(obj, tx_size, rx_size);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_register_callback
+********************************************************************************
+* Summary:
+*  Set the handler of the I2C interrupt.
+*
+*******************************************************************************/
+void cyhal_i2c_register_callback(cyhal_i2c_t *obj, cyhal_i2c_event_callback_t callback, void *callback_arg)
+{
+    obj->callback     = callback;
+    obj->callback_arg = callback_arg;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_enable_event
+********************************************************************************
+* Summary:
+*  Enable or disable I2C events.
+*
+*******************************************************************************/
+void cyhal_i2c_enable_event(cyhal_i2c_t *obj, cyhal_i2c_event_t event, uint8_t intr_priority, bool enable)
+{
+    if (enable)
+    {
+        obj->events = (cyhal_i2c_event_t) (obj->events | event);
+    }
+    else
+    {
+        obj->events = (cyhal_i2c_event_t) (obj->events & ~event);
+    }
+    obj->device.priority = intr_priority;
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_attach
+********************************************************************************
+* Summary:
+*  Connect a device to the I2C bus. The transfers to other addresses are not
+*  acknowledged.
+*
+* Parameters:
+*  slave: device, kept by the caller; NULL to disconnect it
+*
+*******************************************************************************/
+void sim_i2c_attach(const sim_i2c_slave_t *slave)
+{
+    sim_i2c_slave = slave;
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_duration
+********************************************************************************
+* Summary:
+*  Time of a transfer on the bus: the address byte, the bytes written, and
+*  a repeated address byte before the bytes read.
+*
+*******************************************************************************/
+static uint64_t sim_i2c_duration(const cyhal_i2c_t *obj, size_t tx_size, size_t rx_size)
+{
+    uint64_t bytes = 1u + tx_size;
+
+    if (rx_size != 0u)
+    {
+        bytes += ((tx_size != 0u) ? 1u : 0u) + rx_size;
+    }
+
+    return sim_ticks_to_ns(bytes * SIM_I2C_BYTE_BITS, obj->frequency_hz);
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_exchange
+********************************************************************************
+* Summary:
+*  Pass a transfer to the device at its address.
+*
+* Return:
+*  bool: false if the transfer was not acknowledged
+*
+*******************************************************************************/
+static bool sim_i2c_exchange(uint16_t address, const uint8_t *tx, size_t tx_size, uint8_t *rx, size_t rx_size)
+{
+    const sim_i2c_slave_t *slave = sim_i2c_slave;
+
+    if ((slave == NULL) || (slave->address != address))
+    {
+        return false;
+    }
+    if ((tx_size != 0u) && ((slave->on_write == NULL) || !slave->on_write(tx, tx_size)))
+    {
+        return false;
+    }
+    if ((rx_size != 0u) && ((slave->on_read == NULL) || !slave->on_read(rx, rx_size)))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_done
+********************************************************************************
+* Summary:
+*  End of an asynchronous transfer.
+*
+*******************************************************************************/
+static void sim_i2c_done(sim_device_t *device)
+{
+    cyhal_i2c_t *obj = (cyhal_i2c_t *) device;
+    cyhal_i2c_event_t events;
+
+    device->deadline = SIM_NEVER;
+    obj->busy = false;
+
+    if (!sim_i2c_exchange(obj->address, obj->tx_data, obj->tx_size, obj->rx_data, obj->rx_size))
+    {
+        events = CYHAL_I2C_MASTER_ERR_EVENT;
+    }
+    else
+    {
+        events = (obj->rx_size != 0u) ? CYHAL_I2C_MASTER_RD_CMPLT_EVENT : CYHAL_I2C_MASTER_WR_CMPLT_EVENT;
+    }
+
+    events = (cyhal_i2c_event_t) (events & obj->events);
+    if (events != 0u)
+    {
+        obj->raised = (cyhal_i2c_event_t) (obj->raised | events);
+        sim_raise(device);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_isr
+********************************************************************************
+* Summary:
+*  I2C interrupt: reports the latched events that are still enabled.
+*
+*******************************************************************************/
+static void sim_i2c_isr(sim_device_t *device)
+{
+    cyhal_i2c_t *obj = (cyhal_i2c_t *) device;
+    cyhal_i2c_event_t events = (cyhal_i2c_event_t) (obj->raised & obj->events);
+
+    obj->raised = (cyhal_i2c_event_t) 0;
+    if ((events != 0u) && (obj->callback != NULL))
+    {
+        obj->callback(obj->callback_arg, events);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_register_callback
+********************************************************************************
+* Summary:
+*  Add a power mode transition callback.
+*
+*******************************************************************************/
+void cyhal_syspm_register_callback(cyhal_syspm_callback_data_t *callback_data)
+{
+    callback_data->next = sim_syspm_callbacks;
+    sim_syspm_callbacks = callback_data;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_sleep
+********************************************************************************
+* Summary:
+*  Sleep until an interrupt: all the devices keep running.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_syspm_sleep(void)
+{
+    sim_wait(false);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_deepsleep
+********************************************************************************
+* Summary:
+*  Enter Deep Sleep until an interrupt of a device that runs in Deep Sleep,
+*  if all the callbacks accept the transition.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_syspm_deepsleep(void)
+{
+    if (!sim_syspm_notify(NULL, CYHAL_SYSPM_CHECK_READY))
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    sim_syspm_notify(NULL, CYHAL_SYSPM_BEFORE_TRANSITION);
+    sim_log("Deep Sleep");
+    sim_wait(true);
+    sim_log("wake-up");
+    sim_syspm_notify(NULL, CYHAL_SYSPM_AFTER_TRANSITION);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: sim_syspm_notify
+********************************************************************************
+* Summary:
+*  Call the Deep Sleep callbacks with a mode. When a callback refuses the
+*  transition, the callbacks that accepted it are called with
+*  CYHAL_SYSPM_CHECK_FAIL.
+*
+* Parameters:
+*  last: callback to stop at, NULL for all
+*  mode: transition mode
+*
+* Return:
+*  bool: false if a callback refused the transition
+*
+*******************************************************************************/
+static bool sim_syspm_notify(cyhal_syspm_callback_data_t *last, cyhal_syspm_callback_mode_t mode)
+{
+    cyhal_syspm_callback_data_t *data;
+
+    for (data = sim_syspm_callbacks; data != last; data = data->next)
+    {
+        if (((data->states & CYHAL_SYSPM_CB_CPU_DEEPSLEEP) == 0u) || ((data->ignore_modes & mode) != 0u))
+        {
+            continue;
+        }
+        if (!data->callback(CYHAL_SYSPM_CB_CPU_DEEPSLEEP, mode, data->args) && (mode == CYHAL_SYSPM_CHECK_READY))
+        {
+            sim_syspm_notify(data, CYHAL_SYSPM_CHECK_FAIL);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,420 @@
+/*****************************************************************************
+* File Name: sim_main.c
+*
+* Description: This file contains the entry point of the host simulator. It runs
+*              the application (main.c, built as app_main) on the virtual clock,
+*              drives the user button from a script of presses, captures the I2S
+*              output to a WAV file, and prints a report of the run.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cybsp.h"
+#include "sim.h"
+#include "sim_wav.h"
+
+#include "audio_energy.h"
+#include "audio_glitch.h"
+#include "audio_mixer.h"
+#include "isr_latency.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define SIM_MAX_ACTIONS         64u
+/* Press used when the script is empty */
+#define SIM_DEFAULT_PRESS_MS    100u
+#define SIM_DEFAULT_HOLD_MS     100u
+/* Run time after the last action when no end time is given */
+#define SIM_DEFAULT_TAIL_MS     10000u
+
+/* Kinds of scripted actions */
+typedef enum
+{
+    SIM_ACTION_BUTTON,
+    SIM_ACTION_LOAD,
+    SIM_ACTION_BALANCE,
+} sim_action_type_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+int app_main(void);
+
+static void sim_usage(const char *program);
+static void sim_add_action(uint64_t time, sim_action_type_t type, int32_t value);
+static int sim_compare_actions(const void *a, const void *b);
+static void sim_script_event(sim_device_t *device);
+static void sim_energy_record(void);
+static void sim_report(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Scripted action: a button edge, the start of the competing load, or a
+*  change of the master balance */
+typedef struct
+{
+    uint64_t time;
+    sim_action_type_t type;
+    int32_t value;              /* Button level or balance */
+} sim_action_t;
+
+/* Set by the application, see main.c */
+extern uint32_t press_to_play_us;
+
+static sim_action_t sim_actions[SIM_MAX_ACTIONS];
+static uint32_t sim_action_count;
+static uint32_t sim_action_next;
+static sim_device_t sim_script;
+
+/* Competing interrupt load, see isr_latency_set_load() */
+static uint32_t sim_load_period_us;
+static uint32_t sim_load_busy_us;
+static uint32_t sim_load_priority;
+
+/* Energy record of each clip, see audio_energy_get_clip() */
+static FILE *sim_energy_file;
+static uint32_t sim_energy_clip;
+
+static struct timespec sim_host_start;
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Parse the command line, schedule the script and run the application until
+*  the end time, or until no hardware event is left.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *wav_path = NULL;
+    const char *energy_path = NULL;
+    uint64_t end_time = 0;
+    bool verbose = false;
+    unsigned long press_ms;
+    unsigned long hold_ms;
+    unsigned long balance_ms;
+    int balance;
+    int option;
+
+    while ((option = getopt(argc, argv, "o:e:t:l:b:vh")) != -1)
+    {
+        switch (option)
+        {
+            case 'o':
+                wav_path = optarg;
+                break;
+
+            case 'e':
+                energy_path = optarg;
+                break;
+
+            case 't':
+                end_time = strtoull(optarg, NULL, 10) * SIM_NS_PER_MS;
+                break;
+
+            case 'l':
+                sim_load_priority = 0u;
+                if (sscanf(optarg, "%u:%u:%u", &sim_load_period_us, &sim_load_busy_us, &sim_load_priority) < 2)
+                {
+                    sim_usage(argv[0]);
+                }
+                break;
+
+            case 'b':
+                if ((sscanf(optarg, "%lu:%d", &balance_ms, &balance) != 2) ||
+                    (balance < AUDIO_PAN_LEFT) || (balance > AUDIO_PAN_RIGHT))
+                {
+                    sim_usage(argv[0]);
+                }
+                sim_add_action((uint64_t) balance_ms * SIM_NS_PER_MS, SIM_ACTION_BALANCE, balance);
+                break;
+
+            case 'v':
+                verbose = true;
+                break;
+
+            default:
+                sim_usage(argv[0]);
+                break;
+        }
+    }
+
+    for (int i = optind; i < argc; i++)
+    {
+        hold_ms = SIM_DEFAULT_HOLD_MS;
+        if (sscanf(argv[i], "%lu:%lu", &press_ms, &hold_ms) < 1)
+        {
+            sim_usage(argv[0]);
+        }
+        sim_add_action((uint64_t) press_ms * SIM_NS_PER_MS, SIM_ACTION_BUTTON, CYBSP_BTN_PRESSED);
+        sim_add_action((uint64_t) (press_ms + hold_ms) * SIM_NS_PER_MS, SIM_ACTION_BUTTON, CYBSP_BTN_OFF);
+    }
+    if (optind == argc)
+    {
+        sim_add_action((uint64_t) SIM_DEFAULT_PRESS_MS * SIM_NS_PER_MS, SIM_ACTION_BUTTON, CYBSP_BTN_PRESSED);
+        sim_add_action((uint64_t) (SIM_DEFAULT_PRESS_MS + SIM_DEFAULT_HOLD_MS) * SIM_NS_PER_MS,
+                       SIM_ACTION_BUTTON, CYBSP_BTN_OFF);
+    }
+    if (sim_load_period_us != 0u)
+    {
+        sim_add_action(0u, SIM_ACTION_LOAD, 0);
+    }
+    qsort(sim_actions, sim_action_count, sizeof(sim_actions[0]), sim_compare_actions);
+
+    if (end_time == 0u)
+    {
+        end_time = sim_actions[sim_action_count - 1u].time + ((uint64_t) SIM_DEFAULT_TAIL_MS * SIM_NS_PER_MS);
+    }
+
+    sim_init(end_time, verbose);
+    if ((wav_path != NULL) && !sim_wav_open(wav_path))
+    {
+        sim_fail("invalid path %s", wav_path);
+    }
+    if (energy_path != NULL)
+    {
+        sim_energy_file = fopen(energy_path, "w");
+        if (sim_energy_file == NULL)
+        {
+            sim_fail("invalid path %s", energy_path);
+        }
+        fprintf(sim_energy_file, "clip,duration_us,active_cycles,active_us,sleep_us,wakeups,load_permille,energy_nj\n");
+        sim_set_idle_hook(sim_energy_record);
+    }
+
+    /* The script stands for the outside world: it also runs in Deep Sleep */
+    sim_register(&sim_script, "script");
+    sim_script.on_deadline = sim_script_event;
+    sim_script.deep_sleep  = true;
+    sim_script.deadline    = sim_actions[0].time;
+
+    clock_gettime(CLOCK_MONOTONIC, &sim_host_start);
+    atexit(sim_report);
+
+    return app_main();
+}
+
+/*******************************************************************************
+* Function Name: sim_usage
+********************************************************************************
+* Summary:
+*  Print the usage and exit.
+*
+*******************************************************************************/
+static void sim_usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [-o out.wav] [-e energy.csv] [-t end_ms] [-l period_us:busy_us[:priority]] [-b time_ms:balance ...] [-v]\n"
+            "       [press_ms[:hold_ms] ...]\n"
+            "  -o  capture the I2S output to a WAV file\n"
+            "  -e  write the energy record of each clip played to a CSV file\n"
+            "  -t  end of the run in ms of virtual time (default: 10 s after the last action)\n"
+            "  -l  competing interrupt load, see isr_latency_set_load()\n"
+            "  -b  set the master balance at that time, %d to %d, see audio_mixer_set_balance()\n"
+            "  -v  log the device activity\n"
+            "Each press_ms presses the user button at that time, for hold_ms (default %u ms).\n"
+            "Without presses, the button is pressed at %u ms.\n",
+            program, AUDIO_PAN_LEFT, AUDIO_PAN_RIGHT, SIM_DEFAULT_HOLD_MS, SIM_DEFAULT_PRESS_MS);
+    exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************
+* Function Name: sim_add_action
+********************************************************************************
+* Summary:
+*  Add an action to the script.
+*
+*******************************************************************************/
+static void sim_add_action(uint64_t time, sim_action_type_t type, int32_t value)
+{
+    if (sim_action_count == SIM_MAX_ACTIONS)
+    {
+        sim_fail("more than %u actions", SIM_MAX_ACTIONS);
+    }
+
+    sim_actions[sim_action_count].time  = time;
+    sim_actions[sim_action_count].type  = type;
+    sim_actions[sim_action_count].value = value;
+    sim_action_count++;
+}
+
+/*******************************************************************************
+* Function Name: sim_compare_actions
+********************************************************************************
+* Summary:
+*  Order the actions by time.
+*
+*******************************************************************************/
+static int sim_compare_actions(const void *a, const void *b)
+{
+    uint64_t time_a = ((const sim_action_t *) a)->time;
+    uint64_t time_b = ((const sim_action_t *) b)->time;
+
+    return (time_a > time_b) - (time_a < time_b);
+}
+
+/*******************************************************************************
+* Function Name: sim_script_event
+********************************************************************************
+* Summary:
+*  Run the actions that are due and schedule the next one.
+*
+*******************************************************************************/
+static void sim_script_event(sim_device_t *device)
+{
+    sim_action_t *action;
+
+    while ((sim_action_next < sim_action_count) && (sim_actions[sim_action_next].time <= sim_now()))
+    {
+        action = &sim_actions[sim_action_next++];
+        switch (action->type)
+        {
+            case SIM_ACTION_BUTTON:
+                sim_gpio_drive(CYBSP_USER_BTN, action->value != 0);
+                break;
+
+            case SIM_ACTION_LOAD:
+                /* Started from outside the application, as with the debugger */
+                sim_log("load %lu us every %lu us, priority %lu", (unsigned long) sim_load_busy_us,
+                        (unsigned long) sim_load_period_us, (unsigned long) sim_load_priority);
+                if (isr_latency_set_load(sim_load_period_us, sim_load_busy_us, (uint8_t) sim_load_priority)
+                    != CY_RSLT_SUCCESS)
+                {
+                    sim_log("load not started");
+                }
+                break;
+
+            case SIM_ACTION_BALANCE:
+                /* Set from outside the application, as with the debugger */
+                sim_log("balance %ld", (long) action->value);
+                audio_mixer_set_balance((int8_t) action->value);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (sim_action_next < sim_action_count)
+    {
+        device->deadline = sim_actions[sim_action_next].time;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_energy_record
+********************************************************************************
+* Summary:
+*  Write the energy record of a clip that has stopped since the last call.
+*  Called each time the application idles.
+*
+*******************************************************************************/
+static void sim_energy_record(void)
+{
+    audio_energy_clip_t clip;
+
+    audio_energy_get_clip(&clip);
+    if (clip.clip == sim_energy_clip)
+    {
+        return;
+    }
+
+    sim_energy_clip = clip.clip;
+    fprintf(sim_energy_file, "%lu,%lu,%llu,%lu,%lu,%lu,%lu,%llu\n", (unsigned long) clip.clip,
+            (unsigned long) clip.duration_us, (unsigned long long) clip.active_cycles,
+            (unsigned long) clip.active_us, (unsigned long) clip.sleep_us, (unsigned long) clip.wakeups,
+            (unsigned long) clip.load_permille, (unsigned long long) clip.energy_nj);
+}
+
+/*******************************************************************************
+* Function Name: sim_report
+********************************************************************************
+* Summary:
+*  Close the capture and print the report of the run.
+*
+*******************************************************************************/
+static void sim_report(void)
+{
+    struct timespec host_end;
+    sim_stats_t stats;
+    audio_glitch_report_t glitches;
+    audio_energy_clip_t clip;
+    double host_s;
+    double virtual_s;
+
+    sim_wav_close();
+    if (sim_energy_file != NULL)
+    {
+        sim_energy_record();
+        fclose(sim_energy_file);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &host_end);
+    host_s = (double) (host_end.tv_sec - sim_host_start.tv_sec) +
+             ((double) (host_end.tv_nsec - sim_host_start.tv_nsec) / SIM_NS_PER_S);
+    virtual_s = (double) sim_now() / SIM_NS_PER_S;
+
+    sim_get_stats(&stats);
+    audio_glitch_get_report(&glitches);
+    audio_energy_get_clip(&clip);
+
+    printf("virtual time   %.3f s\n", virtual_s);
+    printf("host time      %.3f s (%.0fx real time)\n", host_s, (host_s > 0.0) ? (virtual_s / host_s) : 0.0);
+    printf("interrupts     %lu\n", (unsigned long) stats.interrupts);
+    printf("sleep          %lu entries, %.3f s\n", (unsigned long) stats.sleeps,
+           (double) stats.sleep_ns / SIM_NS_PER_S);
+    printf("deep sleep     %lu entries, %.3f s\n", (unsigned long) stats.deep_sleeps,
+           (double) stats.deep_sleep_ns / SIM_NS_PER_S);
+    printf("frames         %llu, %llu from an empty FIFO\n", (unsigned long long) stats.frames,
+           (unsigned long long) stats.underflow_frames);
+    printf("clips          %lu, %lu blocks\n", (unsigned long) clip.clip, (unsigned long) glitches.blocks);
+    printf("glitches       late refill %lu, underflow %lu, overflow %lu\n",
+           (unsigned long) glitches.counts[AUDIO_GLITCH_LATE_REFILL],
+           (unsigned long) glitches.counts[AUDIO_GLITCH_TX_UNDERFLOW],
+           (unsigned long) glitches.counts[AUDIO_GLITCH_TX_OVERFLOW]);
+    printf("press to play  %lu us\n", (unsigned long) press_to_play_us);
+    printf("last clip      %lu us, load %lu.%lu %%, %llu uJ\n", (unsigned long) clip.duration_us,
+           (unsigned long) (clip.load_permille / 10u), (unsigned long) (clip.load_permille % 10u),
+           (unsigned long long) (clip.energy_nj / 1000u));
+}
+
+/* [] END OF FILE */
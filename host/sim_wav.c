@@ -0,0 +1,239 @@
+/*****************************************************************************
+* File Name: sim_wav.c
+*
+* Description: This file contains the WAV sink of the host simulator. The stereo
+*              frames clocked out of the I2S are written as PCM at the output word
+*              length. A WAV file has a single format: when the sample rate or the
+*              word length changes, the capture continues in a new file, named
+*              after the first one with a sequence number (out.wav, out.1.wav, ...).
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_wav.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define SIM_WAV_HEADER_SIZE     44u
+#define SIM_WAV_CHANNELS        2u
+#define SIM_WAV_PATH_SIZE       256u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void sim_wav_start(uint8_t word_length, uint32_t sample_rate_hz);
+static void sim_wav_header(uint32_t data_size);
+static void sim_wav_put(uint32_t value, uint32_t bytes);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Path of the first file; the capture is disabled if empty */
+static char sim_wav_path[SIM_WAV_PATH_SIZE];
+static FILE *sim_wav_file;
+/* Files opened so far */
+static uint32_t sim_wav_files;
+/* Format of the current file */
+static uint8_t sim_wav_bits;
+static uint32_t sim_wav_rate;
+static uint32_t sim_wav_data_size;
+
+/*******************************************************************************
+* Function Name: sim_wav_open
+********************************************************************************
+* Summary:
+*  Enable the capture. The file is created with the first frame, when its
+*  format is known.
+*
+* Parameters:
+*  path: path of the WAV file
+*
+* Return:
+*  bool: false if the path is too long
+*
+*******************************************************************************/
+bool sim_wav_open(const char *path)
+{
+    if (strlen(path) >= (SIM_WAV_PATH_SIZE - 8u))
+    {
+        return false;
+    }
+
+    strcpy(sim_wav_path, path);
+    sim_wav_files = 0;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: sim_wav_write
+********************************************************************************
+* Summary:
+*  Write a frame. Words are written as signed PCM samples of the word
+*  length: 16-, 24- or 32-bit.
+*
+* Parameters:
+*  frame: left and right words, as read from the TX FIFO
+*  word_length: I2S word length in bits
+*  sample_rate_hz: sample rate of the frame
+*
+*******************************************************************************/
+void sim_wav_write(const uint32_t *frame, uint8_t word_length, uint32_t sample_rate_hz)
+{
+    uint8_t bits = (word_length <= 16u) ? 16u : ((word_length <= 24u) ? 24u : 32u);
+
+    if (sim_wav_path[0] == '\0')
+    {
+        return;
+    }
+
+    if ((sim_wav_file == NULL) || (bits != sim_wav_bits) || (sample_rate_hz != sim_wav_rate))
+    {
+        sim_wav_start(bits, sample_rate_hz);
+    }
+
+    for (uint32_t i = 0; i < SIM_WAV_CHANNELS; i++)
+    {
+        sim_wav_put(frame[i], bits / 8u);
+    }
+    sim_wav_data_size += SIM_WAV_CHANNELS * (bits / 8u);
+}
+
+/*******************************************************************************
+* Function Name: sim_wav_close
+********************************************************************************
+* Summary:
+*  Complete the header of the current file and close it.
+*
+*******************************************************************************/
+void sim_wav_close(void)
+{
+    if (sim_wav_file == NULL)
+    {
+        return;
+    }
+
+    fseek(sim_wav_file, 0, SEEK_SET);
+    sim_wav_header(sim_wav_data_size);
+    fclose(sim_wav_file);
+    sim_wav_file = NULL;
+}
+
+/*******************************************************************************
+* Function Name: sim_wav_start
+********************************************************************************
+* Summary:
+*  Close the current file and create the next one with a new format.
+*
+*******************************************************************************/
+static void sim_wav_start(uint8_t bits, uint32_t sample_rate_hz)
+{
+    char path[SIM_WAV_PATH_SIZE];
+    const char *extension;
+    int stem;
+
+    sim_wav_close();
+
+    if (sim_wav_files == 0u)
+    {
+        strcpy(path, sim_wav_path);
+    }
+    else
+    {
+        extension = strrchr(sim_wav_path, '.');
+        stem = (extension != NULL) ? (int) (extension - sim_wav_path) : (int) strlen(sim_wav_path);
+        snprintf(path, sizeof(path), "%.*s.%lu.wav", stem, sim_wav_path, (unsigned long) sim_wav_files);
+    }
+
+    sim_wav_file = fopen(path, "wb");
+    if (sim_wav_file == NULL)
+    {
+        sim_fail("cannot create %s", path);
+    }
+    sim_wav_files++;
+    sim_wav_bits      = bits;
+    sim_wav_rate      = sample_rate_hz;
+    sim_wav_data_size = 0;
+
+    /* The sizes are completed on close */
+    sim_wav_header(0u);
+    sim_log("capture to %s, %lu Hz, %u bits", path, (unsigned long) sample_rate_hz, bits);
+}
+
+/*******************************************************************************
+* Function Name: sim_wav_header
+********************************************************************************
+* Summary:
+*  Write the RIFF header of the current format.
+*
+*******************************************************************************/
+static void sim_wav_header(uint32_t data_size)
+{
+    uint32_t block_align = SIM_WAV_CHANNELS * (sim_wav_bits / 8u);
+
+    fwrite("RIFF", 1, 4, sim_wav_file);
+    sim_wav_put(SIM_WAV_HEADER_SIZE - 8u + data_size, 4u);
+    fwrite("WAVEfmt ", 1, 8, sim_wav_file);
+    sim_wav_put(16u, 4u);                           /* fmt chunk size */
+    sim_wav_put(1u, 2u);                            /* PCM */
+    sim_wav_put(SIM_WAV_CHANNELS, 2u);
+    sim_wav_put(sim_wav_rate, 4u);
+    sim_wav_put(sim_wav_rate * block_align, 4u);    /* Byte rate */
+    sim_wav_put(block_align, 2u);
+    sim_wav_put(sim_wav_bits, 2u);
+    fwrite("data", 1, 4, sim_wav_file);
+    sim_wav_put(data_size, 4u);
+}
+
+/*******************************************************************************
+* Function Name: sim_wav_put
+********************************************************************************
+* Summary:
+*  Write the low bytes of a value, little endian.
+*
+*******************************************************************************/
+static void sim_wav_put(uint32_t value, uint32_t bytes)
+{
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        fputc((int) ((value >> (8u * i)) & 0xFFu), sim_wav_file);
+    }
+}
+
+/* [] END OF FILE */
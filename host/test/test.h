@@ -0,0 +1,68 @@
+/*****************************************************************************
+* File Name: test.h
+*
+* Description: This file contains the check macro of the host unit tests.
+*              Each test is a program that prints one line per check and
+*              returns the number of failed checks.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TEST_H
+    #define TEST_H
+
+    #include <stdio.h>
+
+    /* Number of failed checks of the test program */
+    static unsigned int test_failures;
+
+    /* Print the result of a check, with a printf-style description */
+    #define TEST_CHECK(cond, ...)                       \
+        do                                              \
+        {                                               \
+            if (cond)                                   \
+            {                                           \
+                printf("ok   ");                        \
+            }                                           \
+            else                                        \
+            {                                           \
+                printf("FAIL ");                        \
+                test_failures++;                        \
+            }                                           \
+            printf(__VA_ARGS__);                        \
+            printf("\n");                               \
+        } while (0)
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,500 @@
+/*****************************************************************************
+* File Name: test_ak4954a_regs.c
+*
+* Description: This file contains the unit test of the AK4954A register
+*              cache against a fake codec on a fake I2C bus. Each codec
+*              transition is applied as the codec driver applies it, and the
+*              I2C write transactions it takes are compared with the
+*              register reads and writes it takes without the cache. The
+*              codec registers must match the cache after each transition,
+*              and the read-only registers must never be written.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ak4954a_regs.h"
+#include "cyhal.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TEST_I2C_ADDR           0x12u
+/* Registers of the fake codec, past the end of the cache */
+#define TEST_CODEC_REGS         0x20u
+/* Without the cache, an update is a read (address write, then read) and a
+*  write */
+#define TEST_UNCACHED_TRANSACTIONS  3u
+
+/* AK4954A registers and bits used by the transitions, see codec_ctrl.c */
+#define TEST_REG_PWR_MGMT1      0x00u
+#define TEST_REG_PWR_MGMT2      0x01u
+#define TEST_REG_MODE_CTRL1     0x05u
+#define TEST_REG_MODE_CTRL2     0x06u
+#define TEST_REG_MODE_CTRL3     0x07u
+#define TEST_REG_RCH_INPUT_VOL  0x0Eu
+#define TEST_REG_ALC_VOLUME     0x0Fu
+#define TEST_REG_LCH_OUTPUT     0x10u
+#define TEST_REG_DVOL_LCH       0x13u
+#define TEST_REG_DVOL_RCH       0x14u
+#define TEST_PMDAC              0x04u
+#define TEST_PMHP               0x30u
+#define TEST_SMUTE              0x20u
+#define TEST_FS_MASK            0x0Fu
+#define TEST_FS_48KHZ           0x0Bu
+#define TEST_FS_44KHZ           0x0Fu
+#define TEST_DIF_MASK           0x03u
+
+/* One register update of a transition */
+typedef struct
+{
+    uint8_t reg;
+    uint8_t mask;
+    uint8_t value;
+} test_update_t;
+
+/* A transition: its steps are flushed one after the other, like the steps of
+*  a codec_ctrl command */
+typedef struct
+{
+    const char *name;
+    uint32_t steps;
+    const test_update_t *updates[2];
+    uint32_t update_counts[2];
+    uint32_t transactions;      /* Expected with the cache */
+} test_transition_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void test_transition(const test_transition_t *transition);
+static uint32_t test_flush(void);
+static void test_check_codec(const char *name);
+static void test_on_done(bool success);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const test_update_t test_power_up[2][1] =
+{
+    { { TEST_REG_PWR_MGMT1, TEST_PMDAC, TEST_PMDAC } },
+    { { TEST_REG_PWR_MGMT2, TEST_PMHP, TEST_PMHP } },
+};
+static const test_update_t test_power_down[2][1] =
+{
+    { { TEST_REG_PWR_MGMT2, TEST_PMHP, 0u } },
+    { { TEST_REG_PWR_MGMT1, TEST_PMDAC, 0u } },
+};
+static const test_update_t test_volume[] =
+{
+    { TEST_REG_DVOL_LCH, 0xFFu, 0x30u },
+    { TEST_REG_DVOL_RCH, 0xFFu, 0x30u },
+};
+static const test_update_t test_mute[] =
+{
+    { TEST_REG_MODE_CTRL3, TEST_SMUTE, TEST_SMUTE },
+};
+static const test_update_t test_rate[] =
+{
+    { TEST_REG_MODE_CTRL2, TEST_FS_MASK, TEST_FS_44KHZ },
+};
+/* Two registers with an unchanged one between them */
+static const test_update_t test_span[] =
+{
+    { TEST_REG_MODE_CTRL1, TEST_DIF_MASK, 0x02u },
+    { TEST_REG_MODE_CTRL3, TEST_SMUTE, 0u },
+};
+/* Two registers on both sides of the read-only ALC volume */
+static const test_update_t test_read_only[] =
+{
+    { TEST_REG_RCH_INPUT_VOL, 0xFFu, 0x80u },
+    { TEST_REG_LCH_OUTPUT, 0xFFu, 0x11u },
+    { TEST_REG_ALC_VOLUME, 0xFFu, 0x55u },
+};
+
+static const test_transition_t test_transitions[] =
+{
+    { "power up", 2u, { test_power_up[0], test_power_up[1] }, { 1u, 1u }, 2u },
+    { "volume", 1u, { test_volume, NULL }, { 2u, 0u }, 1u },
+    { "mute", 1u, { test_mute, NULL }, { 1u, 0u }, 1u },
+    { "mute again", 1u, { test_mute, NULL }, { 1u, 0u }, 0u },
+    { "rate switch", 1u, { test_rate, NULL }, { 1u, 0u }, 1u },
+    { "span", 1u, { test_span, NULL }, { 2u, 0u }, 1u },
+    { "read-only", 1u, { test_read_only, NULL }, { 3u, 0u }, 2u },
+    { "power down", 2u, { test_power_down[0], test_power_down[1] }, { 1u, 1u }, 2u },
+};
+
+/* Fake codec */
+static uint8_t test_codec[TEST_CODEC_REGS];
+static uint8_t test_codec_pointer;
+static uint32_t test_codec_writes[TEST_CODEC_REGS];
+
+/* Fake I2C bus */
+static cyhal_i2c_t test_i2c;
+static uint32_t test_transactions;
+static uint32_t test_bytes;
+static bool test_pending;
+/* The next transfers are refused before they start */
+static bool test_refused;
+static uint8_t test_pending_data[TEST_CODEC_REGS + 1u];
+static size_t test_pending_size;
+static uint32_t test_done_calls;
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Load the cache from the fake codec and run the transitions.
+*
+* Return:
+*  int: number of failed checks
+*
+*******************************************************************************/
+int main(void)
+{
+    ak4954a_regs_stats_t stats;
+
+    /* Reset values, with the codec configured for I2S at 48 kHz */
+    for (uint32_t reg = 0; reg < TEST_CODEC_REGS; reg++)
+    {
+        test_codec[reg] = (uint8_t) (0x40u + reg);
+    }
+    test_codec[TEST_REG_PWR_MGMT1]  = 0x00u;
+    test_codec[TEST_REG_PWR_MGMT2]  = 0x00u;
+    test_codec[TEST_REG_MODE_CTRL2] = TEST_FS_48KHZ;
+    test_codec[TEST_REG_MODE_CTRL3] = 0x00u;
+
+    TEST_CHECK(ak4954a_regs_init(&test_i2c) == CY_RSLT_SUCCESS, "cache loaded");
+    test_check_codec("init");
+    test_transactions = 0u;
+    test_bytes = 0u;
+
+    for (uint32_t i = 0; i < (sizeof(test_transitions) / sizeof(test_transitions[0])); i++)
+    {
+        test_transition(&test_transitions[i]);
+    }
+
+    /* A burst the bus refuses to start is not counted, and its registers
+    *  are written by the next flush */
+    ak4954a_regs_update(TEST_REG_DVOL_LCH, 0xFFu, 0x40u);
+    test_refused = true;
+    TEST_CHECK(!ak4954a_regs_flush_async(test_on_done) && ak4954a_regs_is_dirty() && !ak4954a_regs_is_busy(),
+               "refused burst: registers kept for the next flush");
+    test_refused = false;
+    test_flush();
+    test_check_codec("refused burst");
+
+    ak4954a_regs_get_stats(&stats);
+    TEST_CHECK(stats.transactions == test_transactions, "%u transactions counted, %u on the bus",
+               stats.transactions, test_transactions);
+    TEST_CHECK(stats.bytes == test_bytes, "%u bytes counted, %u on the bus", stats.bytes, test_bytes);
+    TEST_CHECK(test_codec_writes[TEST_REG_ALC_VOLUME] == 0u, "read-only ALC volume never written");
+
+    return (int) test_failures;
+}
+
+/*******************************************************************************
+* Function Name: test_transition
+********************************************************************************
+* Summary:
+*  Apply the updates of each step of a transition and flush them. The ALC
+*  changes its volume on the way, as it does while the codec runs.
+*
+*******************************************************************************/
+static void test_transition(const test_transition_t *transition)
+{
+    uint32_t updates = 0;
+    uint32_t transactions = 0;
+
+    for (uint32_t step = 0; step < transition->steps; step++)
+    {
+        for (uint32_t i = 0; i < transition->update_counts[step]; i++)
+        {
+            const test_update_t *update = &transition->updates[step][i];
+
+            ak4954a_regs_update(update->reg, update->mask, update->value);
+            updates++;
+        }
+        test_codec[TEST_REG_ALC_VOLUME]++;
+        transactions += test_flush();
+    }
+
+    TEST_CHECK(transactions == transition->transactions,
+               "%s: %u I2C transactions with the cache, %u without (%u expected)", transition->name,
+               transactions, updates * TEST_UNCACHED_TRANSACTIONS, transition->transactions);
+    test_check_codec(transition->name);
+}
+
+/*******************************************************************************
+* Function Name: test_flush
+********************************************************************************
+* Summary:
+*  Flush the cache until it is clean, completing each burst on the fake bus.
+*
+* Return:
+*  uint32_t: I2C transactions of the flush
+*
+*******************************************************************************/
+static uint32_t test_flush(void)
+{
+    uint32_t start = test_transactions;
+    uint32_t bursts = 0;
+    bool busy;
+
+    while (ak4954a_regs_is_dirty() && (bursts <= AK4954A_REGS_COUNT))
+    {
+        test_done_calls = 0u;
+        if (!ak4954a_regs_flush_async(test_on_done))
+        {
+            TEST_CHECK(false, "flush started");
+            break;
+        }
+        busy = ak4954a_regs_is_busy() && !ak4954a_regs_flush_async(test_on_done);
+
+        /* End of the transfer, from the I2C ISR */
+        test_pending = false;
+        test_i2c.callback(test_i2c.callback_arg, CYHAL_I2C_MASTER_WR_CMPLT_EVENT);
+        if (!busy || ak4954a_regs_is_busy() || (test_done_calls != 1u))
+        {
+            TEST_CHECK(false, "burst %u busy until the I2C completes, then done once", bursts);
+        }
+        bursts++;
+    }
+
+    return test_transactions - start;
+}
+
+/*******************************************************************************
+* Function Name: test_check_codec
+********************************************************************************
+* Summary:
+*  Check that the fake codec holds the cached value of each writable
+*  register.
+*
+*******************************************************************************/
+static void test_check_codec(const char *name)
+{
+    uint32_t mismatches = 0;
+
+    for (uint32_t reg = 0; reg < AK4954A_REGS_COUNT; reg++)
+    {
+        if (((AK4954A_REGS_READ_ONLY & (1uL << reg)) == 0u) && (test_codec[reg] != ak4954a_regs_read((uint8_t) reg)))
+        {
+            mismatches++;
+        }
+    }
+    TEST_CHECK(mismatches == 0u, "%s: codec registers match the cache", name);
+}
+
+/*******************************************************************************
+* Function Name: test_on_done
+********************************************************************************
+* Summary:
+*  End of a flush.
+*
+*******************************************************************************/
+static void test_on_done(bool success)
+{
+    if (!success)
+    {
+        TEST_CHECK(false, "burst written");
+    }
+    test_done_calls++;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_master_write
+********************************************************************************
+* Summary:
+*  Fake I2C: blocking write to the fake codec. The first byte sets the
+*  register pointer, the next ones are written with auto-increment.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_master_write(cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size,
+                                 uint32_t timeout, bool send_stop)
+{
+    (void) obj;
+    (void) timeout;
+    (void) send_stop;
+
+    if ((dev_addr != TEST_I2C_ADDR) || (size == 0u))
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    test_transactions++;
+    test_bytes += size;
+
+    test_codec_pointer = data[0];
+    for (uint16_t i = 1; i < size; i++)
+    {
+        test_codec_writes[test_codec_pointer % TEST_CODEC_REGS]++;
+        test_codec[test_codec_pointer % TEST_CODEC_REGS] = data[i];
+        test_codec_pointer++;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_master_read
+********************************************************************************
+* Summary:
+*  Fake I2C: blocking read from the register pointer, with auto-increment.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_master_read(cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size,
+                                uint32_t timeout, bool send_stop)
+{
+    (void) obj;
+    (void) timeout;
+    (void) send_stop;
+
+    if (dev_addr != TEST_I2C_ADDR)
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        data[i] = test_codec[test_codec_pointer % TEST_CODEC_REGS];
+        test_codec_pointer++;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_master_transfer_async
+********************************************************************************
+* Summary:
+*  Fake I2C: start a write to the fake codec. The test completes it.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_i2c_master_transfer_async(cyhal_i2c_t *obj, uint16_t address, const void *tx, size_t tx_size,
+                                          void *rx, size_t rx_size)
+{
+    (void) rx;
+
+    if (test_refused || test_pending || (rx_size != 0u) || (tx_size > sizeof(test_pending_data)))
+    {
+        return CYHAL_RSLT_ERR_BUSY;
+    }
+
+    /* The data is on the bus while the transfer runs */
+    test_pending = true;
+    test_pending_size = tx_size;
+    memcpy(test_pending_data, tx, tx_size);
+
+    return cyhal_i2c_master_write(obj, address, test_pending_data, (uint16_t) test_pending_size, 0u, true);
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_register_callback
+********************************************************************************
+* Summary:
+*  Fake I2C: keep the event handler.
+*
+*******************************************************************************/
+void cyhal_i2c_register_callback(cyhal_i2c_t *obj, cyhal_i2c_event_callback_t callback, void *callback_arg)
+{
+    obj->callback     = callback;
+    obj->callback_arg = callback_arg;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_i2c_enable_event
+********************************************************************************
+* Summary:
+*  Fake I2C: keep the enabled events.
+*
+*******************************************************************************/
+void cyhal_i2c_enable_event(cyhal_i2c_t *obj, cyhal_i2c_event_t event, uint8_t intr_priority, bool enable)
+{
+    (void) intr_priority;
+
+    obj->events = enable ? (cyhal_i2c_event_t) (obj->events | event) : (cyhal_i2c_event_t) (obj->events & ~event);
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_enter
+********************************************************************************
+* Summary:
+*  Fake HAL: the test and the I2C completions run in the same thread.
+*
+*******************************************************************************/
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    return 0u;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_exit
+********************************************************************************
+* Summary:
+*  Fake HAL: the test and the I2C completions run in the same thread.
+*
+*******************************************************************************/
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+    (void) old_state;
+}
+
+/*******************************************************************************
+* Function Name: timebase_now
+********************************************************************************
+* Summary:
+*  Fake timebase of the trace records.
+*
+*******************************************************************************/
+uint32_t timebase_now(void)
+{
+    return 0u;
+}
+
+/*******************************************************************************
+* Function Name: sim_cycle_counter
+********************************************************************************
+* Summary:
+*  Fake cycle counter of the trace records.
+*
+*******************************************************************************/
+uint32_t sim_cycle_counter(void)
+{
+    return 0u;
+}
+
+/* [] END OF FILE */
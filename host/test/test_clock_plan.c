@@ -0,0 +1,208 @@
+/*****************************************************************************
+* File Name: test_clock_plan.c
+*
+* Description: This file contains the unit test of the audio clock planner:
+*              the plans of all the supported sample rates are recomputed
+*              from their dividers, and the PLL dividers programmed by
+*              clock_plan_set_pll() are captured by fake PDL functions.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "audio_format.h"
+#include "clock_plan.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* I2S interface clock per bit and bits per frame, as in clock_plan.c */
+#define TEST_I2S_OVERSAMPLE     8u
+#define TEST_FRAME_BITS         (AUDIO_CHANNEL_LENGTH * AUDIO_CHANNELS)
+#define TEST_PPM                1000000.0
+/* Rate of the PLL programming check */
+#define TEST_PLL_RATE_HZ        16000u
+/* Expected error of a rate without a plan */
+#define TEST_NO_PLAN            INT32_MAX
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Sample rate errors of clock_plan_rates[] with the default CPU floor and
+*  error limit, see the table of clock_plan.c. 44.1 kHz has no plan within
+*  the limit */
+static const int32_t test_rate_errors_ppm[CLOCK_PLAN_RATE_COUNT] = {
+    -186, -186, -186, TEST_NO_PLAN, -186
+};
+
+/* Last PLL configuration received by the fake PDL */
+static cy_stc_pll_manual_config_t test_pll_config;
+static uint32_t test_pll_path;
+static bool test_pll_enabled;
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Check the plan of every supported sample rate, then the programming of the
+*  PLL from a plan.
+*
+* Return:
+*  int: number of failed checks
+*
+*******************************************************************************/
+int main(void)
+{
+    clock_plan_init();
+
+    for (uint32_t i = 0; i < CLOCK_PLAN_RATE_COUNT; i++)
+    {
+        uint32_t rate = clock_plan_rates[i];
+        const clock_plan_t *plan = clock_plan_get(rate);
+
+        if (test_rate_errors_ppm[i] == TEST_NO_PLAN)
+        {
+            /* The best plan exists but is off by more than the limit */
+            clock_plan_t rejected;
+            bool solved = clock_plan_solve(rate, &rejected);
+
+            TEST_CHECK((plan == NULL) && !solved &&
+                       (abs(rejected.rate_error_ppm) > CLOCK_PLAN_MAX_ERROR_PPM),
+                       "clock_plan %u: best plan rejected, rate error %d ppm", rate,
+                       rejected.rate_error_ppm);
+            continue;
+        }
+
+        TEST_CHECK(plan != NULL, "clock_plan %u: plan found", rate);
+        if (plan == NULL)
+        {
+            continue;
+        }
+
+        /* Frequencies from the dividers, without rounding */
+        double vco_hz  = ((double) CLOCK_PLAN_REF_HZ * plan->pll_p) / plan->pll_q;
+        double pll_hz  = vco_hz / plan->pll_out_div;
+        double fs_hz   = pll_hz / ((double) plan->hfclk1_div * plan->i2s_div * TEST_I2S_OVERSAMPLE * TEST_FRAME_BITS);
+        double rate_ppm = ((fs_hz / rate) - 1.0) * TEST_PPM;
+        uint32_t peri_hz = (uint32_t) (pll_hz / CLOCK_PLAN_PERI_DIV);
+
+        TEST_CHECK((plan->pll_hz >= CLOCK_PLAN_CPU_MIN_HZ) && (plan->pll_hz <= CLOCK_PLAN_PLL_MAX_HZ),
+                   "clock_plan %u: PLL %u Hz within %u to %u Hz", rate, plan->pll_hz,
+                   CLOCK_PLAN_CPU_MIN_HZ, CLOCK_PLAN_PLL_MAX_HZ);
+        TEST_CHECK((uint32_t) (pll_hz + 0.5) == plan->pll_hz,
+                   "clock_plan %u: P %u, Q %u, output divider %u give %.1f Hz", rate,
+                   plan->pll_p, plan->pll_q, plan->pll_out_div, pll_hz);
+        TEST_CHECK(llabs((long long) (rate_ppm - plan->rate_error_ppm)) <= 1,
+                   "clock_plan %u: rate error %d ppm, %.1f ppm from the dividers", rate,
+                   plan->rate_error_ppm, rate_ppm);
+        TEST_CHECK(plan->rate_error_ppm == test_rate_errors_ppm[i],
+                   "clock_plan %u: rate error %d ppm, %d ppm expected", rate,
+                   plan->rate_error_ppm, test_rate_errors_ppm[i]);
+        /* The HAL truncates the PWM period: CLK_PERI / mclk_hz */
+        TEST_CHECK((peri_hz / plan->mclk_hz) == plan->pwm_div,
+                   "clock_plan %u: MCLK %u Hz gives a PWM period of %u, %u planned", rate,
+                   plan->mclk_hz, peri_hz / plan->mclk_hz, plan->pwm_div);
+    }
+
+    const clock_plan_t *plan = clock_plan_get(TEST_PLL_RATE_HZ);
+    bool set = (plan != NULL) && clock_plan_set_pll(plan);
+
+    TEST_CHECK(set && test_pll_enabled && (test_pll_path == CLOCK_PLAN_PLL_PATH) &&
+               (test_pll_config.feedbackDiv == plan->pll_p) &&
+               (test_pll_config.referenceDiv == plan->pll_q) &&
+               (test_pll_config.outputDiv == plan->pll_out_div),
+               "clock_plan: PLL programmed with P %u, Q %u, output divider %u",
+               test_pll_config.feedbackDiv, test_pll_config.referenceDiv, test_pll_config.outputDiv);
+
+    return (int) test_failures;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysClk_PllDisable
+********************************************************************************
+* Summary:
+*  Fake PDL: disable the PLL.
+*
+*******************************************************************************/
+cy_en_sysclk_status_t Cy_SysClk_PllDisable(uint32_t clkPath)
+{
+    test_pll_path = clkPath;
+    test_pll_enabled = false;
+
+    return CY_SYSCLK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysClk_PllManualConfigure
+********************************************************************************
+* Summary:
+*  Fake PDL: capture the PLL dividers. The PLL must be disabled.
+*
+*******************************************************************************/
+cy_en_sysclk_status_t Cy_SysClk_PllManualConfigure(uint32_t clkPath, const cy_stc_pll_manual_config_t *config)
+{
+    if ((clkPath != test_pll_path) || test_pll_enabled)
+    {
+        return CY_SYSCLK_INVALID_STATE;
+    }
+
+    test_pll_config = *config;
+
+    return CY_SYSCLK_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysClk_PllEnable
+********************************************************************************
+* Summary:
+*  Fake PDL: enable the PLL, which locks at once.
+*
+*******************************************************************************/
+cy_en_sysclk_status_t Cy_SysClk_PllEnable(uint32_t clkPath, uint32_t timeoutus)
+{
+    (void) timeoutus;
+
+    if (clkPath != test_pll_path)
+    {
+        return CY_SYSCLK_INVALID_STATE;
+    }
+
+    test_pll_enabled = true;
+
+    return CY_SYSCLK_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,373 @@
+/*****************************************************************************
+* File Name: test_codec_ctrl.c
+*
+* Description: This file contains the unit test of the codec command queue on
+*              the simulated I2C of the host. A fake AK4954A on the bus logs
+*              the register writes, in virtual time. The commands are checked
+*              to reach the codec in order, the power sequence to keep the DAC
+*              powered while the headphone amplifiers are, and the submissions
+*              to return at once: the main loop sleeps while the bus works.
+*
+*              codec registers must match the cache after each transition,
+*              and the read-only registers must never be written.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ak4954a_regs.h"
+#include "codec_ctrl.h"
+#include "cyhal.h"
+#include "sim.h"
+#include "test.h"
+#include "timebase.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TEST_I2C_ADDR           0x12u
+#define TEST_I2C_HZ             400000u
+/* Registers of the fake codec, past the end of the cache */
+#define TEST_CODEC_REGS         0x20u
+#define TEST_LOG_SIZE           64u
+/* Virtual time of the run: far more than the commands take */
+#define TEST_END_NS             (100u * SIM_NS_PER_MS)
+
+/* AK4954A registers and bits written by the commands, see codec_ctrl.c */
+#define TEST_REG_PWR_MGMT1      0x00u
+#define TEST_REG_PWR_MGMT2      0x01u
+#define TEST_REG_MODE_CTRL3     0x07u
+#define TEST_REG_DVOL_LCH       0x13u
+#define TEST_REG_DVOL_RCH       0x14u
+#define TEST_PMDAC              0x04u
+#define TEST_PMHP               0x30u
+#define TEST_SMUTE              0x20u
+#define TEST_VOLUME             0x30u
+
+/* Register write received by the fake codec */
+typedef struct
+{
+    uint8_t reg;
+    uint8_t value;
+    uint64_t time;
+} test_write_t;
+
+/* Command completion */
+typedef struct
+{
+    codec_ctrl_op_t op;
+    bool success;
+    uint32_t writes;            /* Register writes received before it */
+} test_done_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void test_submit(codec_ctrl_op_t op, uint8_t value, codec_ctrl_done_t done);
+static uint32_t test_run(void);
+static int32_t test_find(uint8_t reg, uint8_t mask, uint8_t value, uint32_t from);
+static void test_on_done(codec_ctrl_op_t op, bool success, void *arg);
+static void test_on_mute_done(codec_ctrl_op_t op, bool success, void *arg);
+static bool test_codec_write(const uint8_t *data, size_t size);
+static bool test_codec_read(uint8_t *data, size_t size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const sim_i2c_slave_t test_codec_slave =
+{
+    .address  = TEST_I2C_ADDR,
+    .on_write = test_codec_write,
+    .on_read  = test_codec_read,
+};
+
+/* Fake codec */
+static uint8_t test_codec[TEST_CODEC_REGS];
+static uint8_t test_codec_pointer;
+static test_write_t test_writes[TEST_LOG_SIZE];
+static uint32_t test_write_count;
+
+static cyhal_i2c_t test_i2c;
+static test_done_t test_dones[TEST_LOG_SIZE];
+static uint32_t test_done_count;
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Run the commands of a playback: power up, volume and unmute, then mute
+*  and power down, the power down being submitted from the I2C ISR. Then a
+*  command is refused by the bus.
+*
+* Return:
+*  int: number of failed checks
+*
+*******************************************************************************/
+int main(void)
+{
+    const cyhal_i2c_cfg_t config = { .is_slave = false, .address = 0u, .frequencyhal_hz = TEST_I2C_HZ };
+    codec_ctrl_stats_t stats;
+    int32_t dac_on;
+    int32_t hp_on;
+    int32_t dac_off;
+    int32_t hp_off;
+    uint32_t sleeps;
+
+    /* Soft mute is set at reset */
+    test_codec[TEST_REG_MODE_CTRL3] = TEST_SMUTE;
+
+    sim_init(TEST_END_NS, false);
+    timebase_init();
+    cyhal_i2c_init(&test_i2c, NC, NC, NULL);
+    cyhal_i2c_configure(&test_i2c, &config);
+    sim_i2c_attach(&test_codec_slave);
+
+    TEST_CHECK(ak4954a_regs_init(&test_i2c) == CY_RSLT_SUCCESS, "cache loaded from the codec");
+    codec_ctrl_init();
+
+    /* Playback start, from the main loop */
+    test_submit(CODEC_CTRL_POWER, 1u, test_on_done);
+    test_submit(CODEC_CTRL_VOLUME, TEST_VOLUME, test_on_done);
+    test_submit(CODEC_CTRL_MUTE, 0u, test_on_done);
+    TEST_CHECK(test_write_count == 0u, "no register written when the submissions return");
+    sleeps = test_run();
+    TEST_CHECK(sleeps >= 4u, "main loop slept through the %u bursts (%u sleeps)", 4u, sleeps);
+
+    dac_on = test_find(TEST_REG_PWR_MGMT1, TEST_PMDAC, TEST_PMDAC, 0u);
+    hp_on  = test_find(TEST_REG_PWR_MGMT2, TEST_PMHP, TEST_PMHP, 0u);
+    TEST_CHECK((dac_on >= 0) && (hp_on > dac_on), "DAC powered up before the headphone amplifiers");
+    TEST_CHECK(test_writes[hp_on].time > test_writes[dac_on].time, "power up in separate bursts");
+    TEST_CHECK(test_find(TEST_REG_DVOL_LCH, 0xFFu, TEST_VOLUME, (uint32_t) hp_on) > hp_on, "volume after the power up");
+    TEST_CHECK(test_find(TEST_REG_DVOL_RCH, 0xFFu, TEST_VOLUME, (uint32_t) hp_on) > hp_on, "both channels set");
+    TEST_CHECK(test_writes[test_write_count - 1u].reg == TEST_REG_MODE_CTRL3, "unmuted last");
+    TEST_CHECK((test_done_count == 3u) && (test_dones[0].op == CODEC_CTRL_POWER) &&
+               (test_dones[1].op == CODEC_CTRL_VOLUME) && (test_dones[2].op == CODEC_CTRL_MUTE),
+               "commands completed in the order of submission");
+    TEST_CHECK((test_dones[0].writes == (uint32_t) hp_on + 1u) && (test_dones[2].writes == test_write_count),
+               "each command completed once its registers were written");
+
+    /* Playback end: the power down is queued from the I2C ISR */
+    test_write_count = 0u;
+    test_done_count  = 0u;
+    test_submit(CODEC_CTRL_MUTE, 1u, test_on_mute_done);
+    (void) test_run();
+    dac_off = test_find(TEST_REG_PWR_MGMT1, TEST_PMDAC, 0u, 0u);
+    hp_off  = test_find(TEST_REG_PWR_MGMT2, TEST_PMHP, 0u, 0u);
+    TEST_CHECK((test_writes[0].reg == TEST_REG_MODE_CTRL3) && ((test_writes[0].value & TEST_SMUTE) != 0u),
+               "muted first");
+    TEST_CHECK((hp_off > 0) && (dac_off > hp_off), "headphone amplifiers powered down before the DAC");
+    TEST_CHECK((test_done_count == 2u) && (test_dones[1].op == CODEC_CTRL_POWER) && test_dones[1].success,
+               "power down submitted from the ISR completed");
+
+    /* No codec on the bus: the command fails, its registers are written with
+    *  the next one */
+    test_write_count = 0u;
+    test_done_count  = 0u;
+    sim_i2c_attach(NULL);
+    test_submit(CODEC_CTRL_VOLUME, TEST_VOLUME + 1u, test_on_done);
+    (void) test_run();
+    TEST_CHECK((test_done_count == 1u) && !test_dones[0].success, "command failed on a NACK");
+    sim_i2c_attach(&test_codec_slave);
+    test_submit(CODEC_CTRL_MUTE, 0u, test_on_done);
+    (void) test_run();
+    TEST_CHECK((test_done_count == 2u) && test_dones[1].success, "next command written");
+    TEST_CHECK(test_codec[TEST_REG_DVOL_LCH] == (TEST_VOLUME + 1u), "failed registers written again");
+
+    codec_ctrl_get_stats(&stats);
+    TEST_CHECK((stats.submitted == 7u) && (stats.completed == 6u) && (stats.failed == 1u),
+               "%u commands submitted, %u completed, %u failed", stats.submitted, stats.completed, stats.failed);
+    TEST_CHECK(stats.max_submit_cycles == 0u, "submissions take no bus time (%u cycles at most)",
+               stats.max_submit_cycles);
+
+    return (int) test_failures;
+}
+
+/*******************************************************************************
+* Function Name: test_submit
+********************************************************************************
+* Summary:
+*  Submit a command from the main loop, which must not wait for the bus.
+*
+*******************************************************************************/
+static void test_submit(codec_ctrl_op_t op, uint8_t value, codec_ctrl_done_t done)
+{
+    uint64_t start = sim_now();
+    bool queued = codec_ctrl_submit(op, value, done, NULL);
+
+    if (!queued || (sim_now() != start))
+    {
+        TEST_CHECK(false, "command %u queued without waiting", (uint32_t) op);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_run
+********************************************************************************
+* Summary:
+*  Main loop: sleep until the queue is idle.
+*
+* Return:
+*  uint32_t: number of sleeps
+*
+*******************************************************************************/
+static uint32_t test_run(void)
+{
+    uint32_t sleeps = 0;
+
+    while (!codec_ctrl_is_idle())
+    {
+        cyhal_syspm_sleep();
+        sleeps++;
+    }
+
+    return sleeps;
+}
+
+/*******************************************************************************
+* Function Name: test_find
+********************************************************************************
+* Summary:
+*  Find a write of the fake codec log.
+*
+* Parameters:
+*  reg: register written
+*  mask: bits compared
+*  value: value of the bits
+*  from: first write searched
+*
+* Return:
+*  int32_t: index of the write, -1 if none
+*
+*******************************************************************************/
+static int32_t test_find(uint8_t reg, uint8_t mask, uint8_t value, uint32_t from)
+{
+    for (uint32_t i = from; i < test_write_count; i++)
+    {
+        if ((test_writes[i].reg == reg) && ((test_writes[i].value & mask) == value))
+        {
+            return (int32_t) i;
+        }
+    }
+
+    return -1;
+}
+
+/*******************************************************************************
+* Function Name: test_on_done
+********************************************************************************
+* Summary:
+*  Command completion, from the I2C ISR.
+*
+*******************************************************************************/
+static void test_on_done(codec_ctrl_op_t op, bool success, void *arg)
+{
+    (void) arg;
+
+    if (test_done_count < TEST_LOG_SIZE)
+    {
+        test_dones[test_done_count].op      = op;
+        test_dones[test_done_count].success = success;
+        test_dones[test_done_count].writes  = test_write_count;
+        test_done_count++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_on_mute_done
+********************************************************************************
+* Summary:
+*  End of the mute, from the I2C ISR: power the codec down.
+*
+*******************************************************************************/
+static void test_on_mute_done(codec_ctrl_op_t op, bool success, void *arg)
+{
+    test_on_done(op, success, arg);
+    if (!codec_ctrl_submit(CODEC_CTRL_POWER, 0u, test_on_done, NULL))
+    {
+        TEST_CHECK(false, "power down queued from the ISR");
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_codec_write
+********************************************************************************
+* Summary:
+*  Fake codec: the first byte sets the register pointer, the next ones are
+*  written from it on.
+*
+*******************************************************************************/
+static bool test_codec_write(const uint8_t *data, size_t size)
+{
+    test_codec_pointer = data[0];
+    for (size_t i = 1; i < size; i++)
+    {
+        if ((test_codec_pointer >= TEST_CODEC_REGS) || (test_write_count >= TEST_LOG_SIZE))
+        {
+            return false;
+        }
+        test_codec[test_codec_pointer] = data[i];
+        test_writes[test_write_count].reg   = test_codec_pointer;
+        test_writes[test_write_count].value = data[i];
+        test_writes[test_write_count].time  = sim_now();
+        test_write_count++;
+        test_codec_pointer++;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: test_codec_read
+********************************************************************************
+* Summary:
+*  Fake codec: read from the register pointer on.
+*
+*******************************************************************************/
+static bool test_codec_read(uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (test_codec_pointer >= TEST_CODEC_REGS)
+        {
+            return false;
+        }
+        data[i] = test_codec[test_codec_pointer++];
+    }
+
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,266 @@
+/*****************************************************************************
+* File Name: test_codec_mock.c
+*
+* Description: This file contains the test of the codec call sequence. The
+*              application runs on the simulator with the recording codec
+*              (codec_mock.c), whose power-up completes after a latency, and
+*              the button is pressed before and after the codec idle timeout.
+*              When the run ends, the recorded calls are checked: the codec
+*              is unmuted only once powered, powered down only after the mute
+*              ramp, and powered up only when it was down.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "cybsp.h"
+#include "codec.h"
+#include "sim.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Power-up time of the recording codec */
+#define TEST_LATENCY_US         5000u
+/* Button presses, in ms: the first one with the codec powered, the second
+*  one after the idle timeout, the third one during the second clip, the
+*  fourth one with a failing power-up and the fifth one right after it */
+#define TEST_PRESSES_MS         { 100u, 6000u, 6500u, 10000u, 10500u }
+#define TEST_PRESS_COUNT        5u
+#define TEST_HOLD_MS            100u
+/* Press whose power-up fails */
+#define TEST_FAILED_PRESS       3u
+/* End of the run, after the third power-down */
+#define TEST_END_MS             16000u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+int app_main(void);
+
+static void test_script_event(sim_device_t *device);
+static void test_check_calls(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Set by the application, see main.c */
+extern uint32_t press_to_play_us;
+
+static const uint32_t test_presses_ms[TEST_PRESS_COUNT] = TEST_PRESSES_MS;
+/* Next button edge: even for a press, odd for a release */
+static uint32_t test_edge;
+static sim_device_t test_script;
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Schedule the presses and run the application. The run ends in
+*  sim_finish(), which exits: the calls are checked from the exit handler.
+*
+* Return:
+*  int: number of failed checks
+*
+*******************************************************************************/
+int main(void)
+{
+    sim_init((uint64_t) TEST_END_MS * SIM_NS_PER_MS, false);
+    codec_mock_set_latency(TEST_LATENCY_US);
+
+    sim_register(&test_script, "script");
+    test_script.on_deadline = test_script_event;
+    test_script.deep_sleep  = true;
+    test_script.deadline    = (uint64_t) test_presses_ms[0] * SIM_NS_PER_MS;
+
+    atexit(test_check_calls);
+
+    return app_main();
+}
+
+/*******************************************************************************
+* Function Name: test_script_event
+********************************************************************************
+* Summary:
+*  Drive the next edge of the button and schedule the following one.
+*
+*******************************************************************************/
+static void test_script_event(sim_device_t *device)
+{
+    uint32_t press = test_edge / 2u;
+    bool release = ((test_edge % 2u) != 0u);
+    uint64_t next_ms;
+
+    if (!release && (press == TEST_FAILED_PRESS))
+    {
+        codec_mock_fail_next(CODEC_MOCK_ACTIVATE);
+    }
+
+    sim_gpio_drive(CYBSP_USER_BTN, release ? (CYBSP_BTN_OFF != 0u) : (CYBSP_BTN_PRESSED != 0u));
+    test_edge++;
+
+    if (!release)
+    {
+        next_ms = test_presses_ms[press] + TEST_HOLD_MS;
+    }
+    else if ((press + 1u) < TEST_PRESS_COUNT)
+    {
+        next_ms = test_presses_ms[press + 1u];
+    }
+    else
+    {
+        device->deadline = SIM_NEVER;
+        return;
+    }
+    device->deadline = next_ms * SIM_NS_PER_MS;
+}
+
+/*******************************************************************************
+* Function Name: test_check_calls
+********************************************************************************
+* Summary:
+*  Walk the recorded calls with the power state of the codec output, and
+*  check the sequence. Exits with the number of failed checks.
+*
+*******************************************************************************/
+static void test_check_calls(void)
+{
+    const codec_mock_call_t *calls;
+    uint32_t count = codec_mock_get_calls(&calls);
+    uint64_t latency_ns = (uint64_t) TEST_LATENCY_US * SIM_NS_PER_US;
+    uint64_t ramp_ns = (uint64_t) CODEC_MUTE_MS * SIM_NS_PER_MS;
+    uint64_t mute_time = 0;
+    uint64_t sequence_time = 0;
+    bool powered = true;
+    bool muted = true;
+    bool pending = false;
+    uint32_t activations = 0;
+    uint32_t power_downs = 0;
+    uint32_t unmutes = 0;
+    uint32_t failures = 0;
+    uint32_t bad_activations = 0;
+    uint32_t bad_completions = 0;
+    uint32_t bad_power_downs = 0;
+    uint32_t bad_unmutes = 0;
+
+    TEST_CHECK((count > 0u) && (calls[0].type == CODEC_MOCK_INIT), "codec initialized first");
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        const codec_mock_call_t *call = &calls[i];
+
+        switch (call->type)
+        {
+            case CODEC_MOCK_ACTIVATE:
+            case CODEC_MOCK_RATE_BEGIN:
+            case CODEC_MOCK_RATE_END:
+                if (pending || ((call->type == CODEC_MOCK_ACTIVATE) && powered))
+                {
+                    bad_activations++;
+                }
+                activations += (call->type == CODEC_MOCK_ACTIVATE) ? 1u : 0u;
+                pending = true;
+                sequence_time = call->time;
+                break;
+
+            case CODEC_MOCK_DONE:
+            case CODEC_MOCK_FAILED:
+                if (!pending || ((call->time - sequence_time) != latency_ns))
+                {
+                    bad_completions++;
+                }
+                /* A failed power-up leaves the output down */
+                if ((call->arg == (uint32_t) CODEC_MOCK_ACTIVATE) && (call->type == CODEC_MOCK_DONE))
+                {
+                    powered = true;
+                }
+                failures += (call->type == CODEC_MOCK_FAILED) ? 1u : 0u;
+                pending = false;
+                break;
+
+            case CODEC_MOCK_POWER_DOWN:
+                if (!muted || ((call->time - mute_time) < ramp_ns))
+                {
+                    bad_power_downs++;
+                }
+                powered = false;
+                power_downs++;
+                break;
+
+            case CODEC_MOCK_MUTE:
+                if (call->arg != 0u)
+                {
+                    muted = true;
+                    mute_time = call->time;
+                }
+                else
+                {
+                    if (!powered || pending)
+                    {
+                        bad_unmutes++;
+                    }
+                    muted = false;
+                    unmutes++;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    TEST_CHECK(count < CODEC_MOCK_LOG_SIZE, "%u calls recorded", count);
+    TEST_CHECK(unmutes == 3u, "three clips unmuted, the press during a clip and the failed one ignored (%u)",
+               unmutes);
+    TEST_CHECK(failures == 1u, "one power-up failed (%u)", failures);
+    TEST_CHECK(power_downs == 4u, "codec powered down after each clip and the failed power-up (%u)", power_downs);
+    TEST_CHECK(activations == 3u, "codec powered up after each idle timeout and after the failure (%u)",
+               activations);
+    TEST_CHECK(bad_activations == 0u, "sequences started one at a time, power-up only when down");
+    TEST_CHECK(bad_completions == 0u, "sequences completed after the codec latency");
+    TEST_CHECK(bad_power_downs == 0u, "powered down only after a %u ms mute ramp", CODEC_MUTE_MS);
+    TEST_CHECK(bad_unmutes == 0u, "unmuted only once powered up");
+    TEST_CHECK(press_to_play_us >= TEST_LATENCY_US, "playback started after the power-up (%u us from the press)",
+               press_to_play_us);
+
+    fflush(stdout);
+    _exit((int) test_failures);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,180 @@
+/*****************************************************************************
+* File Name: test_dds.c
+*
+* Description: This file contains the unit test of the DDS voice: the THD+N
+*              of a sine tone, measured against a least-squares fit of the
+*              fundamental.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdint.h>
+
+#include "audio_dds.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TEST_SAMPLE_RATE_HZ     48000u
+#define TEST_TONE_HZ            997u
+/* One second of steady tone, without attack or release */
+#define TEST_FRAMES             TEST_SAMPLE_RATE_HZ
+/* THD+N limit of the sine table with linear interpolation, in dB: about
+*  -90 dB is measured, limited by the interpolation error of the 256 entries */
+#define TEST_THDN_LIMIT_DB      (-88.0)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static double test_thdn_db(const int32_t *samples, uint32_t count, double tone_hz, double rate_hz);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static int32_t test_samples[TEST_FRAMES];
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Render a 997 Hz full-scale sine at 48 kHz and check its THD+N.
+*
+* Return:
+*  int: number of failed checks
+*
+*******************************************************************************/
+int main(void)
+{
+    static const audio_dds_tone_t tone = {
+        .wave = AUDIO_DDS_SINE,
+        .start_hz = TEST_TONE_HZ,
+        .end_hz = TEST_TONE_HZ,
+        .duration_ms = 1000u,
+        .attack_ms = 0u,
+        .release_ms = 0u,
+        .gain = AUDIO_GAIN_UNITY,
+    };
+    audio_dds_voice_t voice;
+    uint32_t count;
+    double thdn;
+
+    audio_dds_voice_init(&voice, &tone, TEST_SAMPLE_RATE_HZ);
+    count = voice.voice.render(&voice.voice, test_samples, TEST_FRAMES);
+
+    TEST_CHECK(count == TEST_FRAMES, "dds: %u of %u frames rendered", count, TEST_FRAMES);
+
+    thdn = test_thdn_db(test_samples, count, TEST_TONE_HZ, TEST_SAMPLE_RATE_HZ);
+    TEST_CHECK(thdn <= TEST_THDN_LIMIT_DB, "dds: sine THD+N %.1f dB at %u Hz (limit %.1f dB)",
+               thdn, TEST_TONE_HZ, TEST_THDN_LIMIT_DB);
+
+    return (int) test_failures;
+}
+
+/*******************************************************************************
+* Function Name: test_thdn_db
+********************************************************************************
+* Summary:
+*  Measure the THD+N of a tone: fit a sine, a cosine and an offset at the tone
+*  frequency by least squares, and compare the power of the residual with
+*  the power of the fitted tone.
+*
+* Parameters:
+*  samples: tone samples
+*  count: number of samples
+*  tone_hz: frequency of the tone
+*  rate_hz: sample rate
+*
+* Return:
+*  double: THD+N in dB
+*
+*******************************************************************************/
+static double test_thdn_db(const int32_t *samples, uint32_t count, double tone_hz, double rate_hz)
+{
+    double m[3][4] = { { 0 } };
+    double fit[3];
+    double tone_power = 0.0;
+    double residual_power = 0.0;
+
+    /* Normal equations of the fit, as an augmented matrix */
+    for (uint32_t n = 0; n < count; n++)
+    {
+        double w = 2.0 * M_PI * tone_hz * (double) n / rate_hz;
+        double basis[3] = { sin(w), cos(w), 1.0 };
+
+        for (uint32_t i = 0; i < 3u; i++)
+        {
+            for (uint32_t j = 0; j < 3u; j++)
+            {
+                m[i][j] += basis[i] * basis[j];
+            }
+            m[i][3] += basis[i] * (double) samples[n];
+        }
+    }
+
+    /* Gauss-Jordan elimination; the matrix is well conditioned */
+    for (uint32_t i = 0; i < 3u; i++)
+    {
+        for (uint32_t k = 0; k < 3u; k++)
+        {
+            if (k != i)
+            {
+                double factor = m[k][i] / m[i][i];
+
+                for (uint32_t j = i; j < 4u; j++)
+                {
+                    m[k][j] -= factor * m[i][j];
+                }
+            }
+        }
+    }
+    for (uint32_t i = 0; i < 3u; i++)
+    {
+        fit[i] = m[i][3] / m[i][i];
+    }
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        double w = 2.0 * M_PI * tone_hz * (double) n / rate_hz;
+        double tone = (fit[0] * sin(w)) + (fit[1] * cos(w));
+        double residual = (double) samples[n] - tone - fit[2];
+
+        tone_power     += tone * tone;
+        residual_power += residual * residual;
+    }
+
+    return 10.0 * log10(residual_power / tone_power);
+}
+
+/* [] END OF FILE */
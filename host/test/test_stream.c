@@ -0,0 +1,186 @@
+/*****************************************************************************
+* File Name: test_stream.c
+*
+* Description: This file contains the unit test of the stream voice: a
+*              producer running off its own clock, a few hundred ppm away
+*              from the output clock, feeds the stream for minutes of
+*              virtual time. The drift controller must converge to the
+*              clock offset without an underflow or an overflow.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "audio_stream.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TEST_SAMPLE_RATE_HZ     48000u
+/* Ring buffer, about 21 ms */
+#define TEST_BUFFER_SIZE        1024u
+/* Producer packets of 1 ms at the nominal rate */
+#define TEST_PACKET_SAMPLES     48u
+/* Virtual time of each scenario, and time left to the controller to settle */
+#define TEST_DURATION_S         600u
+#define TEST_SETTLE_S           300u
+/* Largest distance of the settled correction from the clock offset */
+#define TEST_PPM_TOLERANCE      20
+/* Largest distance of the settled buffer fill from half full */
+#define TEST_FILL_TOLERANCE     (TEST_BUFFER_SIZE / 8u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void test_stream_drift(int32_t source_ppm);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static int16_t test_buffer[TEST_BUFFER_SIZE];
+static int32_t test_block[AUDIO_BLOCK_FRAMES];
+static int16_t test_packet[TEST_PACKET_SAMPLES];
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Run the drift scenario with sources slower and faster than the output.
+*
+* Return:
+*  int: number of failed checks
+*
+*******************************************************************************/
+int main(void)
+{
+    static const int32_t source_ppm[] = { -1500, -300, 300, 1500 };
+
+    for (uint32_t i = 0; i < (sizeof(source_ppm) / sizeof(source_ppm[0])); i++)
+    {
+        test_stream_drift(source_ppm[i]);
+    }
+
+    return (int) test_failures;
+}
+
+/*******************************************************************************
+* Function Name: test_stream_drift
+********************************************************************************
+* Summary:
+*  Play a stream whose producer runs source_ppm faster than the output. The
+*  output renders one block at a time; between two blocks, the producer
+*  writes the whole packets its clock has made since the last block.
+*
+* Parameters:
+*  source_ppm: clock offset of the producer
+*
+*******************************************************************************/
+static void test_stream_drift(int32_t source_ppm)
+{
+    audio_stream_t stream;
+    audio_stream_stats_t stats;
+    uint64_t blocks = ((uint64_t) TEST_DURATION_S * TEST_SAMPLE_RATE_HZ) / AUDIO_BLOCK_FRAMES;
+    uint64_t settle = ((uint64_t) TEST_SETTLE_S * TEST_SAMPLE_RATE_HZ) / AUDIO_BLOCK_FRAMES;
+    uint64_t packets = 0;
+    uint32_t underruns = 0;
+    uint32_t overruns = 0;
+    uint32_t fill_min = UINT32_MAX;
+    uint32_t fill_max = 0;
+
+    audio_stream_init(&stream, test_buffer, TEST_BUFFER_SIZE);
+
+    for (uint64_t block = 0; block < blocks; block++)
+    {
+        /* Packets made by the producer clock until the end of this block */
+        uint64_t due = ((block * AUDIO_BLOCK_FRAMES) * (uint64_t) (1000000 + source_ppm)) /
+                       ((uint64_t) TEST_PACKET_SAMPLES * 1000000u);
+
+        for (; packets < due; packets++)
+        {
+            (void) audio_stream_write(&stream, test_packet, TEST_PACKET_SAMPLES);
+        }
+
+        (void) stream.voice.render(&stream.voice, test_block, AUDIO_BLOCK_FRAMES);
+
+        audio_stream_get_stats(&stream, &stats);
+        if (block == settle)
+        {
+            underruns = stats.underruns;
+            overruns  = stats.overruns;
+        }
+        else if (block > settle)
+        {
+            fill_min = (stats.fill_average < fill_min) ? stats.fill_average : fill_min;
+            fill_max = (stats.fill_average > fill_max) ? stats.fill_average : fill_max;
+        }
+    }
+
+    TEST_CHECK(stats.underruns == 0u, "stream %+d ppm: %u samples underflowed", source_ppm, stats.underruns);
+    TEST_CHECK(stats.overruns == 0u, "stream %+d ppm: %u samples overflowed", source_ppm, stats.overruns);
+    TEST_CHECK((stats.underruns == underruns) && (stats.overruns == overruns),
+               "stream %+d ppm: no glitch once settled", source_ppm);
+    TEST_CHECK(abs(stats.correction_ppm - source_ppm) <= TEST_PPM_TOLERANCE,
+               "stream %+d ppm: correction converged to %+d ppm", source_ppm, stats.correction_ppm);
+    TEST_CHECK((fill_min >= ((TEST_BUFFER_SIZE / 2u) - TEST_FILL_TOLERANCE)) &&
+               (fill_max <= ((TEST_BUFFER_SIZE / 2u) + TEST_FILL_TOLERANCE)),
+               "stream %+d ppm: settled fill %u to %u samples", source_ppm, fill_min, fill_max);
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_enter
+********************************************************************************
+* Summary:
+*  Fake HAL: the producer and the voice run in the same thread.
+*
+*******************************************************************************/
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    return 0u;
+}
+
+/*******************************************************************************
+* Function Name: cyhal_system_critical_section_exit
+********************************************************************************
+* Summary:
+*  Fake HAL: the producer and the voice run in the same thread.
+*
+*******************************************************************************/
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+    (void) old_state;
+}
+
+/* [] END OF FILE */
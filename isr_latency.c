@@ -0,0 +1,401 @@
+/*****************************************************************************
+* File Name: isr_latency.c
+*
+* Description: This file contains the latency measurement of the audio ISR.
+*              The blocks are paced by the I2S clock, so the TX complete events
+*              are exactly one block period apart: the hardware event time of
+*              each block is reconstructed from this cadence and compared with
+*              the handler entry, read from a timer counting CLK_PERI (not
+*              affected by the CPU clock governor). The block period is an
+*              exact number of CLK_PERI cycles, so the cadence does not drift.
+*              An optional periodic interrupt adds a competing load.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cyhal.h"
+
+#include "isr_latency.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Entries skipped at the start of a clip, while the FIFO fills */
+#define LATENCY_SKIP_ENTRIES    2u
+/* Entries used to find the baseline before the histogram is filled */
+#define LATENCY_BASELINE_ENTRIES    8u
+/* Frequency of the competing load timer */
+#define LATENCY_LOAD_TIMER_HZ   1000000u    /* in Hz */
+/* TCPWM block with 32-bit counters (TCPWM0 on PSoC 6, the other blocks
+*  count 16 bits). The latency timer wraps at 2^32 ticks. */
+#define LATENCY_TIMER_BLOCK     0u
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void latency_load_handler(void *arg, cyhal_timer_event_t event);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_clock_t latency_clock;
+static cyhal_timer_t latency_timer;
+/* Frequency of the latency timer (CLK_PERI) */
+static uint32_t latency_timer_hz;
+static cyhal_timer_t latency_load_timer;
+static uint32_t latency_load_busy_us;
+static bool latency_load_init;
+static bool latency_load_running;
+/* The latency timer is running */
+static bool latency_enabled;
+
+/* Block period in timer ticks */
+static uint32_t latency_period;
+/* Entries since the clip started */
+static uint32_t latency_entries;
+/* Timer value of the cadence slot of the last entry */
+static uint32_t latency_slot_time;
+/* Lowest offset of an entry from its cadence slot, in timer ticks */
+static int32_t latency_baseline;
+
+static isr_latency_stats_t latency_stats;
+
+/*******************************************************************************
+* Function Name: isr_latency_init
+********************************************************************************
+* Summary:
+*  Initialize the free-running latency timer. It counts CLK_PERI through a
+*  peripheral divider set to 1, on a 32-bit counter: the offsets are computed
+*  modulo 2^32.
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS, ISR_LATENCY_RSLT_ERR_WIDTH if the allocated
+*             counter is not 32-bit, or the error of the timer HAL. The
+*             latency is not measured after an error.
+*
+*******************************************************************************/
+cy_rslt_t isr_latency_init(void)
+{
+    const cyhal_timer_cfg_t config =
+    {
+        .is_continuous = true,
+        .direction     = CYHAL_TIMER_DIR_UP,
+        .is_compare    = false,
+        .period        = UINT32_MAX,
+        .compare_value = 0,
+        .value         = 0,
+    };
+
+    cy_rslt_t result;
+
+    latency_enabled = false;
+    isr_latency_reset();
+
+    cyhal_clock_allocate(&latency_clock, CYHAL_CLOCK_BLOCK_PERIPHERAL_16BIT);
+    cyhal_clock_set_divider(&latency_clock, 1u);
+    cyhal_clock_set_enabled(&latency_clock, true, true);
+
+    /* The first free counter is allocated, the 32-bit ones come first */
+    result = cyhal_timer_init(&latency_timer, NC, &latency_clock);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    if (latency_timer.tcpwm.resource.block_num != LATENCY_TIMER_BLOCK)
+    {
+        return ISR_LATENCY_RSLT_ERR_WIDTH;
+    }
+
+    result = cyhal_timer_configure(&latency_timer, &config);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_timer_start(&latency_timer);
+    }
+
+    latency_enabled = (result == CY_RSLT_SUCCESS);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: isr_latency_start
+********************************************************************************
+* Summary:
+*  Called when a clip starts, after the sample rate is set.
+*
+* Parameters:
+*  period_frames: frames per block
+*  plan: clock plan of the sample rate
+*
+*******************************************************************************/
+void isr_latency_start(uint32_t period_frames, const clock_plan_t *plan)
+{
+    latency_timer_hz = cyhal_clock_get_frequency(&latency_clock);
+    latency_period   = period_frames * clock_plan_frame_peri_cycles(plan);
+    latency_entries  = 0;
+}
+
+/*******************************************************************************
+* Function Name: isr_latency_on_peri_clock
+********************************************************************************
+* Summary:
+*  Called when CLK_PERI has changed with the PLL. The latency timer counts
+*  CLK_PERI cycles, so its frequency is read again; the load timer divider
+*  is recomputed to keep its period.
+*
+*******************************************************************************/
+void isr_latency_on_peri_clock(void)
+{
+    latency_timer_hz = cyhal_clock_get_frequency(&latency_clock);
+
+    if (latency_load_running)
+    {
+        cyhal_timer_set_frequency(&latency_load_timer, LATENCY_LOAD_TIMER_HZ);
+    }
+}
+
+/*******************************************************************************
+* Function Name: isr_latency_on_entry
+********************************************************************************
+* Summary:
+*  Called first thing in the handler of the TX complete event. The offset of
+*  the entry from its cadence slot, less the lowest offset, is the latency.
+*
+*******************************************************************************/
+void isr_latency_on_entry(void)
+{
+    uint32_t now = cyhal_timer_read(&latency_timer);
+    int32_t offset;
+    uint32_t latency;
+    uint32_t bucket;
+
+    /* Without a block period, the cadence is unknown */
+    if (!latency_enabled || (latency_period == 0u))
+    {
+        return;
+    }
+
+    latency_entries++;
+    if (latency_entries <= LATENCY_SKIP_ENTRIES)
+    {
+        latency_slot_time = now;
+        return;
+    }
+
+    latency_slot_time += latency_period;
+    offset = (int32_t) (now - latency_slot_time);
+
+    if ((latency_entries == (LATENCY_SKIP_ENTRIES + 1u)) || (offset < latency_baseline))
+    {
+        if (latency_entries > (LATENCY_SKIP_ENTRIES + LATENCY_BASELINE_ENTRIES))
+        {
+            latency_stats.rebaselines++;
+        }
+        latency_baseline = offset;
+    }
+
+    if (latency_entries <= (LATENCY_SKIP_ENTRIES + LATENCY_BASELINE_ENTRIES))
+    {
+        return;
+    }
+
+    latency = (uint32_t) (((uint64_t) (uint32_t) (offset - latency_baseline) * 1000000u) / latency_timer_hz);
+
+    bucket = 0;
+    while ((bucket < (ISR_LATENCY_BUCKETS - 1u)) && ((latency >> bucket) != 0u))
+    {
+        bucket++;
+    }
+
+    latency_stats.count++;
+    latency_stats.histogram[bucket]++;
+    if (latency > latency_stats.max_us)
+    {
+        latency_stats.max_us = latency;
+    }
+}
+
+/*******************************************************************************
+* Function Name: isr_latency_reset
+********************************************************************************
+* Summary:
+*  Clear the histogram.
+*
+*******************************************************************************/
+void isr_latency_reset(void)
+{
+    memset(&latency_stats, 0, sizeof(latency_stats));
+}
+
+/*******************************************************************************
+* Function Name: isr_latency_get_stats
+********************************************************************************
+* Summary:
+*  Get the latency histogram.
+*
+* Parameters:
+*  stats: filled with the statistics
+*
+*******************************************************************************/
+void isr_latency_get_stats(isr_latency_stats_t *stats)
+{
+    *stats = latency_stats;
+}
+
+/*******************************************************************************
+* Function Name: isr_latency_percentile_us
+********************************************************************************
+* Summary:
+*  Get a percentile of the latency, rounded up to its histogram bucket.
+*
+* Parameters:
+*  permille: percentile in 1/1000 (for example, 990 for the 99th)
+*
+* Return:
+*  uint32_t: upper bound of the bucket in us, the maximum for the last
+*            bucket, 0 if nothing was measured
+*
+*******************************************************************************/
+uint32_t isr_latency_percentile_us(uint32_t permille)
+{
+    uint64_t target = ((uint64_t) latency_stats.count * permille + 999u) / 1000u;
+    uint64_t sum = 0;
+
+    for (uint32_t b = 0; b < ISR_LATENCY_BUCKETS; b++)
+    {
+        sum += latency_stats.histogram[b];
+        if ((sum >= target) && (sum > 0u))
+        {
+            return (b < (ISR_LATENCY_BUCKETS - 1u)) ? ((1u << b) - 1u) : latency_stats.max_us;
+        }
+    }
+
+    return latency_stats.max_us;
+}
+
+/*******************************************************************************
+* Function Name: isr_latency_set_load
+********************************************************************************
+* Summary:
+*  Start or stop a competing interrupt load: a periodic interrupt that
+*  busy-waits, to size the FIFO and buffer margins under load.
+*
+* Parameters:
+*  period_us: interrupt period, 0 to stop the load
+*  busy_us: time spent in each interrupt, any 32-bit value
+*  priority: interrupt priority (0 is the highest)
+*
+* Return:
+*  cy_rslt_t: CY_RSLT_SUCCESS or the error of the timer HAL. The load is
+*             stopped after an error.
+*
+*******************************************************************************/
+cy_rslt_t isr_latency_set_load(uint32_t period_us, uint32_t busy_us, uint8_t priority)
+{
+    cyhal_timer_cfg_t config =
+    {
+        .is_continuous = true,
+        .direction     = CYHAL_TIMER_DIR_UP,
+        .is_compare    = false,
+        .period        = period_us - 1u,
+        .compare_value = 0,
+        .value         = 0,
+    };
+
+    cy_rslt_t result;
+
+    if (!latency_load_init)
+    {
+        result = cyhal_timer_init(&latency_load_timer, NC, NULL);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            latency_load_running = false;
+            return result;
+        }
+        cyhal_timer_register_callback(&latency_load_timer, latency_load_handler, NULL);
+        latency_load_init = true;
+    }
+
+    cyhal_timer_stop(&latency_load_timer);
+    latency_load_running = false;
+    if (period_us == 0u)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    latency_load_busy_us = busy_us;
+    result = cyhal_timer_configure(&latency_load_timer, &config);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_timer_set_frequency(&latency_load_timer, LATENCY_LOAD_TIMER_HZ);
+    }
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    cyhal_timer_enable_event(&latency_load_timer, CYHAL_TIMER_IRQ_TERMINAL_COUNT, priority, true);
+    cyhal_timer_reset(&latency_load_timer);
+    result = cyhal_timer_start(&latency_load_timer);
+    latency_load_running = (result == CY_RSLT_SUCCESS);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: latency_load_handler
+********************************************************************************
+* Summary:
+*  Competing load interrupt.
+*
+*******************************************************************************/
+static void latency_load_handler(void *arg, cyhal_timer_event_t event)
+{
+    uint32_t remaining = latency_load_busy_us;
+
+    (void) arg;
+    (void) event;
+
+    /* The HAL delay takes at most UINT16_MAX us */
+    while (remaining > 0u)
+    {
+        uint16_t delay = (remaining > UINT16_MAX) ? UINT16_MAX : (uint16_t) remaining;
+
+        cyhal_system_delay_us(delay);
+        remaining -= delay;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,73 @@
+/*****************************************************************************
+* File Name: isr_latency.h
+*
+* Description: This file contains the definitions of the latency measurement of
+*              the audio ISR.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ISR_LATENCY_H
+    #define ISR_LATENCY_H
+
+    #include <stdint.h>
+
+    #include "clock_plan.h"
+
+    /* Number of histogram buckets. Bucket 0 counts 0 us, bucket n the
+    *  latencies from 2^(n-1) to 2^n - 1 us, the last one everything longer. */
+    #define ISR_LATENCY_BUCKETS     16u
+
+    /* isr_latency_init() did not get a 32-bit counter */
+    #define ISR_LATENCY_RSLT_ERR_WIDTH  ((cy_rslt_t) 0x04020001u)
+
+    typedef struct
+    {
+        uint32_t count;             /* Measured ISR entries */
+        uint32_t max_us;
+        uint32_t rebaselines;       /* Times a faster entry moved the baseline */
+        uint32_t histogram[ISR_LATENCY_BUCKETS];
+    } isr_latency_stats_t;
+
+    cy_rslt_t isr_latency_init(void);
+    void isr_latency_start(uint32_t period_frames, const clock_plan_t *plan);
+    void isr_latency_on_peri_clock(void);
+    void isr_latency_on_entry(void);
+    void isr_latency_reset(void);
+    void isr_latency_get_stats(isr_latency_stats_t *stats);
+    uint32_t isr_latency_percentile_us(uint32_t permille);
+    cy_rslt_t isr_latency_set_load(uint32_t period_us, uint32_t busy_us, uint8_t priority);
+
+#endif
+
+/* [] END OF FILE */
@@ -44,34 +44,43 @@
 #include "cybsp.h"
 
 #include "wave.h"
+#include "button.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "audio_format.h"
+#include "audio_clip.h"
+#include "audio_pipeline.h"
+#include "audio_rate.h"
+#include "audio_sleep.h"
+#include "clock_plan.h"
+#include "codec.h"
+#include "cpu_governor.h"
+#include "cycle_counter.h"
+#include "profile.h"
+#include "isr_latency.h"
+#include "trace.h"
 
-#ifdef USE_AK4954A
-    #include "mtb_ak4954a.h"
-#endif
 
 /*******************************************************************************
 * Macros
 ********************************************************************************/
-/* Master I2C Settings */
-#define MI2C_TIMEOUT_MS     10u         /* in ms */
-/* Note that we are not able to achieve the desired frequency, so we round up
-*  the frequency values to avoid mismatches */
+/* Initial audio sample rate. The PLL, HFCLK1 divider and MCLK frequency come
+*  from the clock plan of this rate, see clock_plan.c. The rate follows the
+*  clip being played, see audio_rate.c */
+#define AUDIO_SAMPLE_RATE_HZ 16000u     /* in Hz */
 /* Master Clock (MCLK) Settings */
-#define MCLK_FREQ_HZ        4083000u    /* in Hz (Ideally 4.096 MHz) */
 #define MCLK_DUTY_CYCLE     50.0f       /* in %  */
-/* Clock Settings */
-#define AUDIO_SYS_CLOCK_HZ  98000000u   /* in Hz (Ideally 98.304 MHz) */
 /* PWM MCLK Pin */
 #define MCLK_PIN            P5_0
-/* Debounce delay for the button */
-#define DEBOUNCE_DELAY_MS   10u         /* in ms */
-/* HFCLK1 Clock Divider */
-#define HFCLK1_CLK_DIVIDER  4u
 
 /*******************************************************************************
 * Function Prototypes
 ********************************************************************************/
 void i2s_isr_handler(void *arg, cyhal_i2s_event_t event);
+void button_handler(const scheduler_event_t *event);
+void playback_start_handler(const scheduler_event_t *event);
+void playback_on_codec_ready(bool success);
+void playback_done_handler(const scheduler_event_t *event);
 void clock_init(void);
 
 /*******************************************************************************
@@ -79,23 +88,36 @@ void clock_init(void);
 ********************************************************************************/
 /* HAL Objects */
 cyhal_pwm_t mclk_pwm;
-#ifdef USE_AK4954A
-cyhal_i2c_t mi2c;
-#endif
 cyhal_i2s_t i2s;
 cyhal_clock_t audio_clock;
 cyhal_clock_t pll_clock;
 cyhal_clock_t fll_clock;
 cyhal_clock_t system_clock;
+cyhal_clock_t fast_clock;
+
+/* Clock plan of the audio sample rate */
+const clock_plan_t *audio_plan;
+
+/* Voice that plays the sound track */
+audio_clip_voice_t wave_voice;
+
+/* Steps of a playback start. The codec completes each one in the
+*  background; the next one runs from SCHEDULER_EVENT_PLAYBACK_START */
+typedef enum
+{
+    PLAYBACK_STEP_IDLE,
+    PLAYBACK_STEP_POWER_UP,     /* Codec output powering up */
+    PLAYBACK_STEP_RATE,         /* Sample rate switching */
+} playback_step_t;
+
+playback_step_t playback_step;
+/* Timebase time of the button press being served */
+uint32_t playback_press_time;
+
+/* Time from the button press to the start of the last clip, in us */
+uint32_t press_to_play_us;
 
 /* HAL Configs */
-#ifdef USE_AK4954A
-const cyhal_i2c_cfg_t mi2c_config = {
-    .is_slave        = false,
-    .address         = 0,
-    .frequencyhal_hz = 400000
-};
-#endif
 const cyhal_i2s_pins_t i2s_pins = {
     .sck  = P5_1,
     .ws   = P5_2,
@@ -106,9 +128,9 @@ const cyhal_i2s_config_t i2s_config = {
     .is_tx_slave    = false,    /* TX is Master */
     .is_rx_slave    = false,    /* RX not used */
     .mclk_hz        = 0,        /* External MCLK not used */
-    .channel_length = 32,       /* In bits */
-    .word_length    = 16,       /* In bits */
-    .sample_rate_hz = 16000,    /* In Hz */
+    .channel_length = AUDIO_CHANNEL_LENGTH, /* In bits */
+    .word_length    = AUDIO_WORD_LENGTH,    /* In bits */
+    .sample_rate_hz = AUDIO_SAMPLE_RATE_HZ, /* In Hz */
 };
 
 /*******************************************************************************
@@ -118,9 +140,10 @@ const cyhal_i2s_config_t i2s_config = {
 *  The main function for the Cortex-M4 CPU does the following:
 *   Initialization:
 *   - Initializes all the hardware blocks
-*   Do forever loop:
-*   - Enters Sleep Mode.
-*   - Check if the User Button was pressed. If yes, plays the audio track.
+*   Scheduler loop:
+*   - Runs the handler of each event posted by the ISRs.
+*   - Enters the idle mode (Deep Sleep between clips) when no event is
+*     waiting.
 *
 * Parameters:
 *  void
@@ -140,6 +163,11 @@ int main(void)
         CY_ASSERT(0);
     }
 
+    /* Clear the event trace before any ISR logs to it, and start the
+    *  low-power timebase that stamps its records */
+    trace_init();
+    timebase_init();
+
     /* Enable global interrupts */
     __enable_irq();
 
@@ -149,14 +177,21 @@ int main(void)
     /* Initialize the User LED */
     cyhal_gpio_init(CYBSP_USER_LED, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
 
-    /* Initialize the User Button */
-    cyhal_gpio_init(CYBSP_USER_BTN, CYHAL_GPIO_DIR_INPUT, CYHAL_GPIO_DRIVE_PULLUP, CYBSP_BTN_OFF);
-    /* Enable the button interrupt to wake-up the CPU */
-    cyhal_gpio_enable_event(CYBSP_USER_BTN, CYHAL_GPIO_IRQ_FALL, CYHAL_ISR_PRIORITY_DEFAULT, true);
+    /* Initialize the event scheduler and its handlers */
+    scheduler_init();
+    scheduler_register(SCHEDULER_EVENT_BUTTON, button_handler);
+    scheduler_register(SCHEDULER_EVENT_PLAYBACK_START, playback_start_handler);
+    scheduler_register(SCHEDULER_EVENT_PLAYBACK_DONE, playback_done_handler);
+    scheduler_register(SCHEDULER_EVENT_CPU_LEVEL, cpu_governor_handler);
+    scheduler_register(SCHEDULER_EVENT_RATE_SWITCH, audio_rate_handler);
+
+    /* Initialize the User Button, debounced in the background with the
+    *  timebase */
+    button_init(CYBSP_USER_BTN);
 
     /* Initialize the Master Clock with a PWM */
     cyhal_pwm_init(&mclk_pwm, MCLK_PIN, NULL);
-    cyhal_pwm_set_duty_cycle(&mclk_pwm, MCLK_DUTY_CYCLE, MCLK_FREQ_HZ);
+    cyhal_pwm_set_duty_cycle(&mclk_pwm, MCLK_DUTY_CYCLE, audio_plan->mclk_hz);
     cyhal_pwm_start(&mclk_pwm);
 
     /* Wait for the MCLK to clock the audio codec */
@@ -166,57 +201,161 @@ int main(void)
     cyhal_i2s_init(&i2s, &i2s_pins, NULL, &i2s_config, &audio_clock);
     cyhal_i2s_register_callback(&i2s, i2s_isr_handler, NULL);
     cyhal_i2s_enable_event(&i2s, CYHAL_I2S_ASYNC_TX_COMPLETE, CYHAL_ISR_PRIORITY_DEFAULT, true);
-    
-#ifdef USE_AK4954A
-    /* Initialize the I2C Master */
-    cyhal_i2c_init(&mi2c, CYBSP_I2C_SDA, CYBSP_I2C_SCL, NULL);
-    cyhal_i2c_configure(&mi2c, &mi2c_config);
-
-    /* Configure the AK494A codec and enable it */
-    result = mtb_ak4954a_init(&mi2c);
-    /* If the initialization fails, reset the device */
-    if (result != 0)
+
+    /* Initialize the audio pipeline and the latency measurement of its ISR */
+    audio_pipeline_init(&i2s);
+    result = isr_latency_init();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Configure the codec and enable it. If the initialization fails, reset
+    *  the device */
+    result = codec_init();
+    if (result != CY_RSLT_SUCCESS)
     {
         NVIC_SystemReset();
     }
-    mtb_ak4954a_activate();
-    mtb_ak4954a_adjust_volume(AK4954A_HP_VOLUME_DEFAULT);
-#endif
 
-    for(;;)
+    /* Allow the sample rate to be switched between clips */
+    audio_rate_init(&i2s, &mclk_pwm, &pll_clock, &audio_clock, AUDIO_SAMPLE_RATE_HZ);
+
+    /* Power the audio subsystem down between clips */
+    audio_sleep_init(&mclk_pwm, &pll_clock);
+
+    /* Dispatch the events, idle when there are none */
+    scheduler_run(audio_sleep_idle);
+}
+
+/*******************************************************************************
+* Function Name: button_handler
+********************************************************************************
+* Summary:
+*  Button event handler. A press plays the audio track, if not already
+*  playing or starting: the codec output is powered up in the background,
+*  and playback_start_handler() continues once it has settled.
+*
+* Parameters:
+*  event: button event, the argument is a button_event_type_t
+*
+*******************************************************************************/
+void button_handler(const scheduler_event_t *event)
+{
+    if ((event->arg != BUTTON_EVENT_PRESS) || (playback_step != PLAYBACK_STEP_IDLE) || audio_pipeline_is_active())
+    {
+        return;
+    }
+
+    playback_step       = PLAYBACK_STEP_POWER_UP;
+    playback_press_time = event->timestamp;
+    audio_sleep_resume(playback_on_codec_ready);
+}
+
+/*******************************************************************************
+* Function Name: playback_start_handler
+********************************************************************************
+* Summary:
+*  Playback start event handler, run each time the codec has completed a
+*  step. Once powered, the codec is switched to the rate of the sound track;
+*  then the track is queued and the pipeline started.
+*
+* Parameters:
+*  event: not used
+*
+*******************************************************************************/
+void playback_start_handler(const scheduler_event_t *event)
+{
+    const clock_plan_t *plan;
+
+    (void) event;
+
+    if (playback_step == PLAYBACK_STEP_POWER_UP)
     {
-        cyhal_syspm_sleep();
-        /* Check if the button was pressed */
-        if (cyhal_gpio_read(CYBSP_USER_BTN) == CYBSP_BTN_PRESSED)
+        /* A rate without a clock plan or not supported by the codec is left
+        *  out: the track plays at the current rate */
+        playback_step = PLAYBACK_STEP_RATE;
+        if (audio_rate_set(wave_clip.sample_rate_hz, playback_on_codec_ready))
         {
-            /* Check if I2S is transmitting */
-            if (cyhal_i2s_is_write_pending(&i2s))
-            {
-                /* If already transmitting, don't do anything */
-            }
-            else
-            {
-                /* Start the I2S TX */
-                cyhal_i2s_start_tx(&i2s);
-
-                /* If not transmitting, initiate a transfer */
-                cyhal_i2s_write_async(&i2s, wave_data, WAVE_SIZE);
-
-                /* Turn ON LED to show a transmission */
-                cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_ON);
-            }
-
-            /* Debounce delay */
-            cyhal_system_delay_ms(DEBOUNCE_DELAY_MS);
+            return;
         }
     }
+
+    if (playback_step != PLAYBACK_STEP_RATE)
+    {
+        return;
+    }
+    playback_step = PLAYBACK_STEP_IDLE;
+
+    codec_mute(false);
+    /* The rate set at startup may have no clock plan: the cadence of the
+    *  blocks is then unknown and the latency is not measured */
+    plan = clock_plan_get(audio_rate_get());
+    if (plan != NULL)
+    {
+        isr_latency_start(AUDIO_BLOCK_FRAMES, plan);
+    }
+    audio_clip_voice_init(&wave_voice, &wave_clip);
+    audio_mixer_add(&wave_voice.voice);
+    audio_pipeline_start();
+
+    audio_sleep_on_play();
+    press_to_play_us = timebase_ticks_to_us(timebase_now() - playback_press_time);
+
+    /* Turn ON LED to show a transmission */
+    cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_ON);
+}
+
+/*******************************************************************************
+* Function Name: playback_on_codec_ready
+********************************************************************************
+* Summary:
+*  Completion of a codec step of the playback start, called from an ISR or
+*  at once by a codec without control interface. If the step failed or the
+*  event cannot be posted, the press is dropped with the DAC muted, and the
+*  codec idle timeout restarts.
+*
+* Parameters:
+*  success: false if the codec step failed
+*
+*******************************************************************************/
+void playback_on_codec_ready(bool success)
+{
+    if (!success || !scheduler_post(SCHEDULER_EVENT_PLAYBACK_START, 0u, timebase_now()))
+    {
+        playback_step = PLAYBACK_STEP_IDLE;
+        audio_sleep_on_stop();
+    }
+}
+
+/*******************************************************************************
+* Function Name: playback_done_handler
+********************************************************************************
+* Summary:
+*  Playback done event handler. Turns OFF the User LED and starts the codec
+*  idle timeout.
+*
+* Parameters:
+*  event: not used
+*
+*******************************************************************************/
+void playback_done_handler(const scheduler_event_t *event)
+{
+    (void) event;
+
+    /* Turn off the LED */
+    cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_OFF);
+
+    audio_sleep_on_stop();
 }
 
 /*******************************************************************************
 * Function Name: i2s_isr_handler
 ********************************************************************************
 * Summary:
-*  I2S ISR handler. Stop the I2S TX and turn OFF the User LED.
+*  I2S ISR handler. Queue the next block of the pipeline. When there is
+*  nothing left to play, stop the I2S TX and notify the main loop. TX FIFO
+*  errors are reported to the glitch telemetry.
 *
 * Parameters:
 *  arg: not used
@@ -225,42 +364,78 @@ int main(void)
 *******************************************************************************/
 void i2s_isr_handler(void *arg, cyhal_i2s_event_t event)
 {
+    PROFILE_BEGIN(PROFILE_I2S_ISR);
+
     (void) arg;
-    (void) event;
 
-    /* Stop the I2S TX */
-    cyhal_i2s_stop_tx(&i2s);
+    if ((event & CYHAL_I2S_ASYNC_TX_COMPLETE) != 0u)
+    {
+        isr_latency_on_entry();
+    }
 
-    /* Turn off the LED */
-    cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_OFF);
+    /* Count the TX FIFO underflows and overflows */
+    if ((event & (CYHAL_I2S_TX_UNDERFLOW | CYHAL_I2S_TX_OVERFLOW)) != 0u)
+    {
+        audio_pipeline_on_fifo_event(event);
+    }
+
+    if (((event & CYHAL_I2S_ASYNC_TX_COMPLETE) != 0u) && !audio_pipeline_on_tx_complete())
+    {
+        /* Stop the I2S TX */
+        cyhal_i2s_stop_tx(&i2s);
+        /* Mute the DAC in the background, the ISR does not wait for the I2C */
+        codec_mute(true);
+
+        scheduler_post(SCHEDULER_EVENT_PLAYBACK_DONE, 0u, timebase_now());
+    }
+
+    PROFILE_END(PROFILE_I2S_ISR);
 }
 
 /*******************************************************************************
 * Function Name: clock_init
 ********************************************************************************
 * Summary:
-*  Initialize the clocks in the system.
+*  Initialize the clocks in the system from the clock plan of the audio
+*  sample rate.
 *
 *******************************************************************************/
 void clock_init(void)
 {
-    /* Initialize the PLL */
+    /* Solve the clock plans of the supported sample rates */
+    clock_plan_init();
+    audio_plan = clock_plan_get(AUDIO_SAMPLE_RATE_HZ);
+    if (audio_plan == NULL)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Initialize the PLL with the dividers of the plan */
     cyhal_clock_reserve(&pll_clock, &CYHAL_CLOCK_PLL[0]);
-    cyhal_clock_set_frequency(&pll_clock, AUDIO_SYS_CLOCK_HZ, NULL);
-    cyhal_clock_set_enabled(&pll_clock, true, true);
+    if (!clock_plan_set_pll(audio_plan))
+    {
+        CY_ASSERT(0);
+    }
 
     /* Initialize the audio subsystem clock (HFCLK1) */
     cyhal_clock_reserve(&audio_clock, &CYHAL_CLOCK_HF[1]);
     cyhal_clock_set_source(&audio_clock, &pll_clock);
 
     /* Drop HFCK1 frequency for power savings */
-    cyhal_clock_set_divider(&audio_clock, HFCLK1_CLK_DIVIDER);
+    cyhal_clock_set_divider(&audio_clock, audio_plan->hfclk1_div);
     cyhal_clock_set_enabled(&audio_clock, true, true);
 
     /* Initialize the system clock (HFCLK0) */
     cyhal_clock_reserve(&system_clock, &CYHAL_CLOCK_HF[0]);
     cyhal_clock_set_source(&system_clock, &pll_clock);
 
+    /* Scale the CPU clock (CLK_FAST) with the audio load. The peripheral
+    *  clock and the MCLK are not affected */
+    cyhal_clock_reserve(&fast_clock, &CYHAL_CLOCK_FAST);
+    cycle_counter_init();
+    profile_reset();
+    cpu_governor_init(&fast_clock);
+
     /* Disable the FLL for power savings */
     cyhal_clock_reserve(&fll_clock, &CYHAL_CLOCK_FLL);
     cyhal_clock_set_enabled(&fll_clock, false, true);
@@ -0,0 +1,82 @@
+/*****************************************************************************
+* File Name: power_model.h
+*
+* Description: This file contains the power model used to estimate the energy
+*              spent playing audio.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef POWER_MODEL_H
+    #define POWER_MODEL_H
+
+    #include <stdint.h>
+
+    /* Typical figures of a PSoC 6 CM4 in LP mode; adjust them for the board.
+    *  The current is a base current plus a part proportional to the CPU
+    *  clock, both in Active and in Sleep mode. */
+    #define POWER_MODEL_SUPPLY_MV           3300u   /* in mV */
+    #define POWER_MODEL_ACTIVE_BASE_UA      900u    /* in uA */
+    #define POWER_MODEL_ACTIVE_UA_PER_MHZ   40u     /* in uA/MHz */
+    #define POWER_MODEL_SLEEP_BASE_UA       600u    /* in uA */
+    #define POWER_MODEL_SLEEP_UA_PER_MHZ    10u     /* in uA/MHz */
+
+    /***************************************************************************
+    * Function Name: power_model_energy_nj
+    ****************************************************************************
+    * Summary:
+    *  Estimate the energy of a time interval split between Active and Sleep
+    *  mode at a given CPU clock.
+    *
+    * Parameters:
+    *  active_us: time spent running
+    *  sleep_us: time spent in Sleep mode
+    *  cpu_hz: CPU clock
+    *
+    * Return:
+    *  uint64_t: energy in nJ
+    *
+    ***************************************************************************/
+    static inline uint64_t power_model_energy_nj(uint64_t active_us, uint64_t sleep_us, uint32_t cpu_hz)
+    {
+        uint64_t cpu_mhz = cpu_hz / 1000000u;
+        uint64_t active_ua = POWER_MODEL_ACTIVE_BASE_UA + (POWER_MODEL_ACTIVE_UA_PER_MHZ * cpu_mhz);
+        uint64_t sleep_ua = POWER_MODEL_SLEEP_BASE_UA + (POWER_MODEL_SLEEP_UA_PER_MHZ * cpu_mhz);
+
+        /* mV * uA * us = 1e-15 J */
+        return (POWER_MODEL_SUPPLY_MV * ((active_ua * active_us) + (sleep_ua * sleep_us))) / 1000000u;
+    }
+
+#endif
+
+/* [] END OF FILE */
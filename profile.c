@@ -0,0 +1,189 @@
+/*****************************************************************************
+* File Name: profile.c
+*
+* Description: This file contains the hot path profiler. Each probe keeps the
+*              count, minimum, maximum and total of its durations in cycles
+*              and a histogram with power of 2 buckets.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "profile.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Length of a dump line */
+#define PROFILE_LINE_LENGTH     96u
+
+#ifdef HOST_BUILD
+    #define PROFILE_CLZ(x)      ((uint32_t) __builtin_clz(x))
+#else
+    #define PROFILE_CLZ(x)      __CLZ(x)
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Probes, also readable with the debugger */
+profile_probe_t profile_probes[PROFILE_ID_COUNT];
+
+static const char *const profile_names[PROFILE_ID_COUNT] =
+{
+    "i2s_isr",
+    "render",
+    "mix",
+    "pack",
+};
+
+/*******************************************************************************
+* Function Name: profile_reset
+********************************************************************************
+* Summary:
+*  Clear all the probes.
+*
+*******************************************************************************/
+void profile_reset(void)
+{
+    memset(profile_probes, 0, sizeof(profile_probes));
+
+    for (uint32_t i = 0; i < PROFILE_ID_COUNT; i++)
+    {
+        profile_probes[i].min = UINT32_MAX;
+    }
+}
+
+/*******************************************************************************
+* Function Name: profile_record
+********************************************************************************
+* Summary:
+*  Account one duration of a probe.
+*
+* Parameters:
+*  id: probe ID
+*  cycles: duration in cycles
+*
+*******************************************************************************/
+void profile_record(profile_id_t id, uint32_t cycles)
+{
+    profile_probe_t *probe = &profile_probes[id];
+    uint32_t bucket = (cycles == 0u) ? 0u : (32u - PROFILE_CLZ(cycles));
+
+    if (bucket >= PROFILE_BUCKETS)
+    {
+        bucket = PROFILE_BUCKETS - 1u;
+    }
+
+    probe->count++;
+    probe->total += cycles;
+    probe->histogram[bucket]++;
+    if (cycles < probe->min)
+    {
+        probe->min = cycles;
+    }
+    if (cycles > probe->max)
+    {
+        probe->max = cycles;
+    }
+}
+
+/*******************************************************************************
+* Function Name: profile_get
+********************************************************************************
+* Summary:
+*  Get a copy of a probe.
+*
+* Parameters:
+*  id: probe ID
+*  probe: filled with the probe
+*
+*******************************************************************************/
+void profile_get(profile_id_t id, profile_probe_t *probe)
+{
+    *probe = profile_probes[id];
+}
+
+/*******************************************************************************
+* Function Name: profile_dump
+********************************************************************************
+* Summary:
+*  Format the probes that ran: one line with the count and the minimum, mean
+*  and maximum cycles, then one line per non-empty histogram bucket.
+*
+* Parameters:
+*  write: function receiving the lines
+*
+*******************************************************************************/
+void profile_dump(profile_write_t write)
+{
+    char line[PROFILE_LINE_LENGTH];
+    profile_probe_t probe;
+
+    for (uint32_t i = 0; i < PROFILE_ID_COUNT; i++)
+    {
+        profile_get((profile_id_t) i, &probe);
+        if (probe.count == 0u)
+        {
+            continue;
+        }
+
+        snprintf(line, sizeof(line), "%-12s count %lu min %lu mean %lu max %lu",
+                 profile_names[i], (unsigned long) probe.count, (unsigned long) probe.min,
+                 (unsigned long) (probe.total / probe.count), (unsigned long) probe.max);
+        write(line);
+
+        for (uint32_t b = 0; b < PROFILE_BUCKETS; b++)
+        {
+            if (probe.histogram[b] == 0u)
+            {
+                continue;
+            }
+            if (b < (PROFILE_BUCKETS - 1u))
+            {
+                snprintf(line, sizeof(line), "  <  2^%-2lu %lu", (unsigned long) b,
+                         (unsigned long) probe.histogram[b]);
+            }
+            else
+            {
+                snprintf(line, sizeof(line), "  >= 2^%-2lu %lu", (unsigned long) (b - 1u),
+                         (unsigned long) probe.histogram[b]);
+            }
+            write(line);
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,97 @@
+/*****************************************************************************
+* File Name: profile.h
+*
+* Description: This file contains the definitions of the hot path profiler.
+*              Probes are compiled out unless PROFILE_ENABLE is 1.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PROFILE_H
+    #define PROFILE_H
+
+    #include <stdint.h>
+
+    #include "cycle_counter.h"
+
+    /* Set it from the Makefile with DEFINES+=PROFILE_ENABLE=1 */
+    #ifndef PROFILE_ENABLE
+        #define PROFILE_ENABLE      0
+    #endif
+
+    /* Number of histogram buckets. Bucket n counts the durations from 2^(n-1)
+    *  to 2^n - 1 cycles, the last one everything longer. */
+    #define PROFILE_BUCKETS         20u
+
+    /* Probe IDs. Each probe must be recorded from a single context. */
+    typedef enum
+    {
+        PROFILE_I2S_ISR,            /* I2S TX complete ISR */
+        PROFILE_RENDER,             /* Block render, mix and pack */
+        PROFILE_MIX,                /* Mixer */
+        PROFILE_PACK,               /* Conversion to the output word length */
+        PROFILE_ID_COUNT,
+    } profile_id_t;
+
+    typedef struct
+    {
+        uint32_t count;
+        uint32_t min;
+        uint32_t max;
+        uint64_t total;
+        uint32_t histogram[PROFILE_BUCKETS];
+    } profile_probe_t;
+
+    /* Receives the dump, one line at a time without the line end */
+    typedef void (*profile_write_t)(const char *line);
+
+    #if (PROFILE_ENABLE != 0)
+        /* Start a probe. Must be paired with PROFILE_END() in the same block. */
+        #define PROFILE_BEGIN(id)   uint32_t profile_start_##id = cycle_counter_read()
+        #define PROFILE_END(id)     profile_record((id), cycle_counter_read() - profile_start_##id)
+        /* Record a duration measured by the caller */
+        #define PROFILE_RECORD(id, cycles)  profile_record((id), (cycles))
+    #else
+        #define PROFILE_BEGIN(id)
+        #define PROFILE_END(id)
+        #define PROFILE_RECORD(id, cycles)
+    #endif
+
+    void profile_reset(void);
+    void profile_record(profile_id_t id, uint32_t cycles);
+    void profile_get(profile_id_t id, profile_probe_t *probe);
+    void profile_dump(profile_write_t write);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,322 @@
+/*****************************************************************************
+* File Name: scheduler.c
+*
+* Description: This file contains the run-to-completion event scheduler. ISRs
+*              post events to a lock-free queue and the main loop dispatches
+*              them to one handler per event type, in order, then sleeps once
+*              the queue is empty.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "cyhal.h"
+
+#include "scheduler.h"
+#include "cycle_counter.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool scheduler_dispatch(void);
+static bool scheduler_is_empty(void);
+static void scheduler_count(volatile uint32_t *counter);
+static void scheduler_raise(volatile uint32_t *value, uint32_t candidate);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Queue slot. The sequence tells the state of the slot: equal to the write
+*  index it is free, one more it holds an event for the reader. */
+typedef struct
+{
+    volatile uint32_t sequence;
+    scheduler_event_t event;
+} scheduler_slot_t;
+
+static scheduler_slot_t scheduler_queue[SCHEDULER_QUEUE_SIZE];
+/* Next slot to claim, shared by the producers */
+static volatile uint32_t scheduler_write;
+/* Next slot to dispatch, owned by the main loop */
+static uint32_t scheduler_read;
+
+static scheduler_handler_t scheduler_handlers[SCHEDULER_EVENT_COUNT];
+static scheduler_stats_t scheduler_stats;
+
+/*******************************************************************************
+* Function Name: scheduler_init
+********************************************************************************
+* Summary:
+*  Empty the queue and clear the handlers and the statistics.
+*
+*******************************************************************************/
+void scheduler_init(void)
+{
+    for (uint32_t i = 0; i < SCHEDULER_QUEUE_SIZE; i++)
+    {
+        scheduler_queue[i].sequence = i;
+    }
+    scheduler_write = 0;
+    scheduler_read  = 0;
+
+    for (uint32_t i = 0; i < SCHEDULER_EVENT_COUNT; i++)
+    {
+        scheduler_handlers[i] = NULL;
+    }
+
+    memset(&scheduler_stats, 0, sizeof(scheduler_stats));
+}
+
+/*******************************************************************************
+* Function Name: scheduler_register
+********************************************************************************
+* Summary:
+*  Set the handler of an event type. Events without a handler are dropped
+*  when dispatched.
+*
+* Parameters:
+*  type: event type
+*  handler: function called for each event of this type
+*
+*******************************************************************************/
+void scheduler_register(scheduler_event_type_t type, scheduler_handler_t handler)
+{
+    scheduler_handlers[type] = handler;
+}
+
+/*******************************************************************************
+* Function Name: scheduler_post
+********************************************************************************
+* Summary:
+*  Queue an event. Safe from any ISR priority and from the main loop: the
+*  slot is claimed with an exclusive access, so a preempting producer only
+*  makes the claim retry. The statistics are updated the same way.
+*
+* Parameters:
+*  type: event type
+*  arg: event argument
+*  timestamp: time of the event, in timebase ticks
+*
+* Return:
+*  bool: false if the queue is full and the event was dropped
+*
+*******************************************************************************/
+bool scheduler_post(scheduler_event_type_t type, uint32_t arg, uint32_t timestamp)
+{
+    scheduler_slot_t *slot;
+    uint32_t write;
+    uint32_t depth;
+
+    do
+    {
+        write = __LDREXW(&scheduler_write);
+        slot = &scheduler_queue[write & (SCHEDULER_QUEUE_SIZE - 1u)];
+        if (slot->sequence != write)
+        {
+            /* The slot still holds an event from the previous lap */
+            __CLREX();
+            scheduler_count(&scheduler_stats.dropped);
+            return false;
+        }
+    } while (__STREXW(write + 1u, &scheduler_write) != 0u);
+
+    slot->event.type      = type;
+    slot->event.arg       = arg;
+    slot->event.timestamp = timestamp;
+
+    /* Publish the event only once it is in the slot */
+    __DMB();
+    slot->sequence = write + 1u;
+
+    scheduler_count(&scheduler_stats.posted);
+    depth = write + 1u - scheduler_read;
+    scheduler_raise(&scheduler_stats.max_depth, depth);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: scheduler_run
+********************************************************************************
+* Summary:
+*  Dispatch the events forever. The queue is checked for emptiness with the
+*  interrupts disabled, so an event posted just before the idle function is
+*  called still wakes-up the CPU. This function does not return.
+*
+* Parameters:
+*  idle: function that waits for the next interrupt
+*
+*******************************************************************************/
+void scheduler_run(scheduler_idle_t idle)
+{
+    uint32_t interrupt_state;
+
+    for(;;)
+    {
+        while (scheduler_dispatch())
+        {
+        }
+
+        interrupt_state = cyhal_system_critical_section_enter();
+        if (scheduler_is_empty())
+        {
+            idle();
+        }
+        cyhal_system_critical_section_exit(interrupt_state);
+    }
+}
+
+/*******************************************************************************
+* Function Name: scheduler_get_stats
+********************************************************************************
+* Summary:
+*  Get the queue and handler statistics.
+*
+* Parameters:
+*  stats: filled with the statistics
+*
+*******************************************************************************/
+void scheduler_get_stats(scheduler_stats_t *stats)
+{
+    *stats = scheduler_stats;
+}
+
+/*******************************************************************************
+* Function Name: scheduler_dispatch
+********************************************************************************
+* Summary:
+*  Run the handler of the oldest event.
+*
+* Return:
+*  bool: false if there was no event ready
+*
+*******************************************************************************/
+static bool scheduler_dispatch(void)
+{
+    scheduler_slot_t *slot = &scheduler_queue[scheduler_read & (SCHEDULER_QUEUE_SIZE - 1u)];
+    scheduler_handler_stats_t *stats;
+    scheduler_event_t event;
+    uint32_t start;
+    uint32_t cycles;
+
+    if (slot->sequence != (scheduler_read + 1u))
+    {
+        return false;
+    }
+
+    event = slot->event;
+
+    /* Free the slot only once the event has been copied */
+    __DMB();
+    slot->sequence = scheduler_read + SCHEDULER_QUEUE_SIZE;
+    scheduler_read++;
+
+    if ((event.type >= SCHEDULER_EVENT_COUNT) || (scheduler_handlers[event.type] == NULL))
+    {
+        return true;
+    }
+
+    start = cycle_counter_read();
+    scheduler_handlers[event.type](&event);
+    cycles = cycle_counter_read() - start;
+
+    stats = &scheduler_stats.handlers[event.type];
+    stats->count++;
+    stats->total_cycles += cycles;
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: scheduler_is_empty
+********************************************************************************
+* Summary:
+*  Check if no event is ready or being posted.
+*
+*******************************************************************************/
+static bool scheduler_is_empty(void)
+{
+    return (scheduler_write == scheduler_read);
+}
+
+/*******************************************************************************
+* Function Name: scheduler_count
+********************************************************************************
+* Summary:
+*  Increment a statistics counter with an exclusive access, so producers
+*  preempting each other do not lose counts.
+*
+* Parameters:
+*  counter: counter to increment
+*
+*******************************************************************************/
+static void scheduler_count(volatile uint32_t *counter)
+{
+    uint32_t count;
+
+    do
+    {
+        count = __LDREXW(counter);
+    } while (__STREXW(count + 1u, counter) != 0u);
+}
+
+/*******************************************************************************
+* Function Name: scheduler_raise
+********************************************************************************
+* Summary:
+*  Raise a statistics maximum to a new value with an exclusive access, so a
+*  preempting producer cannot have its higher value overwritten.
+*
+* Parameters:
+*  value: maximum to update
+*  candidate: new value, kept if higher
+*
+*******************************************************************************/
+static void scheduler_raise(volatile uint32_t *value, uint32_t candidate)
+{
+    do
+    {
+        if (__LDREXW(value) >= candidate)
+        {
+            __CLREX();
+            return;
+        }
+    } while (__STREXW(candidate, value) != 0u);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/*****************************************************************************
+* File Name: scheduler.h
+*
+* Description: This file contains the definitions of the run-to-completion event
+*              scheduler of the main loop.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SCHEDULER_H
+    #define SCHEDULER_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    /* Number of events the queue holds, a power of 2 */
+    #define SCHEDULER_QUEUE_SIZE    16u
+
+    /* Event types */
+    typedef enum
+    {
+        SCHEDULER_EVENT_BUTTON,         /* arg: button_event_type_t */
+        SCHEDULER_EVENT_PLAYBACK_START, /* The codec completed a start step */
+        SCHEDULER_EVENT_PLAYBACK_DONE,  /* The pipeline ran out of voices */
+        SCHEDULER_EVENT_CPU_LEVEL,      /* arg: CPU clock level requested */
+        SCHEDULER_EVENT_RATE_SWITCH,    /* arg: new sample rate, DAC muted */
+        SCHEDULER_EVENT_COUNT,
+    } scheduler_event_type_t;
+
+    typedef struct
+    {
+        scheduler_event_type_t type;
+        uint32_t arg;
+        uint32_t timestamp;             /* Timebase ticks */
+    } scheduler_event_t;
+
+    /* Runs in the main loop until it returns; it must not block */
+    typedef void (*scheduler_handler_t)(const scheduler_event_t *event);
+    /* Waits for the next interrupt */
+    typedef void (*scheduler_idle_t)(void);
+
+    /* Handler statistics, in CPU cycles */
+    typedef struct
+    {
+        uint32_t count;
+        uint32_t max_cycles;
+        uint64_t total_cycles;
+    } scheduler_handler_stats_t;
+
+    typedef struct
+    {
+        uint32_t posted;
+        uint32_t dropped;               /* Events lost on a full queue */
+        uint32_t max_depth;             /* Highest number of waiting events */
+        scheduler_handler_stats_t handlers[SCHEDULER_EVENT_COUNT];
+    } scheduler_stats_t;
+
+    void scheduler_init(void);
+    void scheduler_register(scheduler_event_type_t type, scheduler_handler_t handler);
+    bool scheduler_post(scheduler_event_type_t type, uint32_t arg, uint32_t timestamp);
+    void scheduler_run(scheduler_idle_t idle);
+    void scheduler_get_stats(scheduler_stats_t *stats);
+
+#endif
+
+/* [] END OF FILE */
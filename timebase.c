@@ -0,0 +1,293 @@
+/*****************************************************************************
+* File Name: timebase.c
+*
+* Description: This file contains the low-power timebase. The low-power timer
+*              (LPTIMER) is a free-running counter on the LF clock: it gives
+*              timestamps that stay valid across Deep Sleep and alarms that
+*              wake-up the CPU.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cyhal.h"
+
+#include "timebase.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void timebase_handler(void *arg, cyhal_lptimer_event_t event);
+static void timebase_unlink(timebase_alarm_t *alarm);
+static void timebase_program(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_lptimer_t timebase_timer;
+static uint32_t timebase_hz;
+/* Shortest delay the timer can be programmed with */
+static uint32_t timebase_min_delay;
+/* Armed alarms, in no particular order */
+static timebase_alarm_t *timebase_alarms;
+
+/*******************************************************************************
+* Function Name: timebase_init
+********************************************************************************
+* Summary:
+*  Initialize and start the low-power timer.
+*
+*******************************************************************************/
+void timebase_init(void)
+{
+    cyhal_lptimer_info_t info;
+
+    timebase_alarms = NULL;
+
+    cyhal_lptimer_init(&timebase_timer);
+    cyhal_lptimer_get_info(&timebase_timer, &info);
+    timebase_hz        = info.frequency_hz;
+    timebase_min_delay = (info.min_set_delay > 0u) ? info.min_set_delay : 1u;
+    cyhal_lptimer_register_callback(&timebase_timer, timebase_handler, NULL);
+    cyhal_lptimer_enable_event(&timebase_timer, CYHAL_LPTIMER_COMPARE_MATCH, CYHAL_ISR_PRIORITY_DEFAULT, true);
+}
+
+/*******************************************************************************
+* Function Name: timebase_now
+********************************************************************************
+* Summary:
+*  Get the current time. Differences of timestamps are valid across one
+*  counter wrap.
+*
+* Return:
+*  uint32_t: time in ticks
+*
+*******************************************************************************/
+uint32_t timebase_now(void)
+{
+    return cyhal_lptimer_read(&timebase_timer);
+}
+
+/*******************************************************************************
+* Function Name: timebase_ms_to_ticks
+********************************************************************************
+* Summary:
+*  Convert a time to ticks.
+*
+* Parameters:
+*  ms: time in ms
+*
+* Return:
+*  uint32_t: time in ticks
+*
+*******************************************************************************/
+uint32_t timebase_ms_to_ticks(uint32_t ms)
+{
+    return (uint32_t) (((uint64_t) ms * timebase_hz) / 1000u);
+}
+
+/*******************************************************************************
+* Function Name: timebase_ticks_to_us
+********************************************************************************
+* Summary:
+*  Convert a difference of timestamps to microseconds.
+*
+* Parameters:
+*  ticks: time in ticks
+*
+* Return:
+*  uint32_t: time in us
+*
+*******************************************************************************/
+uint32_t timebase_ticks_to_us(uint32_t ticks)
+{
+    return (uint32_t) (((uint64_t) ticks * 1000000u) / timebase_hz);
+}
+
+/*******************************************************************************
+* Function Name: timebase_set_alarm
+********************************************************************************
+* Summary:
+*  Call a handler from the timer ISR after a delay. Setting an armed alarm
+*  again replaces its delay and handler.
+*
+* Parameters:
+*  alarm: alarm object, kept by the caller
+*  delay: delay in ticks
+*  handler: function called when the delay expires
+*
+*******************************************************************************/
+void timebase_set_alarm(timebase_alarm_t *alarm, uint32_t delay, timebase_handler_t handler)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+    timebase_unlink(alarm);
+
+    alarm->deadline = timebase_now() + delay;
+    alarm->handler  = handler;
+    alarm->armed    = true;
+    alarm->next     = timebase_alarms;
+    timebase_alarms = alarm;
+
+    timebase_program();
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: timebase_cancel_alarm
+********************************************************************************
+* Summary:
+*  Disarm an alarm. Nothing happens if the alarm is not armed.
+*
+* Parameters:
+*  alarm: alarm object
+*
+*******************************************************************************/
+void timebase_cancel_alarm(timebase_alarm_t *alarm)
+{
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+    timebase_unlink(alarm);
+    timebase_program();
+
+    cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: timebase_handler
+********************************************************************************
+* Summary:
+*  Low-power timer interrupt. Calls the handlers of the expired alarms and
+*  programs the timer for the next one.
+*
+*******************************************************************************/
+static void timebase_handler(void *arg, cyhal_lptimer_event_t event)
+{
+    timebase_alarm_t *alarm;
+    timebase_handler_t handler;
+    uint32_t interrupt_state;
+    uint32_t now;
+
+    (void) arg;
+    (void) event;
+
+    do
+    {
+        interrupt_state = cyhal_system_critical_section_enter();
+
+        /* A handler may set alarms, so the list is scanned again after each */
+        now = timebase_now();
+        alarm = timebase_alarms;
+        while ((alarm != NULL) && ((int32_t) (alarm->deadline - now) > 0))
+        {
+            alarm = alarm->next;
+        }
+
+        handler = NULL;
+        if (alarm != NULL)
+        {
+            handler = alarm->handler;
+            timebase_unlink(alarm);
+        }
+        else
+        {
+            timebase_program();
+        }
+
+        cyhal_system_critical_section_exit(interrupt_state);
+
+        if (handler != NULL)
+        {
+            handler();
+        }
+    } while (handler != NULL);
+}
+
+/*******************************************************************************
+* Function Name: timebase_unlink
+********************************************************************************
+* Summary:
+*  Remove an alarm from the armed ones. Called in a critical section.
+*
+*******************************************************************************/
+static void timebase_unlink(timebase_alarm_t *alarm)
+{
+    timebase_alarm_t **link = &timebase_alarms;
+
+    if (!alarm->armed)
+    {
+        return;
+    }
+
+    while (*link != alarm)
+    {
+        link = &(*link)->next;
+    }
+    *link = alarm->next;
+    alarm->armed = false;
+}
+
+/*******************************************************************************
+* Function Name: timebase_program
+********************************************************************************
+* Summary:
+*  Program the timer for the earliest armed alarm. Called in a critical
+*  section.
+*
+*******************************************************************************/
+static void timebase_program(void)
+{
+    timebase_alarm_t *alarm;
+    uint32_t now = timebase_now();
+    int32_t earliest = INT32_MAX;
+    int32_t remaining;
+
+    if (timebase_alarms == NULL)
+    {
+        return;
+    }
+
+    for (alarm = timebase_alarms; alarm != NULL; alarm = alarm->next)
+    {
+        remaining = (int32_t) (alarm->deadline - now);
+        if (remaining < earliest)
+        {
+            earliest = remaining;
+        }
+    }
+
+    cyhal_lptimer_set_delay(&timebase_timer,
+                            (earliest > (int32_t) timebase_min_delay) ? (uint32_t) earliest : timebase_min_delay);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/*****************************************************************************
+* File Name: timebase.h
+*
+* Description: This file contains the definitions of the low-power timebase,
+*              which timestamps events and keeps running in Deep Sleep.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIMEBASE_H
+    #define TIMEBASE_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+    /* Called from the timer ISR when the alarm expires */
+    typedef void (*timebase_handler_t)(void);
+
+    /* Alarm, owned by the caller. The timer is programmed for the earliest
+    *  of the armed alarms */
+    typedef struct timebase_alarm
+    {
+        uint32_t deadline;              /* Timebase ticks */
+        timebase_handler_t handler;
+        bool armed;
+        struct timebase_alarm *next;    /* Next armed alarm */
+    } timebase_alarm_t;
+
+    void timebase_init(void);
+    uint32_t timebase_now(void);
+    uint32_t timebase_ms_to_ticks(uint32_t ms);
+    uint32_t timebase_ticks_to_us(uint32_t ticks);
+    void timebase_set_alarm(timebase_alarm_t *alarm, uint32_t delay, timebase_handler_t handler);
+    void timebase_cancel_alarm(timebase_alarm_t *alarm);
+
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+################################################################################
+# \file trace_decode.py
+# \version 1.0
+#
+# \brief
+# Decodes a dump of the binary event trace (trace_buffer, see trace.h) into a
+# timeline.
+#
+# Dump the buffer with the debugger, for example with GDB:
+#   dump binary memory trace.bin &trace_buffer (char *) &trace_buffer + sizeof(trace_buffer)
+#
+# Each record has two timestamps: CPU cycles and ticks of the low-power
+# timebase. The cycle counter stops while the CPU sleeps, the timebase does
+# not, so the time follows the timebase. Between records closer than a
+# timebase tick apart, the cycles are used instead, converted with the CPU
+# clock of the last TRACE_CPU_CLOCK record (or --cpu-hz before the first one),
+# as long as they agree with the timebase.
+#
+################################################################################
+# \copyright
+# Copyright 2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import struct
+import sys
+
+# trace_buffer_t header and trace_record_t layout (little endian)
+TRACE_MAGIC = 0x45435254
+TRACE_VERSION = 2
+HEADER = struct.Struct('<IHHII')
+RECORD = struct.Struct('<IIHHI')
+
+# Event IDs of trace.h: name and formatter of the two arguments
+BUTTON_EVENTS = ['press', 'release', 'long_press']
+GLITCH_TYPES = ['late_refill', 'tx_underflow', 'tx_overflow']
+EVENTS = {
+    1: ('PLAY_START', lambda a0, a1: 'voices=%d rate=%d' % (a0, a1)),
+    2: ('REFILL', lambda a0, a1: 'tx=%d block=%d' % (a0, a1)),
+    3: ('STOP', lambda a0, a1: 'blocks=%d' % a1),
+    4: ('GLITCH', lambda a0, a1: '%s block=%d' % (name_of(GLITCH_TYPES, a0), a1)),
+    5: ('BUTTON', lambda a0, a1: '%s edge=%d' % (name_of(BUTTON_EVENTS, a0), a1)),
+    6: ('CPU_CLOCK', lambda a0, a1: 'level=%d hz=%d' % (a0, a1)),
+    7: ('RATE_SWITCH', lambda a0, a1: 'rate=%d pll_failed=%d' % (a1, a0)),
+    8: ('CODEC_I2C', lambda a0, a1: 'reg=0x%02X mask=0x%02X value=0x%02X' % (a0, (a1 >> 8) & 0xFF, a1 & 0xFF)),
+    9: ('CODEC_POWER', lambda a0, a1: 'on' if a0 else 'off'),
+    10: ('CLIP_ENERGY', lambda a0, a1: 'load=%d.%d%% energy=%duJ' % (a0 // 10, a0 % 10, a1)),
+}
+CPU_CLOCK = 6
+
+
+def name_of(names, index):
+    return names[index] if index < len(names) else str(index)
+
+
+def read_records(data):
+    """Return the records of a dump, oldest first."""
+    if len(data) < HEADER.size:
+        raise ValueError('dump too short')
+    magic, version, record_size, size, write = HEADER.unpack_from(data)
+    if magic != TRACE_MAGIC:
+        raise ValueError('not a trace dump (magic 0x%08X)' % magic)
+    if version != TRACE_VERSION or record_size != RECORD.size:
+        raise ValueError('unsupported trace version %d, record size %d' % (version, record_size))
+    if len(data) < HEADER.size + size * record_size:
+        raise ValueError('dump truncated: %d records expected' % size)
+
+    count = min(write, size)
+    first = write - count
+    records = []
+    for n in range(first, write):
+        offset = HEADER.size + (n % size) * record_size
+        records.append(RECORD.unpack_from(data, offset))
+    return records, write - count
+
+
+def signed_delta(current, previous):
+    """Difference of two 32-bit counter values.
+
+    The counters wrap; records logged by a preempting ISR may also come out
+    slightly out of order, hence the signed result.
+    """
+    delta = (current - previous) & 0xFFFFFFFF
+    if delta >= 0x80000000:
+        delta -= 0x100000000
+    return delta
+
+
+def timeline(records, cpu_hz, timebase_hz):
+    """Yield (time in us, delta cycles, record) along the trace."""
+    tick_us = 1e6 / timebase_hz
+    time_us = 0.0
+    previous = None
+    for cycles, ticks, event, arg0, arg1 in records:
+        delta = 0
+        if previous is not None:
+            delta = signed_delta(cycles, previous[0])
+            step_us = signed_delta(ticks, previous[1]) * tick_us
+            # The cycles are finer, but missed the time the CPU slept
+            if cpu_hz and abs(delta * 1e6 / cpu_hz - step_us) <= tick_us:
+                step_us = delta * 1e6 / cpu_hz
+            time_us += step_us
+        previous = (cycles, ticks)
+        yield time_us, delta, (event, arg0, arg1)
+        if event == CPU_CLOCK and arg1:
+            cpu_hz = arg1
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a binary event trace dump into a timeline.')
+    parser.add_argument('dump', help='binary dump of trace_buffer')
+    parser.add_argument('--cpu-hz', type=int, default=0,
+                        help='CPU clock before the first CPU_CLOCK record (default: timebase only)')
+    parser.add_argument('--timebase-hz', type=int, default=32768,
+                        help='low-power timebase (LPTIMER) clock (default: %(default)d)')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        data = f.read()
+
+    try:
+        records, lost = read_records(data)
+    except ValueError as error:
+        sys.exit('%s: %s' % (args.dump, error))
+
+    if lost:
+        print('# %d older records were overwritten' % lost)
+    for time_us, delta, (event, arg0, arg1) in timeline(records, args.cpu_hz, args.timebase_hz):
+        name, describe = EVENTS.get(event, ('EVENT_%d' % event, lambda a0, a1: 'arg0=%d arg1=%d' % (a0, a1)))
+        print('%12.1f us %+11d  %-12s %s' % (time_us, delta, name, describe(arg0, arg1)))
+
+
+if __name__ == '__main__':
+    main()
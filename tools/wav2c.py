@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+################################################################################
+# \file wav2c.py
+# \version 1.0
+#
+# \brief
+# Converts a 16-bit PCM WAV file to the wave.c/wave.h sound track files.
+#
+# The integrated loudness (ITU-R BS.1770 K-weighting and gating) and the peak
+# of the clip are measured here, and the gain that brings the clip to the
+# target loudness is stored in the clip header. The playback gain stage applies
+# it together with the voice gain, so there is no analysis at run time.
+#
+################################################################################
+# \copyright
+# Copyright 2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import math
+import os
+import string
+import sys
+import wave
+
+# Loudness all the prompts are normalized to, in LUFS
+TARGET_LUFS = -16.0
+# Highest peak allowed after the gain, in dBFS
+PEAK_CEILING_DBFS = -1.0
+# Q14 gain format of audio_clip_t
+GAIN_FRAC_BITS = 14
+GAIN_MAX = 0xFFFF
+
+
+def biquad(samples, b, a):
+    """Direct form I biquad; a[0] is assumed to be 1."""
+    x1 = x2 = y1 = y2 = 0.0
+    out = []
+    for x in samples:
+        y = b[0] * x + b[1] * x1 + b[2] * x2 - a[1] * y1 - a[2] * y2
+        x2, x1 = x1, x
+        y2, y1 = y1, y
+        out.append(y)
+    return out
+
+
+def k_weighting(samples, rate):
+    """BS.1770 pre-filter (high shelf) followed by the RLB high-pass."""
+    # High shelf
+    f0, gain_db, q = 1681.974450955533, 3.999843853973347, 0.7071752369554196
+    k = math.tan(math.pi * f0 / rate)
+    vh = 10.0 ** (gain_db / 20.0)
+    vb = vh ** 0.4996667741545416
+    a0 = 1.0 + k / q + k * k
+    b = [(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0]
+    a = [1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0]
+    samples = biquad(samples, b, a)
+
+    # High-pass
+    f0, q = 38.13547087602444, 0.5003270373238773
+    k = math.tan(math.pi * f0 / rate)
+    a0 = 1.0 + k / q + k * k
+    a = [1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0]
+    return biquad(samples, [1.0, -2.0, 1.0], a)
+
+
+def integrated_loudness(samples, rate):
+    """Gated integrated loudness of a mono clip in LUFS (samples in [-1, 1))."""
+    weighted = k_weighting(samples, rate)
+    block = int(0.400 * rate)
+    step = block // 4
+    powers = []
+    for start in range(0, max(len(weighted) - block, 0) + 1, step):
+        chunk = weighted[start:start + block]
+        if chunk:
+            powers.append(sum(x * x for x in chunk) / len(chunk))
+
+    def lufs(power):
+        return -0.691 + 10.0 * math.log10(power) if power > 0.0 else -math.inf
+
+    # Absolute gate, then relative gate 10 LU below the ungated level
+    gated = [p for p in powers if lufs(p) > -70.0]
+    if not gated:
+        return -math.inf
+    relative = lufs(sum(gated) / len(gated)) - 10.0
+    gated = [p for p in gated if lufs(p) > relative]
+    return lufs(sum(gated) / len(gated))
+
+
+def normalization_gain(loudness, peak):
+    """Q14 gain that brings the clip to TARGET_LUFS without clipping."""
+    gain_db = TARGET_LUFS - loudness if math.isfinite(loudness) else 0.0
+    if peak > 0.0:
+        gain_db = min(gain_db, PEAK_CEILING_DBFS - 20.0 * math.log10(peak))
+    gain = round((10.0 ** (gain_db / 20.0)) * (1 << GAIN_FRAC_BITS))
+    return max(0, min(GAIN_MAX, gain))
+
+
+def analyze(samples, rate):
+    """Return (loudness LUFS, peak dBFS, Q14 gain) of 16-bit mono samples."""
+    scaled = [s / 32768.0 for s in samples]
+    peak = max((abs(s) for s in scaled), default=0.0)
+    loudness = integrated_loudness(scaled, rate)
+    peak_dbfs = 20.0 * math.log10(peak) if peak > 0.0 else -math.inf
+    return loudness, peak_dbfs, normalization_gain(loudness, peak)
+
+
+def read_wav(path):
+    with wave.open(path, 'rb') as wav:
+        if wav.getsampwidth() != 2:
+            sys.exit('%s: only 16-bit PCM is supported' % path)
+        channels = wav.getnchannels()
+        rate = wav.getframerate()
+        raw = wav.readframes(wav.getnframes())
+    samples = [int.from_bytes(raw[i:i + 2], 'little', signed=True) for i in range(0, len(raw), 2)]
+    return samples, channels, rate
+
+
+def write_sources(out_dir, name, samples, channels, rate, loudness, peak_dbfs, gain):
+    here = os.path.dirname(os.path.abspath(__file__))
+    with open(os.path.join(here, 'wave_template.c')) as f:
+        c_template = string.Template(f.read())
+    with open(os.path.join(here, 'wave_template.h')) as f:
+        h_template = string.Template(f.read())
+
+    lines = []
+    for i in range(0, len(samples), 8):
+        chunk = samples[i:i + 8]
+        lines.append('%s%s /* %d-%d */' % (', '.join('%3d' % s for s in chunk),
+                                          ',' if i + 8 < len(samples) else '};',
+                                          i, i + len(chunk) - 1))
+
+    fields = {
+        'name': name,
+        'size': len(samples),
+        'channels': channels,
+        'rate': rate,
+        'loudness': '%.1f' % loudness,
+        'peak': '%.1f' % peak_dbfs,
+        'target': '%.1f' % TARGET_LUFS,
+        'gain': gain,
+        'data': '\n'.join(lines),
+    }
+    # The sound track files use CRLF line endings
+    with open(os.path.join(out_dir, 'wave.c'), 'w', newline='\r\n') as f:
+        f.write(c_template.substitute(fields))
+    with open(os.path.join(out_dir, 'wave.h'), 'w', newline='\r\n') as f:
+        f.write(h_template.substitute(fields))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('wav', help='16-bit PCM WAV file')
+    parser.add_argument('-o', '--out-dir', default='.', help='directory for wave.c and wave.h')
+    args = parser.parse_args()
+
+    samples, channels, rate = read_wav(args.wav)
+    # Only the first channel is played
+    loudness, peak_dbfs, gain = analyze(samples[::channels], rate)
+    print('%s: %.1f LUFS, peak %.1f dBFS, gain %d (Q14)' % (args.wav, loudness, peak_dbfs, gain))
+    write_sources(args.out_dir, os.path.basename(args.wav), samples, channels, rate,
+                  loudness, peak_dbfs, gain)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+################################################################################
+# \file wavcmp.py
+# \version 1.0
+#
+# \brief
+# Compares two PCM WAV files sample by sample, such as an I2S capture of the
+# host simulator and its reference. Reports the format differences, the first
+# differing sample with the samples around it, the number of differing
+# samples and the largest difference.
+#
+# Exits with 0 if the files are bit-exact, 1 if they differ, 2 on an error.
+#
+################################################################################
+# \copyright
+# Copyright 2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import sys
+import wave
+
+
+def read_wav(path):
+    """Return the format (channels, sample width, rate) and the samples of a
+    WAV file, interleaved."""
+    with wave.open(path, 'rb') as wav:
+        channels = wav.getnchannels()
+        width = wav.getsampwidth()
+        rate = wav.getframerate()
+        raw = wav.readframes(wav.getnframes())
+    samples = [int.from_bytes(raw[i:i + width], 'little', signed=True)
+               for i in range(0, len(raw), width)]
+    return (channels, width, rate), samples
+
+
+def compare(expected_path, actual_path, context=4, out=sys.stdout):
+    """Compare two WAV files and print the differences. Return True if they
+    are bit-exact."""
+    (channels, width, rate), expected = read_wav(expected_path)
+    actual_format, actual = read_wav(actual_path)
+
+    if actual_format != (channels, width, rate):
+        print('format: expected %d ch, %d bits, %d Hz, got %d ch, %d bits, %d Hz'
+              % ((channels, width * 8, rate) + (actual_format[0], actual_format[1] * 8, actual_format[2])),
+              file=out)
+        return False
+
+    common = min(len(expected), len(actual))
+    first = next((i for i in range(common) if expected[i] != actual[i]), None)
+    if first is None and len(expected) == len(actual):
+        return True
+
+    if first is not None:
+        frame, channel = divmod(first, channels)
+        differing = sum(1 for i in range(first, common) if expected[i] != actual[i])
+        largest = max(abs(expected[i] - actual[i]) for i in range(first, common))
+        print('first difference at frame %d (%.6f s), channel %d: expected %d, got %d'
+              % (frame, frame / rate, channel, expected[first], actual[first]), file=out)
+        print('%d of %d samples differ, largest difference %d' % (differing, common, largest), file=out)
+
+        start = max(frame - context, 0)
+        end = min(frame + context + 1, common // channels)
+        print('%10s  %*s  %*s' % ('frame', 12 * channels, 'expected', 12 * channels, 'actual'), file=out)
+        for f in range(start, end):
+            row = slice(f * channels, (f + 1) * channels)
+            print('%10d  %s  %s%s' % (f, ''.join('%12d' % s for s in expected[row]),
+                                      ''.join('%12d' % s for s in actual[row]),
+                                      '  <' if expected[row] != actual[row] else ''), file=out)
+
+    if len(expected) != len(actual):
+        if first is None:
+            print('the first %d frames are identical' % (common // channels), file=out)
+        print('length: expected %d frames, got %d' % (len(expected) // channels, len(actual) // channels),
+              file=out)
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two PCM WAV files sample by sample.')
+    parser.add_argument('expected', help='reference WAV file')
+    parser.add_argument('actual', help='WAV file under test')
+    parser.add_argument('-c', '--context', type=int, default=4,
+                        help='frames shown around the first difference (default: 4)')
+    args = parser.parse_args()
+
+    try:
+        identical = compare(args.expected, args.actual, args.context)
+    except (OSError, EOFError, wave.Error) as error:
+        print('wavcmp: %s' % error, file=sys.stderr)
+        sys.exit(2)
+
+    if identical:
+        print('bit-exact')
+    sys.exit(0 if identical else 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,146 @@
+/*****************************************************************************
+* File Name: trace.h
+*
+* Description: This file contains the definitions of the binary event trace, a
+*              lock-free ring of compact records for post-mortem analysis.
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TRACE_H
+    #define TRACE_H
+
+    #include <stdint.h>
+
+    #include "cyhal.h"
+    #include "cycle_counter.h"
+    #include "timebase.h"
+
+    /* Set it from the Makefile with DEFINES+=TRACE_ENABLE=0 to compile the
+    *  trace out */
+    #ifndef TRACE_ENABLE
+        #define TRACE_ENABLE        1
+    #endif
+
+    /* Number of records in the ring, a power of 2 */
+    #define TRACE_SIZE              256u
+    /* Identifies a trace dump; the version changes with the record layout */
+    #define TRACE_MAGIC             0x45435254u     /* "TRCE" */
+    #define TRACE_VERSION           2u
+
+    /* Event IDs. Keep tools/trace_decode.py in sync. */
+    typedef enum
+    {
+        TRACE_PLAY_START    = 1,    /* arg0: voices, arg1: sample rate */
+        TRACE_REFILL        = 2,    /* arg0: TX block index, arg1: block number */
+        TRACE_STOP          = 3,    /* arg1: blocks played */
+        TRACE_GLITCH        = 4,    /* arg0: audio_glitch_type_t, arg1: block number */
+        TRACE_BUTTON        = 5,    /* arg0: button_event_type_t, arg1: timebase ticks */
+        TRACE_CPU_CLOCK     = 6,    /* arg0: governor level, arg1: CPU clock in Hz */
+        TRACE_RATE_SWITCH   = 7,    /* arg0: 1 if the PLL did not lock, arg1: sample rate set */
+        TRACE_CODEC_I2C     = 8,    /* arg0: register, arg1: mask << 8 | value */
+        TRACE_CODEC_POWER   = 9,    /* arg0: 1 on, 0 off */
+        TRACE_CLIP_ENERGY   = 10,   /* arg0: CPU load in permille, arg1: energy in uJ */
+    } trace_event_t;
+
+    /* One trace record. It is stamped twice: in CPU cycles, precise but
+    *  stopped in Sleep and Deep Sleep, with the CPU clock given by the last
+    *  TRACE_CPU_CLOCK record; and in ticks of the low-power timebase, which
+    *  keeps counting when the CPU sleeps. */
+    typedef struct
+    {
+        uint32_t cycles;
+        uint32_t ticks;
+        uint16_t id;
+        uint16_t arg0;
+        uint32_t arg1;
+    } trace_record_t;
+
+    /* The whole buffer is dumped as is; tools/trace_decode.py reads it */
+    typedef struct
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t record_size;
+        uint32_t size;
+        volatile uint32_t write;    /* Records logged, free running */
+        trace_record_t records[TRACE_SIZE];
+    } trace_buffer_t;
+
+    extern trace_buffer_t trace_buffer;
+
+    void trace_init(void);
+
+    /***************************************************************************
+    * Function Name: trace_log
+    ****************************************************************************
+    * Summary:
+    *  Append a record. Safe from any context: the slot is claimed with an
+    *  exclusive access and the oldest record is overwritten. The timebase
+    *  must be initialized.
+    *
+    * Parameters:
+    *  id: event ID
+    *  arg0: first argument
+    *  arg1: second argument
+    *
+    ***************************************************************************/
+    static inline void trace_log(trace_event_t id, uint32_t arg0, uint32_t arg1)
+    {
+    #if (TRACE_ENABLE != 0)
+        uint32_t cycles = cycle_counter_read();
+        uint32_t ticks = timebase_now();
+        trace_record_t *record;
+        uint32_t index;
+
+        do
+        {
+            index = __LDREXW(&trace_buffer.write);
+        } while (__STREXW(index + 1u, &trace_buffer.write) != 0u);
+
+        record = &trace_buffer.records[index & (TRACE_SIZE - 1u)];
+        record->cycles    = cycles;
+        record->ticks     = ticks;
+        record->id        = (uint16_t) id;
+        record->arg0      = (uint16_t) arg0;
+        record->arg1      = arg1;
+    #else
+        (void) id;
+        (void) arg0;
+        (void) arg1;
+    #endif
+    }
+
+#endif
+
+/* [] END OF FILE */
@@ -41,12 +41,17 @@
 
     #include <stdint.h>
 
+    #include "audio_clip.h"
+
     /* Number of elements in the wave sound track */
     #define WAVE_SIZE 59752u
 
     /* Extern reference to the wave sound track data */
     extern const int16_t wave_data[WAVE_SIZE];
 
+    /* Extern reference to the clip header of the wave sound track */
+    extern const audio_clip_t wave_clip;
+
 #endif
 
 /* [] END OF FILE */